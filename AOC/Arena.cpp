@@ -0,0 +1,94 @@
+#include "Arena.hpp"
+
+#include <algorithm>
+#include <format>
+#include <utility>
+
+namespace {
+
+thread_local Arena* currentArena{nullptr};
+
+std::string FormatBytes(uint64_t bytes) {
+    if (bytes >= (uint64_t{1} << 30)) return std::format("{:.2f}GiB", bytes / double(uint64_t{1} << 30));
+    if (bytes >= (uint64_t{1} << 20)) return std::format("{:.2f}MiB", bytes / double(uint64_t{1} << 20));
+    if (bytes >= (uint64_t{1} << 10)) return std::format("{:.2f}KiB", bytes / double(uint64_t{1} << 10));
+    return std::format("{}B", bytes);
+}
+
+} // namespace
+
+Arena::Scope::Scope(Arena& arena) noexcept : previous{std::exchange(currentArena, &arena)} {}
+
+Arena::Scope::~Scope() {
+    currentArena = previous;
+}
+
+Arena::Arena() : pool{std::pmr::new_delete_resource()} {}
+
+Arena::~Arena() = default;
+
+Arena& Arena::Current() noexcept {
+    if (currentArena) {
+        return *currentArena;
+    }
+    static Arena processArena;
+    return processArena;
+}
+
+void Arena::reset() {
+    pool.release();
+    bytesInUse.store(0, std::memory_order_relaxed);
+}
+
+Arena::Snapshot Arena::beginSection() noexcept {
+    const uint64_t inUse = bytesInUse.load(std::memory_order_relaxed);
+    return {
+        .allocations = allocations.load(std::memory_order_relaxed),
+        .bytes       = bytes.load(std::memory_order_relaxed),
+        .bytesInUse  = inUse,
+        .peakBytes   = peakBytes.exchange(inUse, std::memory_order_relaxed),
+    };
+}
+
+Arena::Snapshot Arena::endSection(const Snapshot& begin) noexcept {
+    const Snapshot end{
+        .allocations = allocations.load(std::memory_order_relaxed),
+        .bytes       = bytes.load(std::memory_order_relaxed),
+        .bytesInUse  = bytesInUse.load(std::memory_order_relaxed),
+        .peakBytes   = peakBytes.load(std::memory_order_relaxed),
+    };
+    raisePeak(begin.peakBytes);
+    return end;
+}
+
+std::string Arena::Describe(const Snapshot& begin, const Snapshot& end) {
+    if (end.allocations == begin.allocations) {
+        return {};
+    }
+    return std::format(" allocs={} allocated={} peak={}", end.allocations - begin.allocations,
+                       FormatBytes(end.bytes - begin.bytes),
+                       FormatBytes(end.peakBytes - std::min(end.peakBytes, begin.bytesInUse)));
+}
+
+void Arena::raisePeak(uint64_t candidate) noexcept {
+    uint64_t peak = peakBytes.load(std::memory_order_relaxed);
+    while (peak < candidate && !peakBytes.compare_exchange_weak(peak, candidate, std::memory_order_relaxed)) {
+    }
+}
+
+void* Arena::do_allocate(std::size_t size, std::size_t alignment) {
+    void* pointer = pool.allocate(size, alignment);
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    bytes.fetch_add(size, std::memory_order_relaxed);
+    raisePeak(bytesInUse.fetch_add(size, std::memory_order_relaxed) + size);
+    return pointer;
+}
+
+void Arena::do_deallocate(void* pointer, std::size_t size, std::size_t alignment) {
+    pool.deallocate(pointer, size, alignment);
+    bytesInUse.fetch_sub(size, std::memory_order_relaxed);
+}
+
+bool Arena::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/// Counting arena allocator
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+
+/// <summary>
+/// Pool memory resource that counts what goes through it. Each day runs inside its own arena and benchmark samples
+/// run inside one that is reset after every iteration, so memory is returned in bulk instead of per container.
+/// Days allocate from it through pmr containers built with &Arena::Current().
+/// Counters are atomic since pool workers allocate from the arena of the loop they run.
+/// </summary>
+class Arena final : public std::pmr::memory_resource {
+public:
+    struct Snapshot {
+        uint64_t allocations{};
+        uint64_t bytes{};
+        uint64_t bytesInUse{};
+        uint64_t peakBytes{};
+    };
+
+    /// Makes an arena the current one for the calling thread until the scope ends
+    class Scope {
+    public:
+        explicit Scope(Arena& arena) noexcept;
+        ~Scope();
+
+        Scope(const Scope&)            = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        Arena* previous;
+    };
+
+    Arena();
+    ~Arena() override;
+
+    Arena(const Arena&)            = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    /// Arena of the running day, a process wide one outside any Scope
+    static Arena& Current() noexcept;
+
+    /// Frees everything at once, memory still referenced by containers becomes invalid
+    void reset();
+
+    /// Counters now, then restarts the high-water mark from the bytes in use
+    Snapshot beginSection() noexcept;
+    /// Counters now with the high-water mark since begin, then folds the enclosing section's mark back in
+    Snapshot endSection(const Snapshot& begin) noexcept;
+
+    /// Allocations between two snapshots and the peak above the bytes in use at begin, empty if nothing was allocated
+    static std::string Describe(const Snapshot& begin, const Snapshot& end);
+
+private:
+    std::pmr::synchronized_pool_resource pool;
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<uint64_t> bytesInUse{0};
+    std::atomic<uint64_t> peakBytes{0};
+
+    void raisePeak(uint64_t candidate) noexcept;
+
+    void* do_allocate(std::size_t size, std::size_t alignment) override;
+    void do_deallocate(void* pointer, std::size_t size, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+};
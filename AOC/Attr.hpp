@@ -4,8 +4,11 @@
 #define attr_noinline gnu::noinline
 #define attr_forceinline gnu::always_inline
 #define attr_flatten gnu::flatten
+#define attr_target(isa) gnu::target(isa)
 #else
 #define attr_noinline msvc::noinline
 #define attr_forceinline msvc::forceinline
 #define attr_flatten
+// MSVC compiles any intrinsic without flags, dispatch alone keeps unsupported code from running
+#define attr_target(isa)
 #endif
\ No newline at end of file
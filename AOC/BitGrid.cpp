@@ -0,0 +1,202 @@
+#include "BitGrid.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+BitGrid::BitGrid(const dextents<int32_t, 2>& extents)
+    : bounds{extents}, rowWords{(extents.extent(1) + WORD_BITS - 1) / WORD_BITS},
+      lastWordMask{extents.extent(1) % WORD_BITS == 0 ? ~uint64_t{0}
+                                                       : (uint64_t{1} << (extents.extent(1) % WORD_BITS)) - 1},
+      words(static_cast<std::size_t>(extents.extent(0)) * static_cast<std::size_t>(rowWords)) {}
+
+void BitGrid::reshape(const dextents<int32_t, 2>& extents) {
+    if (bounds != extents) {
+        *this = BitGrid{extents};
+    }
+}
+
+void BitGrid::setRow(int32_t y, int32_t xBegin, int32_t xEnd) noexcept {
+    if (xBegin >= xEnd) {
+        return;
+    }
+    const std::span<uint64_t> bits = row(y);
+    const int32_t firstWord        = xBegin / WORD_BITS;
+    const int32_t lastWord         = (xEnd - 1) / WORD_BITS;
+    const uint64_t firstMask       = ~uint64_t{0} << (xBegin % WORD_BITS);
+    const uint64_t lastMask        = ~uint64_t{0} >> (WORD_BITS - 1 - (xEnd - 1) % WORD_BITS);
+    if (firstWord == lastWord) {
+        bits[firstWord] |= firstMask & lastMask;
+        return;
+    }
+    bits[firstWord] |= firstMask;
+    std::fill(bits.begin() + firstWord + 1, bits.begin() + lastWord, ~uint64_t{0});
+    bits[lastWord] |= lastMask;
+}
+
+void BitGrid::clear() noexcept {
+    std::ranges::fill(words, uint64_t{0});
+}
+
+std::size_t BitGrid::count() const noexcept {
+    return std::transform_reduce(words.begin(), words.end(), std::size_t{0}, std::plus{},
+                                 [](uint64_t bits) { return static_cast<std::size_t>(std::popcount(bits)); });
+}
+
+bool BitGrid::any() const noexcept {
+    return std::ranges::any_of(words, [](uint64_t bits) { return bits != 0; });
+}
+
+BitGrid& BitGrid::operator&=(const BitGrid& other) noexcept {
+    std::ranges::transform(words, other.words, words.begin(), std::bit_and{});
+    return *this;
+}
+
+BitGrid& BitGrid::operator|=(const BitGrid& other) noexcept {
+    std::ranges::transform(words, other.words, words.begin(), std::bit_or{});
+    return *this;
+}
+
+BitGrid& BitGrid::andNot(const BitGrid& other) noexcept {
+    std::ranges::transform(words, other.words, words.begin(), [](uint64_t lhs, uint64_t rhs) { return lhs & ~rhs; });
+    return *this;
+}
+
+BitGrid BitGrid::shiftedNorth() const {
+    BitGrid shifted{bounds};
+    shiftedNorth(shifted);
+    return shifted;
+}
+
+BitGrid BitGrid::shiftedSouth() const {
+    BitGrid shifted{bounds};
+    shiftedSouth(shifted);
+    return shifted;
+}
+
+BitGrid BitGrid::shiftedEast() const {
+    BitGrid shifted{bounds};
+    shiftedEast(shifted);
+    return shifted;
+}
+
+BitGrid BitGrid::shiftedWest() const {
+    BitGrid shifted{bounds};
+    shiftedWest(shifted);
+    return shifted;
+}
+
+void BitGrid::shiftedNorth(BitGrid& into) const {
+    into.reshape(bounds);
+    if (words.empty()) {
+        return;
+    }
+    // Forward, so in place each row is read before it is overwritten
+    std::copy(words.begin() + rowWords, words.end(), into.words.begin());
+    std::fill(into.words.end() - rowWords, into.words.end(), uint64_t{0});
+}
+
+void BitGrid::shiftedSouth(BitGrid& into) const {
+    into.reshape(bounds);
+    if (words.empty()) {
+        return;
+    }
+    std::copy_backward(words.begin(), words.end() - rowWords, into.words.end());
+    std::fill(into.words.begin(), into.words.begin() + rowWords, uint64_t{0});
+}
+
+void BitGrid::shiftedEast(BitGrid& into) const {
+    into.reshape(bounds);
+    if (rowWords == 0) {
+        return;
+    }
+    for (int32_t y{0}; y < extent(0); ++y) {
+        const std::span<const uint64_t> from = row(y);
+        const std::span<uint64_t> to         = into.row(y);
+        uint64_t carry{0};
+        for (int32_t w{0}; w < rowWords; ++w) {
+            const uint64_t bits = from[w];
+            to[w]               = (bits << 1) | carry;
+            carry               = bits >> (WORD_BITS - 1);
+        }
+        // The bit shifted out of the last column lands in the padding
+        to[rowWords - 1] &= lastWordMask;
+    }
+}
+
+void BitGrid::shiftedWest(BitGrid& into) const {
+    into.reshape(bounds);
+    for (int32_t y{0}; y < extent(0); ++y) {
+        const std::span<const uint64_t> from = row(y);
+        const std::span<uint64_t> to         = into.row(y);
+        uint64_t carry{0};
+        for (int32_t w{rowWords - 1}; w >= 0; --w) {
+            const uint64_t bits = from[w];
+            to[w]               = (bits >> 1) | carry;
+            carry               = bits << (WORD_BITS - 1);
+        }
+    }
+}
+
+BitGrid BitGrid::transposed() const {
+    BitGrid flipped{dextents<int32_t, 2>{extent(1), extent(0)}};
+    forEach([&flipped](int32_t y, int32_t x) { flipped.set(x, y); });
+    return flipped;
+}
+
+int32_t BitGrid::nextInRow(int32_t y, int32_t x) const noexcept {
+    if (x >= extent(1)) {
+        return extent(1);
+    }
+    x                                    = std::max(x, 0);
+    const std::span<const uint64_t> bits = row(y);
+    int32_t w                            = x / WORD_BITS;
+    uint64_t candidates                  = bits[w] & (~uint64_t{0} << (x % WORD_BITS));
+    while (candidates == 0) {
+        if (++w == rowWords) {
+            return extent(1);
+        }
+        candidates = bits[w];
+    }
+    return w * WORD_BITS + std::countr_zero(candidates);
+}
+
+int32_t BitGrid::prevInRow(int32_t y, int32_t x) const noexcept {
+    if (x < 0) {
+        return -1;
+    }
+    x                                    = std::min(x, extent(1) - 1);
+    const std::span<const uint64_t> bits = row(y);
+    int32_t w                            = x / WORD_BITS;
+    uint64_t candidates                  = bits[w] & (~uint64_t{0} >> (WORD_BITS - 1 - x % WORD_BITS));
+    while (candidates == 0) {
+        if (--w < 0) {
+            return -1;
+        }
+        candidates = bits[w];
+    }
+    return w * WORD_BITS + (WORD_BITS - 1 - std::countl_zero(candidates));
+}
+
+int32_t BitGrid::nextInColumn(int32_t y, int32_t x) const noexcept {
+    y                    = std::max(y, 0);
+    const uint64_t mask  = bit(x);
+    const uint64_t* cell = words.data() + static_cast<std::size_t>(x / WORD_BITS);
+    for (; y < extent(0); ++y) {
+        if (cell[static_cast<std::size_t>(y) * rowWords] & mask) {
+            return y;
+        }
+    }
+    return extent(0);
+}
+
+int32_t BitGrid::prevInColumn(int32_t y, int32_t x) const noexcept {
+    y                    = std::min(y, extent(0) - 1);
+    const uint64_t mask  = bit(x);
+    const uint64_t* cell = words.data() + static_cast<std::size_t>(x / WORD_BITS);
+    for (; y >= 0; --y) {
+        if (cell[static_cast<std::size_t>(y) * rowWords] & mask) {
+            return y;
+        }
+    }
+    return -1;
+}
@@ -0,0 +1,154 @@
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/// Bit-packed grid of flags
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "Attr.hpp"
+#include "HugePages.hpp"
+#include "Mdspan.hpp"
+
+/// <summary>
+/// One bit per cell, each row padded to whole 64 bit words so a row operation never straddles two rows.
+/// Padding bits past the last column are kept clear, which lets count() and the searches run on whole words.
+/// Shifts move every cell one step and drop what falls off the edge, so a frontier expands 64 cells per operation:
+/// next = (frontier.shiftedNorth() | frontier.shiftedSouth() | ...).andNot(walls).andNot(visited).
+/// Each shift also writes into a grid passed in, which keeps its words from one step to the next, so a flood fill
+/// loop allocates nothing: frontier.shiftedNorth(scratch); next |= scratch; ...
+/// </summary>
+class BitGrid {
+public:
+    static constexpr int32_t WORD_BITS = 64;
+
+    BitGrid() = default;
+    explicit BitGrid(const dextents<int32_t, 2>& extents);
+
+    /// Bit set for every input cell the predicate accepts
+    template <class Predicate>
+    static BitGrid FromInput(const InputGrid<const char>& input, Predicate predicate) {
+        BitGrid grid{input.extents()};
+        for (int32_t y{0}; y < input.extent(0); ++y) {
+            for (int32_t x{0}; x < input.extent(1); ++x) {
+                if (predicate(input(y, x))) {
+                    grid.set(y, x);
+                }
+            }
+        }
+        return grid;
+    }
+
+    [[nodiscard]] const dextents<int32_t, 2>& extents() const noexcept { return bounds; }
+    [[nodiscard]] int32_t extent(std::size_t r) const noexcept { return bounds.extent(r); }
+    [[nodiscard]] int32_t wordsPerRow() const noexcept { return rowWords; }
+
+    [[nodiscard, attr_forceinline]] bool test(int32_t y, int32_t x) const noexcept {
+        return (word(y, x) >> (x % WORD_BITS)) & 1;
+    }
+    [[attr_forceinline]] void set(int32_t y, int32_t x) noexcept { word(y, x) |= bit(x); }
+    [[attr_forceinline]] void reset(int32_t y, int32_t x) noexcept { word(y, x) &= ~bit(x); }
+    /// Sets the bit and returns whether it was set before
+    [[attr_forceinline]] bool testAndSet(int32_t y, int32_t x) noexcept {
+        uint64_t& w       = word(y, x);
+        const bool wasSet = w & bit(x);
+        w |= bit(x);
+        return wasSet;
+    }
+
+    [[nodiscard, attr_forceinline]] bool test(const Pos2D& pos) const noexcept { return test(pos.y(), pos.x()); }
+    [[attr_forceinline]] void set(const Pos2D& pos) noexcept { set(pos.y(), pos.x()); }
+    [[attr_forceinline]] void reset(const Pos2D& pos) noexcept { reset(pos.y(), pos.x()); }
+    [[attr_forceinline]] bool testAndSet(const Pos2D& pos) noexcept { return testAndSet(pos.y(), pos.x()); }
+
+    /// Sets columns [xBegin, xEnd) of row y, a word at a time
+    void setRow(int32_t y, int32_t xBegin, int32_t xEnd) noexcept;
+    void clear() noexcept;
+    [[nodiscard]] std::size_t count() const noexcept;
+    [[nodiscard]] bool any() const noexcept;
+
+    BitGrid& operator&=(const BitGrid& other) noexcept;
+    BitGrid& operator|=(const BitGrid& other) noexcept;
+    /// Clears every bit set in other
+    BitGrid& andNot(const BitGrid& other) noexcept;
+
+    /// Cell (y, x) takes the value of (y + 1, x)
+    [[nodiscard]] BitGrid shiftedNorth() const;
+    /// Cell (y, x) takes the value of (y - 1, x)
+    [[nodiscard]] BitGrid shiftedSouth() const;
+    /// Cell (y, x) takes the value of (y, x - 1)
+    [[nodiscard]] BitGrid shiftedEast() const;
+    /// Cell (y, x) takes the value of (y, x + 1)
+    [[nodiscard]] BitGrid shiftedWest() const;
+
+    /// <summary>
+    /// The shifts above written into into, which only allocates when its extents differ from this grid's.
+    /// into may be this grid, which shifts it in place.
+    /// </summary>
+    void shiftedNorth(BitGrid& into) const;
+    void shiftedSouth(BitGrid& into) const;
+    void shiftedEast(BitGrid& into) const;
+    void shiftedWest(BitGrid& into) const;
+
+    /// Grid with rows and columns swapped, so column searches become row searches on the copy
+    [[nodiscard]] BitGrid transposed() const;
+
+    /// First set column >= x in row y, extent(1) if there is none
+    [[nodiscard]] int32_t nextInRow(int32_t y, int32_t x) const noexcept;
+    /// Last set column <= x in row y, -1 if there is none
+    [[nodiscard]] int32_t prevInRow(int32_t y, int32_t x) const noexcept;
+    /// <summary>
+    /// First set row >= y in column x, extent(0) if there is none. Rows are packed, so this reads one word per row
+    /// rather than 64 rows per word. Repeated column searches are faster as nextInRow(x, y) on a transposed() copy
+    /// kept next to the grid, as guard_gallivant's Walls do.
+    /// </summary>
+    [[nodiscard]] int32_t nextInColumn(int32_t y, int32_t x) const noexcept;
+    /// Last set row <= y in column x, -1 if there is none. One word per row as well, see nextInColumn()
+    [[nodiscard]] int32_t prevInColumn(int32_t y, int32_t x) const noexcept;
+
+    /// Words of row y, the last one holds padding past extent(1)
+    [[nodiscard]] std::span<uint64_t> row(int32_t y) noexcept {
+        return {words.data() + static_cast<std::size_t>(y) * rowWords, static_cast<std::size_t>(rowWords)};
+    }
+    [[nodiscard]] std::span<const uint64_t> row(int32_t y) const noexcept {
+        return {words.data() + static_cast<std::size_t>(y) * rowWords, static_cast<std::size_t>(rowWords)};
+    }
+
+    /// Calls visit(y, x) for every set cell, in row-major order
+    template <class Visit>
+    void forEach(Visit&& visit) const {
+        for (int32_t y{0}; y < extent(0); ++y) {
+            const std::span<const uint64_t> rowBits = row(y);
+            for (int32_t w{0}; w < wordsPerRow(); ++w) {
+                for (uint64_t bits = rowBits[w]; bits != 0; bits &= bits - 1) {
+                    visit(y, w * WORD_BITS + std::countr_zero(bits));
+                }
+            }
+        }
+    }
+
+    friend bool operator==(const BitGrid& lhs, const BitGrid& rhs) noexcept = default;
+
+private:
+    dextents<int32_t, 2> bounds{};
+    int32_t rowWords{0};
+    /// Valid bits of the last word in every row
+    uint64_t lastWordMask{0};
+    /// Huge pages once a grid reaches 2 MiB, guard_gallivant jumps to random rows of several at once
+    HugePageVector<uint64_t> words;
+
+    /// Gives the grid extents, reallocating only when they change, the bits are left as they were
+    void reshape(const dextents<int32_t, 2>& extents);
+
+    [[nodiscard, attr_forceinline]] static uint64_t bit(int32_t x) noexcept { return uint64_t{1} << (x % WORD_BITS); }
+    [[nodiscard, attr_forceinline]] uint64_t& word(int32_t y, int32_t x) noexcept {
+        return words[static_cast<std::size_t>(y) * rowWords + static_cast<std::size_t>(x / WORD_BITS)];
+    }
+    [[nodiscard, attr_forceinline]] const uint64_t& word(int32_t y, int32_t x) const noexcept {
+        return words[static_cast<std::size_t>(y) * rowWords + static_cast<std::size_t>(x / WORD_BITS)];
+    }
+};
@@ -0,0 +1,236 @@
+// Checks every BitGrid shift, bitwise operation and search against a std::vector<bool> reference, at widths on either
+// side of the 64 bit word boundary where padding and carries between words go wrong.
+
+#include <algorithm>
+#include <cstdint>
+#include <format>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "BitGrid.hpp"
+
+namespace {
+
+int failures{0};
+
+void Check(bool condition, std::string_view what) {
+    if (!condition) {
+        ++failures;
+        std::cerr << "Failed: " << what << '\n';
+    }
+}
+
+std::mt19937_64 rng{2024};
+
+/// One bool per cell, row-major, the obvious version every BitGrid operation is compared with
+struct Reference {
+    int32_t height;
+    int32_t width;
+    std::vector<bool> cells;
+
+    Reference(int32_t h, int32_t w) : height{h}, width{w}, cells(static_cast<std::size_t>(h * w)) {}
+
+    [[nodiscard]] bool inBounds(int32_t y, int32_t x) const { return y >= 0 && y < height && x >= 0 && x < width; }
+    [[nodiscard]] bool operator()(int32_t y, int32_t x) const { return inBounds(y, x) && cells[y * width + x]; }
+    void set(int32_t y, int32_t x, bool value) { cells[y * width + x] = value; }
+
+    /// Cell (y, x) takes the value of (y + dy, x + dx), cleared where that is off the grid
+    [[nodiscard]] Reference shifted(int32_t dy, int32_t dx) const {
+        Reference result{height, width};
+        for (int32_t y{0}; y < height; ++y) {
+            for (int32_t x{0}; x < width; ++x) {
+                result.set(y, x, (*this)(y + dy, x + dx));
+            }
+        }
+        return result;
+    }
+};
+
+/// Random cells at the given density, set into both the grid and its reference
+void Fill(BitGrid& grid, Reference& reference, double density) {
+    std::bernoulli_distribution isSet{density};
+    for (int32_t y{0}; y < reference.height; ++y) {
+        for (int32_t x{0}; x < reference.width; ++x) {
+            const bool value = isSet(rng);
+            reference.set(y, x, value);
+            if (value) {
+                grid.set(y, x);
+            }
+        }
+    }
+}
+
+/// Same extents and cells, and count() agrees, which it can't with a stray padding bit
+bool Same(const BitGrid& grid, const Reference& reference) {
+    if (grid.extent(0) != reference.height || grid.extent(1) != reference.width) {
+        return false;
+    }
+    std::size_t setCells{0};
+    for (int32_t y{0}; y < reference.height; ++y) {
+        for (int32_t x{0}; x < reference.width; ++x) {
+            if (grid.test(y, x) != reference(y, x)) {
+                return false;
+            }
+            setCells += reference(y, x);
+        }
+    }
+    return grid.count() == setCells && grid.any() == (setCells != 0);
+}
+
+void CheckShifts(int32_t height, int32_t width, double density) {
+    BitGrid grid{dextents<int32_t, 2>{height, width}};
+    Reference reference{height, width};
+    Fill(grid, reference, density);
+    const std::string where = std::format("{}x{} grid at density {}", height, width, density);
+
+    struct Shift {
+        std::string_view name;
+        BitGrid (BitGrid::*shifted)() const;
+        void (BitGrid::*shiftedInto)(BitGrid&) const;
+        int32_t dy;
+        int32_t dx;
+    };
+    for (const Shift& shift : {Shift{"North", &BitGrid::shiftedNorth, &BitGrid::shiftedNorth, 1, 0},
+                               Shift{"South", &BitGrid::shiftedSouth, &BitGrid::shiftedSouth, -1, 0},
+                               Shift{"East", &BitGrid::shiftedEast, &BitGrid::shiftedEast, 0, -1},
+                               Shift{"West", &BitGrid::shiftedWest, &BitGrid::shiftedWest, 0, 1}}) {
+        const Reference expected = reference.shifted(shift.dy, shift.dx);
+        Check(Same((grid.*shift.shifted)(), expected), std::format("shifted{}() of the {}", shift.name, where));
+
+        // A default grid has to take the extents, one of the same extents full of stale bits has to lose them all
+        BitGrid empty;
+        (grid.*shift.shiftedInto)(empty);
+        Check(Same(empty, expected), std::format("shifted{} into an empty grid from the {}", shift.name, where));
+        BitGrid stale{grid.extents()};
+        Reference unused{height, width};
+        Fill(stale, unused, 0.5);
+        (grid.*shift.shiftedInto)(stale);
+        Check(Same(stale, expected), std::format("shifted{} into a used grid from the {}", shift.name, where));
+
+        BitGrid inPlace = grid;
+        (inPlace.*shift.shiftedInto)(inPlace);
+        Check(Same(inPlace, expected), std::format("shifted{} in place on the {}", shift.name, where));
+        Check(Same(grid, reference), std::format("shifted{} left the source {} alone", shift.name, where));
+    }
+}
+
+void CheckBitwise(int32_t height, int32_t width, double density) {
+    BitGrid lhs{dextents<int32_t, 2>{height, width}};
+    BitGrid rhs{dextents<int32_t, 2>{height, width}};
+    Reference lhsCells{height, width};
+    Reference rhsCells{height, width};
+    Fill(lhs, lhsCells, density);
+    Fill(rhs, rhsCells, 0.5);
+    const std::string where = std::format("{}x{} grids at density {}", height, width, density);
+
+    Reference andCells{height, width};
+    Reference orCells{height, width};
+    Reference andNotCells{height, width};
+    for (int32_t y{0}; y < height; ++y) {
+        for (int32_t x{0}; x < width; ++x) {
+            andCells.set(y, x, lhsCells(y, x) && rhsCells(y, x));
+            orCells.set(y, x, lhsCells(y, x) || rhsCells(y, x));
+            andNotCells.set(y, x, lhsCells(y, x) && !rhsCells(y, x));
+        }
+    }
+    BitGrid result = lhs;
+    Check(Same(result &= rhs, andCells), "&= of the " + where);
+    result = lhs;
+    Check(Same(result |= rhs, orCells), "|= of the " + where);
+    result = lhs;
+    Check(Same(result.andNot(rhs), andNotCells), "andNot of the " + where);
+    result = lhs;
+    Check(!result.andNot(lhs).any(), "andNot of the " + where + " with itself");
+}
+
+void CheckSetRow(int32_t height, int32_t width) {
+    BitGrid grid{dextents<int32_t, 2>{height, width}};
+    Reference reference{height, width};
+    for (int i{0}; i < 20; ++i) {
+        const auto y      = static_cast<int32_t>(rng() % height);
+        const auto xBegin = static_cast<int32_t>(rng() % (width + 1));
+        const auto xEnd   = static_cast<int32_t>(rng() % (width + 1));
+        grid.setRow(y, xBegin, xEnd);
+        for (int32_t x{xBegin}; x < xEnd; ++x) {
+            reference.set(y, x, true);
+        }
+        Check(Same(grid, reference), std::format("setRow({}, {}, {}) on a {}x{} grid", y, xBegin, xEnd, height, width));
+    }
+    grid.setRow(0, 0, width);
+    for (int32_t x{0}; x < width; ++x) {
+        reference.set(0, x, true);
+    }
+    Check(Same(grid, reference), std::format("setRow over the whole first row of a {}x{} grid", height, width));
+    grid.clear();
+    Check(Same(grid, Reference{height, width}), std::format("clear of a {}x{} grid", height, width));
+}
+
+void CheckSearches(int32_t height, int32_t width, double density) {
+    BitGrid grid{dextents<int32_t, 2>{height, width}};
+    Reference reference{height, width};
+    Fill(grid, reference, density);
+    const std::string where = std::format("{}x{} grid at density {}", height, width, density);
+
+    // Starting one step outside the grid on either side as well, which the searches clamp
+    for (int32_t y{0}; y < height; ++y) {
+        for (int32_t x{-1}; x <= width; ++x) {
+            int32_t next = std::max(x, 0);
+            while (next < width && !reference(y, next)) {
+                ++next;
+            }
+            int32_t prev = std::min(x, width - 1);
+            while (prev >= 0 && !reference(y, prev)) {
+                --prev;
+            }
+            Check(grid.nextInRow(y, x) == next, std::format("nextInRow({}, {}) on the {}", y, x, where));
+            Check(grid.prevInRow(y, x) == prev, std::format("prevInRow({}, {}) on the {}", y, x, where));
+        }
+    }
+    for (int32_t x{0}; x < width; ++x) {
+        for (int32_t y{-1}; y <= height; ++y) {
+            int32_t next = std::max(y, 0);
+            while (next < height && !reference(next, x)) {
+                ++next;
+            }
+            int32_t prev = std::min(y, height - 1);
+            while (prev >= 0 && !reference(prev, x)) {
+                --prev;
+            }
+            Check(grid.nextInColumn(y, x) == next, std::format("nextInColumn({}, {}) on the {}", y, x, where));
+            Check(grid.prevInColumn(y, x) == prev, std::format("prevInColumn({}, {}) on the {}", y, x, where));
+        }
+    }
+
+    const BitGrid flipped = grid.transposed();
+    Reference flippedCells{width, height};
+    for (int32_t y{0}; y < height; ++y) {
+        for (int32_t x{0}; x < width; ++x) {
+            flippedCells.set(x, y, reference(y, x));
+        }
+    }
+    Check(Same(flipped, flippedCells), "transposed() of the " + where);
+}
+
+} // namespace
+
+int main() {
+    for (const int32_t width : {1, 63, 64, 65, 130}) {
+        for (const int32_t height : {1, 2, 7}) {
+            // Sparse grids make the searches cross words, dense ones fill every carry and the padding next to it
+            for (const double density : {0.02, 0.5, 1.0}) {
+                CheckShifts(height, width, density);
+                CheckBitwise(height, width, density);
+                CheckSearches(height, width, density);
+            }
+            CheckSetRow(height, width);
+        }
+    }
+    if (failures != 0) {
+        std::cerr << failures << " checks failed\n";
+        return 1;
+    }
+    return 0;
+}
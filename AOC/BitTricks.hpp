@@ -0,0 +1,117 @@
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/// Bit permutations with a portable version and a dispatched one
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <immintrin.h>
+
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <type_traits>
+
+#include "Attr.hpp"
+#include "CpuFeatures.hpp"
+
+template <std::unsigned_integral U>
+constexpr U BitreversePortable(U x) noexcept {
+    x = std::byteswap(x);
+
+    const auto Extract = [x](int i) -> U {
+        const U mask{static_cast<U>(0x0101010101010101ULL) << i};
+        return x & mask;
+    };
+
+    // Eliminating dependencies allows clang to vectorize this for std::uint32_t and u16
+    U x0{Extract(0) << 7};
+    U x1{Extract(1) << 5};
+    U x2{Extract(2) << 3};
+    U x3{Extract(3) << 1};
+
+    U x4{Extract(4) >> 1};
+    U x5{Extract(5) >> 3};
+    U x6{Extract(6) >> 5};
+    U x7{Extract(7) >> 7};
+
+    x0 |= x4;
+    x1 |= x5;
+    x2 |= x6;
+    x3 |= x7;
+
+    x0 |= x2;
+    x1 |= x3;
+
+    x = x0 | x1;
+
+    return x;
+}
+
+[[attr_target("avx2")]] inline std::uint32_t BitreverseAvx2(std::uint32_t x) noexcept {
+    x              = std::byteswap(x);
+    __m128i x_32x4 = _mm_set1_epi32(x);
+    const __m128i slMask_32x4 =
+        _mm_set_epi32(0x01010101ULL << 0, 0x01010101ULL << 1, 0x01010101ULL << 2, 0x01010101ULL << 3);
+    const __m128i srMask_32x4 =
+        _mm_set_epi32(0x01010101ULL << 7, 0x01010101ULL << 6, 0x01010101ULL << 5, 0x01010101ULL << 4);
+    const __m128i shift_32x4   = _mm_set_epi32(7, 5, 3, 1);
+    const __m128i xl_32x4      = _mm_sllv_epi32(_mm_and_si128(x_32x4, slMask_32x4), shift_32x4);
+    const __m128i xr_32x4      = _mm_srlv_epi32(_mm_and_si128(x_32x4, srMask_32x4), shift_32x4);
+    x_32x4                     = _mm_or_si128(xl_32x4, xr_32x4);
+    const std::uint64_t x_32x2 = _mm_extract_epi64(x_32x4, 0) | _mm_extract_epi64(x_32x4, 1);
+    return static_cast<std::uint32_t>(x_32x2) | static_cast<std::uint32_t>(x_32x2 >> 32);
+}
+
+[[attr_target("avx2")]] inline std::uint64_t BitreverseAvx2(std::uint64_t x) noexcept {
+    x                         = std::byteswap(x);
+    __m256i x_64x4            = _mm256_set1_epi64x(x);
+    const __m256i slMask_64x4 = _mm256_set_epi64x(0x0101010101010101ULL << 0, 0x0101010101010101ULL << 1,
+                                                  0x0101010101010101ULL << 2, 0x0101010101010101ULL << 3);
+    const __m256i srMask_64x4 = _mm256_set_epi64x(0x0101010101010101ULL << 7, 0x0101010101010101ULL << 6,
+                                                  0x0101010101010101ULL << 5, 0x0101010101010101ULL << 4);
+    const __m256i shift_64x4  = _mm256_set_epi64x(7, 5, 3, 1);
+    const __m256i xl_64x4     = _mm256_sllv_epi64(_mm256_and_si256(x_64x4, slMask_64x4), shift_64x4);
+    const __m256i xr_64x4     = _mm256_srlv_epi64(_mm256_and_si256(x_64x4, srMask_64x4), shift_64x4);
+    x_64x4                    = _mm256_or_si256(xl_64x4, xr_64x4);
+    __m128i x_64x2 = _mm_or_si128(_mm256_extracti128_si256(x_64x4, 0), _mm256_extracti128_si256(x_64x4, 1));
+    return _mm_extract_epi64(x_64x2, 0) | _mm_extract_epi64(x_64x2, 1);
+}
+
+/// <summary>
+/// Bits of x in reverse order, with the instructions of Isa. Isa is a template parameter rather than read from
+/// CpuFeatures on each call, pick it once with WithActiveIsa around the loop calling this.
+/// </summary>
+template <IsaLevel Isa = IsaLevel::SCALAR, std::unsigned_integral U>
+[[attr_flatten]] constexpr U Bitreverse(U x) noexcept {
+    if constexpr (Isa >= IsaLevel::AVX2 && (sizeof(U) == 4 || sizeof(U) == 8)) {
+        if (!std::is_constant_evaluated()) {
+            return BitreverseAvx2(x);
+        }
+    }
+    return BitreversePortable<U>(x);
+}
+
+/// Scatters the low bits of src to the set bits of mask, lowest first
+constexpr std::uint64_t PdepPortable(std::uint64_t src, std::uint64_t mask) noexcept {
+    std::uint64_t result{0};
+    for (; mask != 0; mask &= mask - 1, src >>= 1) {
+        if (src & 1) {
+            result |= mask & (~mask + 1);
+        }
+    }
+    return result;
+}
+
+[[attr_target("bmi2")]] inline std::uint64_t PdepBmi2(std::uint64_t src, std::uint64_t mask) noexcept {
+    return _pdep_u64(src, mask);
+}
+
+/// PdepBmi2 from AVX2 up, which includes BMI2, chosen at compile time like Bitreverse
+template <IsaLevel Isa = IsaLevel::SCALAR>
+[[gnu::always_inline]] inline std::uint64_t pdep(std::uint64_t src, std::uint64_t mask) {
+    if constexpr (Isa >= IsaLevel::AVX2) {
+        return PdepBmi2(src, mask);
+    } else {
+        return PdepPortable(src, mask);
+    }
+}
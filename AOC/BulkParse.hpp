@@ -0,0 +1,172 @@
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/// Bulk integer parsing
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <immintrin.h>
+
+#include <array>
+#include <bit>
+#include <charconv>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "Attr.hpp"
+#include "CpuFeatures.hpp"
+
+namespace BulkParseDetail {
+
+constexpr std::size_t BLOCK_SIZE = 32;
+
+[[noreturn, attr_noinline]] inline void ThrowParseError(const std::errc errc) {
+    throw std::system_error{std::make_error_code(errc)};
+}
+
+[[attr_target("avx2")]] inline uint32_t DigitMaskAvx2(const char* block) {
+    const __m256i chars     = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+    const __m256i aboveZero = _mm256_cmpgt_epi8(chars, _mm256_set1_epi8('0' - 1));
+    const __m256i belowTen  = _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), chars);
+    return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(aboveZero, belowTen)));
+}
+
+/// <summary>
+/// Bit i is set when block[i] is an ASCII digit. DigitMaskAvx2 isn't forceinline, GCC refuses that across target
+/// attributes, but it still inlines once ScanNumbers<AVX2> is inlined into ForEachNumberAvx2.
+/// </summary>
+template <IsaLevel Isa>
+[[attr_forceinline]] inline uint32_t DigitMask(const char* block) {
+    if constexpr (Isa >= IsaLevel::AVX2) {
+        return DigitMaskAvx2(block);
+    } else {
+        uint32_t mask{0};
+        for (std::size_t i{0}; i < BLOCK_SIZE; ++i) {
+            mask |= static_cast<uint32_t>(static_cast<unsigned char>(block[i] - '0') < 10) << i;
+        }
+        return mask;
+    }
+}
+
+/// Value of a run of 1 to 8 digits, 8 bytes must be readable from digits onward
+[[attr_forceinline]] inline uint32_t ParseEightDigits(const char* digits, std::size_t length) {
+    uint64_t chunk;
+    std::memcpy(&chunk, digits, sizeof(chunk));
+    // Digits move to the top bytes, the vacated low bytes act as leading zeros
+    chunk = (chunk << (8 * (8 - length))) & 0x0F0F0F0F0F0F0F0F;
+    chunk = (chunk * 10 + (chunk >> 8)) & 0x00FF00FF00FF00FF;
+    chunk = (chunk * 100 + (chunk >> 16)) & 0x0000FFFF0000FFFF;
+    return static_cast<uint32_t>(chunk * 10000 + (chunk >> 32));
+}
+
+template <std::integral T>
+T ToNumber(std::string_view input, std::size_t begin, std::size_t end) {
+    const bool negative = begin != 0 && input[begin - 1] == '-';
+    if constexpr (std::unsigned_integral<T>) {
+        if (negative) ThrowParseError(std::errc::invalid_argument);
+    }
+    if (end - begin <= 8 && begin + 8 <= input.size()) [[likely]] {
+        const int64_t magnitude = ParseEightDigits(input.data() + begin, end - begin);
+        const int64_t value     = negative ? -magnitude : magnitude;
+        if (!std::in_range<T>(value)) ThrowParseError(std::errc::result_out_of_range);
+        return static_cast<T>(value);
+    }
+    T value{};
+    const auto [ptr, errc] = std::from_chars(input.data() + begin - negative, input.data() + end, value);
+    if (errc != std::errc{}) ThrowParseError(errc);
+    return value;
+}
+
+/// Calls sink with each number in input, classifying blocks with the instructions of Isa
+template <IsaLevel Isa, std::integral T, typename Sink>
+[[attr_forceinline]] inline void ScanNumbers(std::string_view input, Sink&& sink) {
+    std::size_t runStart{0};
+    uint32_t carry{0}; // 1 when a run of digits continues from the previous block
+    for (std::size_t base{0}; base < input.size(); base += BLOCK_SIZE) {
+        uint32_t digits;
+        if (base + BLOCK_SIZE <= input.size()) [[likely]] {
+            digits = DigitMask<Isa>(input.data() + base);
+        } else {
+            std::array<char, BLOCK_SIZE> tail{};
+            std::memcpy(tail.data(), input.data() + base, input.size() - base);
+            digits = DigitMask<Isa>(tail.data());
+        }
+        // Set wherever a run of digits starts or ends
+        uint32_t transitions = digits ^ ((digits << 1) | carry);
+        while (transitions != 0) {
+            const auto offset = static_cast<std::size_t>(std::countr_zero(transitions));
+            transitions &= transitions - 1;
+            if ((digits >> offset) & 1) {
+                runStart = base + offset;
+            } else {
+                sink(ToNumber<T>(input, runStart, base + offset));
+            }
+        }
+        carry = digits >> (BLOCK_SIZE - 1);
+    }
+    if (carry) {
+        sink(ToNumber<T>(input, runStart, input.size()));
+    }
+}
+
+template <std::integral T, typename Sink>
+[[attr_target("avx2")]] void ForEachNumberAvx2(std::string_view input, Sink&& sink) {
+    ScanNumbers<IsaLevel::AVX2, T>(input, sink);
+}
+
+template <std::integral T, typename Sink>
+void ForEachNumberScalar(std::string_view input, Sink&& sink) {
+    ScanNumbers<IsaLevel::SCALAR, T>(input, sink);
+}
+
+/// Picks the widest block classifier the active instruction set allows, once per input
+template <std::integral T, typename Sink>
+void ForEachNumber(std::string_view input, Sink&& sink) {
+    if (CpuFeatures::Active() >= IsaLevel::AVX2) {
+        ForEachNumberAvx2<T>(input, sink);
+    } else {
+        ForEachNumberScalar<T>(input, sink);
+    }
+}
+
+} // namespace BulkParseDetail
+
+/// <summary>
+/// Parses every run of digits in the input, classifying 32 bytes at a time. Anything that isn't a digit separates
+/// numbers. A '-' directly before a run negates it, and is an error for unsigned T like in ParseNumber. '+' is
+/// skipped. Runs of up to 8 digits are converted without a per character loop.
+/// </summary>
+template <std::integral T>
+struct BulkNumberParser {
+    /// Appends the numbers to numbers
+    void operator()(std::string_view input, std::vector<T>& numbers) const {
+        BulkParseDetail::ForEachNumber<T>(input, [&numbers](T number) { numbers.push_back(number); });
+    }
+
+    /// Fills numbers from the front and returns how many were parsed, throws if they don't all fit
+    std::size_t operator()(std::string_view input, std::span<T> numbers) const {
+        std::size_t count{0};
+        BulkParseDetail::ForEachNumber<T>(input, [&numbers, &count](T number) {
+            if (count == numbers.size()) BulkParseDetail::ThrowParseError(std::errc::value_too_large);
+            numbers[count++] = number;
+        });
+        return count;
+    }
+
+    std::vector<T> operator()(std::string_view input) const {
+        std::vector<T> numbers;
+        (*this)(input, numbers);
+        return numbers;
+    }
+
+    friend std::vector<T> operator|(std::string_view input, BulkNumberParser parser) { return parser(input); }
+};
+
+/// Eager replacement for ParseNumbers: input | BulkParseNumbers<T> gives a std::vector<T>
+template <std::integral T>
+constexpr BulkNumberParser<T> BulkParseNumbers{};
@@ -0,0 +1,98 @@
+#include "CpuFeatures.hpp"
+
+#include <array>
+#include <format>
+#include <stdexcept>
+
+#ifdef _MSC_VER
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+namespace {
+
+constexpr std::array<std::string_view, 3> LEVEL_NAMES{"scalar", "avx2", "avx512"};
+
+#ifdef _MSC_VER
+std::array<uint32_t, 4> CpuId(uint32_t leaf) {
+    int info[4]{};
+    __cpuidex(info, static_cast<int>(leaf), 0);
+    return {static_cast<uint32_t>(info[0]), static_cast<uint32_t>(info[1]), static_cast<uint32_t>(info[2]),
+            static_cast<uint32_t>(info[3])};
+}
+
+IsaLevel Detect() {
+    constexpr uint32_t FMA_BIT      = 1u << 12;
+    constexpr uint32_t OSXSAVE_BIT  = 1u << 27;
+    constexpr uint32_t AVX_BIT      = 1u << 28;
+    constexpr uint32_t AVX2_BIT     = 1u << 5;
+    constexpr uint32_t BMI2_BIT     = 1u << 8;
+    constexpr uint32_t AVX512F_BIT  = 1u << 16;
+    constexpr uint32_t AVX512DQ_BIT = 1u << 17;
+    constexpr uint32_t AVX512BW_BIT = 1u << 30;
+    constexpr uint32_t AVX512VL_BIT = 1u << 31;
+    // XMM and YMM state, then opmask and both halves of the ZMM state
+    constexpr uint64_t AVX_STATE    = 0x6;
+    constexpr uint64_t AVX512_STATE = 0xE6;
+
+    if (CpuId(0)[0] < 7) {
+        return IsaLevel::SCALAR;
+    }
+    const uint32_t features = CpuId(1)[2];
+    if ((features & (FMA_BIT | OSXSAVE_BIT | AVX_BIT)) != (FMA_BIT | OSXSAVE_BIT | AVX_BIT)) {
+        return IsaLevel::SCALAR;
+    }
+    // The processor may support AVX while the OS doesn't save the wider registers on a context switch
+    const uint64_t osState          = _xgetbv(0);
+    const uint32_t extendedFeatures = CpuId(7)[1];
+    if ((osState & AVX_STATE) != AVX_STATE || (extendedFeatures & (AVX2_BIT | BMI2_BIT)) != (AVX2_BIT | BMI2_BIT)) {
+        return IsaLevel::SCALAR;
+    }
+    constexpr uint32_t AVX512_BITS = AVX512F_BIT | AVX512DQ_BIT | AVX512BW_BIT | AVX512VL_BIT;
+    if ((osState & AVX512_STATE) != AVX512_STATE || (extendedFeatures & AVX512_BITS) != AVX512_BITS) {
+        return IsaLevel::AVX2;
+    }
+    return IsaLevel::AVX512;
+}
+#else
+IsaLevel Detect() {
+    // Checks the OS saves the wider registers as well, not only the cpuid bits
+    __builtin_cpu_init();
+    if (!__builtin_cpu_supports("avx2") || !__builtin_cpu_supports("fma") || !__builtin_cpu_supports("bmi2")) {
+        return IsaLevel::SCALAR;
+    }
+    if (!__builtin_cpu_supports("avx512f") || !__builtin_cpu_supports("avx512dq") ||
+        !__builtin_cpu_supports("avx512bw") || !__builtin_cpu_supports("avx512vl")) {
+        return IsaLevel::AVX2;
+    }
+    return IsaLevel::AVX512;
+}
+#endif
+
+} // namespace
+
+IsaLevel CpuFeatures::Supported() noexcept {
+    static const IsaLevel supported = Detect();
+    return supported;
+}
+
+void CpuFeatures::Select(IsaLevel level) {
+    if (level > Supported()) {
+        throw std::invalid_argument{std::format("This processor doesn't support {}, the widest it runs is {}",
+                                                Name(level), Name(Supported()))};
+    }
+    active = level;
+}
+
+std::string_view CpuFeatures::Name(IsaLevel level) noexcept {
+    return LEVEL_NAMES[static_cast<std::size_t>(level)];
+}
+
+std::optional<IsaLevel> CpuFeatures::Parse(std::string_view name) noexcept {
+    for (std::size_t l{0}; l < LEVEL_NAMES.size(); ++l) {
+        if (LEVEL_NAMES[l] == name) {
+            return static_cast<IsaLevel>(l);
+        }
+    }
+    return std::nullopt;
+}
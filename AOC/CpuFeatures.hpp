@@ -0,0 +1,52 @@
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/// Runtime instruction set dispatch
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+/// Tiers the dispatched kernels are written for, each one includes those below it
+enum class IsaLevel : uint8_t {
+    SCALAR, ///< x86-64 baseline
+    AVX2,   ///< AVX2, FMA and BMI2, as in x86-64-v3
+    AVX512, ///< AVX-512 F, BW, DQ and VL, as in x86-64-v4
+};
+
+/// <summary>
+/// Detects the widest tier the processor and OS support once at startup.
+/// Kernels above the build's own flags are compiled with attr_target and only run once Active() reaches their tier,
+/// so one binary runs on every host. --isa lowers the tier to compare the kernels on a single machine.
+/// </summary>
+class CpuFeatures {
+public:
+    /// Widest tier this processor runs
+    static IsaLevel Supported() noexcept;
+    /// Tier the kernels dispatch on, SCALAR until static initialisation has run
+    [[nodiscard]] static IsaLevel Active() noexcept { return active; }
+    /// Makes level the active tier, throws if the processor can't run it
+    static void Select(IsaLevel level);
+
+    static std::string_view Name(IsaLevel level) noexcept;
+    /// Inverse of Name, nullopt for anything else
+    static std::optional<IsaLevel> Parse(std::string_view name) noexcept;
+
+private:
+    static inline IsaLevel active = Supported();
+};
+
+/// <summary>
+/// Calls kernel.template operator()<Isa>() with the active tier as a constant, so code using the bit tricks of pch.hpp
+/// picks their instructions once outside its loop rather than on every call: WithActiveIsa([&]<IsaLevel Isa> { ... }).
+/// </summary>
+template <class Kernel>
+decltype(auto) WithActiveIsa(Kernel&& kernel) {
+    switch (CpuFeatures::Active()) {
+        case IsaLevel::AVX512: return kernel.template operator()<IsaLevel::AVX512>();
+        case IsaLevel::AVX2: return kernel.template operator()<IsaLevel::AVX2>();
+        case IsaLevel::SCALAR: break;
+    }
+    return kernel.template operator()<IsaLevel::SCALAR>();
+}
@@ -0,0 +1,57 @@
+# Runs one day twice on the same InputGen input, once as is and once with VARIANT_ARGS, and fails unless both runs
+# log the same solution lines. Run by the differential tests of CMakeLists.txt:
+#   cmake -D DAY=<day> -D DAY_EXE=<day binary> -D INPUT_GEN=<InputGen binary> -D WORK_DIR=<directory>
+#         "-D VARIANT_ARGS=<options>" [-D SEED=N] [-D SCALE=S] -P DifferentialTest.cmake
+# A generated input with a fixed seed needs neither the puzzle input nor its expected answers, so a variant that
+# changes an answer fails on any machine. Each run blesses its solution lines into a file of its own to compare.
+
+foreach(required DAY DAY_EXE INPUT_GEN WORK_DIR VARIANT_ARGS)
+    if (NOT DEFINED ${required})
+        message(FATAL_ERROR "DifferentialTest.cmake needs -D ${required}=...")
+    endif()
+endforeach()
+if (NOT DEFINED SEED)
+    set(SEED 2024)
+endif()
+if (NOT DEFINED SCALE)
+    set(SCALE 1)
+endif()
+
+file(REMOVE_RECURSE ${WORK_DIR})
+file(MAKE_DIRECTORY ${WORK_DIR})
+execute_process(
+        COMMAND ${INPUT_GEN} ${DAY} --scale ${SCALE} --seed ${SEED} --output ${WORK_DIR}/input.txt
+        RESULT_VARIABLE result
+        ERROR_VARIABLE output)
+if (NOT result EQUAL 0)
+    message(FATAL_ERROR "InputGen ${DAY} failed (${result}):\n${output}")
+endif()
+
+# Sets <run>_answers to the solution lines the day logs with the extra arguments
+function(RunDay run)
+    execute_process(
+            COMMAND ${DAY_EXE} --input ${WORK_DIR}/input.txt --expect ${WORK_DIR}/${run}.txt --bless ${ARGN}
+            WORKING_DIRECTORY ${WORK_DIR}
+            RESULT_VARIABLE result
+            OUTPUT_VARIABLE output
+            ERROR_VARIABLE output)
+    if (NOT result EQUAL 0)
+        message(FATAL_ERROR "${DAY} ${ARGN} failed (${result}):\n${output}")
+    endif()
+    file(READ ${WORK_DIR}/${run}.txt answers)
+    set(${run}_answers "${answers}" PARENT_SCOPE)
+endfunction()
+
+separate_arguments(variant_args UNIX_COMMAND "${VARIANT_ARGS}")
+RunDay(baseline)
+RunDay(variant ${variant_args})
+
+string(STRIP "${baseline_answers}" baseline_stripped)
+if (baseline_stripped STREQUAL "[${DAY}]")
+    message(FATAL_ERROR "${DAY} logged no solution lines, there is nothing to compare")
+endif()
+if (NOT baseline_answers STREQUAL variant_answers)
+    message(FATAL_ERROR "${DAY} answers differently with ${VARIANT_ARGS}\n"
+                        "as is:\n${baseline_answers}\nwith ${VARIANT_ARGS}:\n${variant_answers}")
+endif()
+message(STATUS "${DAY} gives the same answers with ${VARIANT_ARGS}")
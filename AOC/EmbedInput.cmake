@@ -0,0 +1,40 @@
+# Compiles the input of one day into its executable, run by Problem() when AOC_EMBED_INPUT is on:
+#   cmake -D INPUT=<input file> -D NAME=<day> -D OUTPUT_DIR=<directory> -P EmbedInput.cmake
+# embedded_input.hpp holds the bytes as a constexpr array, so a day can parse them while compiling, and
+# embedded_input.cpp registers them with the runner. Like InputBuffer, the input always ends with '\n' and is
+# followed by a '\0' sentinel. A generated array rather than #embed, which few compilers support yet.
+
+file(READ ${INPUT} hex HEX)
+if (NOT hex STREQUAL "" AND NOT hex MATCHES "0a$")
+    string(APPEND hex "0a")
+endif()
+string(APPEND hex "00")
+
+string(REGEX REPLACE "([0-9a-f][0-9a-f])" "'\\\\x\\1'," bytes "${hex}")
+# 16 bytes per line
+string(REPEAT "'\\\\x..'," 16 line_pattern)
+string(REGEX REPLACE "(${line_pattern})" "\\1\n    " bytes "${bytes}")
+string(REGEX REPLACE "\n    $" "" bytes "${bytes}")
+
+file(CONFIGURE OUTPUT ${OUTPUT_DIR}/embedded_input.hpp CONTENT [[
+#pragma once
+
+// Generated by EmbedInput.cmake from @INPUT@
+
+#include <string_view>
+
+alignas(64) inline constexpr char EMBEDDED_INPUT_BYTES[] = {
+    @bytes@
+};
+
+/// Input of @NAME@, the '\0' sentinel after it is left out
+inline constexpr std::string_view EMBEDDED_INPUT{EMBEDDED_INPUT_BYTES, sizeof(EMBEDDED_INPUT_BYTES) - 1};
+]] @ONLY)
+
+file(CONFIGURE OUTPUT ${OUTPUT_DIR}/embedded_input.cpp CONTENT [[
+// Generated by EmbedInput.cmake from @INPUT@
+
+#include "embedded_input.hpp"
+
+AOC_REGISTER_EMBEDDED_INPUT(@NAME@, EMBEDDED_INPUT);
+]] @ONLY)
@@ -1,8 +1,13 @@
 #pragma once
 
+#include <immintrin.h>
+
+#include <array>
 #include <bit>
 #include <cstdint>
+#include <cstring>
 #include <span>
+#include <string_view>
 #include <type_traits>
 
 struct Fnv1a {
@@ -20,7 +25,7 @@ struct Fnv1a {
 
     template <class T>
         requires(std::is_trivially_destructible_v<T>)
-    constexpr std::size_t operator()(const T& v, std::uint64_t hash = OFFSET_BASIS) noexcept {
+    constexpr std::size_t operator()(const T& v, std::uint64_t hash = OFFSET_BASIS) const noexcept {
         if (std::is_constant_evaluated()) {
             return Compute(std::span<const std::byte, sizeof(v)>(std::bit_cast<std::array<std::byte, sizeof(v)>>(v)), hash);
         } else {
@@ -29,50 +34,181 @@ struct Fnv1a {
         }
     }
 };
-//
-// #include <immintrin.h>
-//
-// struct CrcHash {
-//    template <std::size_t N>
-//    static constexpr std::uint32_t Compute(std::span<const std::byte, N> rep, std::uint32_t crc = 0) noexcept {
-//        crc = ~crc;
-//        std::size_t i{0};
-//        while (i + 8 <= rep.size()) {
-//            i += 8;
-//            std::uint64_t block{};
-//            std::memcpy(&block, &rep[i], sizeof(block));
-//            crc = _mm_crc32_u64(crc, block);
-//        }
-//        if (i + 4 <= rep.size()) {
-//            i += 4;
-//            std::uint32_t block{};
-//            std::memcpy(&block, &rep[i], sizeof(block));
-//            crc = _mm_crc32_u32(crc, block);
-//        }
-//        if (i + 2 <= rep.size()) {
-//            i += 2;
-//            std::uint16_t block{};
-//            std::memcpy(&block, &rep[i], sizeof(block));
-//            crc = _mm_crc32_u16(crc, block);
-//        }
-//        if (i + 4 <= rep.size()) {
-//            i += 4;
-//            std::uint8_t block{};
-//            std::memcpy(&block, &rep[i], sizeof(block));
-//            crc = _mm_crc32_u8(crc, block);
-//        }
-//        return ~crc;
-//    }
-//
-//    template <class T>
-//        requires(std::has_unique_object_representations_v<T> && std::is_trivially_copyable_v<T> &&
-//                 std::is_trivially_destructible_v<T>)
-//    constexpr std::size_t operator()(const T& v, std::uint32_t crc = 0) noexcept {
-//        if (std::is_constant_evaluated()) {
-//            return Compute(std::bit_cast<std::array<std::byte, sizeof(v)>>(v), crc);
-//        } else {
-//            return Compute(std::span<const std::byte, sizeof(v)>(reinterpret_cast<const std::byte*>(&v), sizeof(v)),
-//                           crc);
-//        }
-//    }
-//};
\ No newline at end of file
+
+namespace HashDetail {
+
+/// Keys hashed by their bytes, padding would make equal keys hash differently
+template <class T>
+concept ByteHashable = std::has_unique_object_representations_v<T> && std::is_trivially_copyable_v<T>;
+
+template <ByteHashable T>
+constexpr std::array<std::byte, sizeof(T)> Bytes(const T& v) noexcept {
+    return std::bit_cast<std::array<std::byte, sizeof(T)>>(v);
+}
+
+/// Full 128 bit product of a and b with the halves xored together
+constexpr std::uint64_t MulFold(std::uint64_t a, std::uint64_t b) noexcept {
+#ifdef __SIZEOF_INT128__
+    const unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+    return static_cast<std::uint64_t>(product) ^ static_cast<std::uint64_t>(product >> 64);
+#else
+    const std::uint64_t aLow  = a & 0xFFFFFFFF;
+    const std::uint64_t aHigh = a >> 32;
+    const std::uint64_t bLow  = b & 0xFFFFFFFF;
+    const std::uint64_t bHigh = b >> 32;
+    const std::uint64_t low   = aLow * bLow;
+    const std::uint64_t mid1  = aHigh * bLow;
+    const std::uint64_t mid2  = aLow * bHigh;
+    const std::uint64_t high  = aHigh * bHigh;
+    const std::uint64_t carry = ((low >> 32) + (mid1 & 0xFFFFFFFF) + (mid2 & 0xFFFFFFFF)) >> 32;
+    return (a * b) ^ (high + (mid1 >> 32) + (mid2 >> 32) + carry);
+#endif
+}
+
+template <std::unsigned_integral T>
+constexpr T Load(std::span<const std::byte> bytes, std::size_t offset) noexcept {
+    if (std::is_constant_evaluated()) {
+        T value{0};
+        for (std::size_t i{0}; i < sizeof(T); ++i) {
+            value |= static_cast<T>(bytes[offset + i]) << (8 * i);
+        }
+        return value;
+    } else {
+        T value;
+        std::memcpy(&value, bytes.data() + offset, sizeof(T));
+        return value;
+    }
+}
+
+constexpr std::array<std::uint32_t, 256> CRC32C_TABLE = [] {
+    std::array<std::uint32_t, 256> table{};
+    for (std::uint32_t i{0}; i < table.size(); ++i) {
+        std::uint32_t crc{i};
+        for (int bit{0}; bit < 8; ++bit) {
+            crc = (crc >> 1) ^ (0x82F63B78 & (0u - (crc & 1)));
+        }
+        table[i] = crc;
+    }
+    return table;
+}();
+
+} // namespace HashDetail
+
+/// <summary>
+/// CRC32C of the key bytes, widened to 64 bits by a multiply so both the high bits boost::unordered uses for the
+/// bucket and the low bits it uses for the group tag depend on every input bit. Uses the SSE4.2 crc32 instruction
+/// when it is enabled, and a table at compile time or without it.
+/// </summary>
+struct CrcHash {
+    using is_avalanching = std::true_type;
+
+    static constexpr std::uint64_t WIDEN = 0x9E3779B97F4A7C15;
+
+    static constexpr std::uint32_t Compute(std::span<const std::byte> rep, std::uint32_t crc = 0) noexcept {
+        crc = ~crc;
+        std::size_t i{0};
+#if defined(__SSE4_2__) || defined(__AVX2__)
+        if (!std::is_constant_evaluated()) {
+            std::uint64_t crc64{crc};
+            for (; i + 8 <= rep.size(); i += 8) {
+                crc64 = _mm_crc32_u64(crc64, HashDetail::Load<std::uint64_t>(rep, i));
+            }
+            crc = static_cast<std::uint32_t>(crc64);
+            if (i + 4 <= rep.size()) {
+                crc = _mm_crc32_u32(crc, HashDetail::Load<std::uint32_t>(rep, i));
+                i += 4;
+            }
+            if (i + 2 <= rep.size()) {
+                crc = _mm_crc32_u16(crc, HashDetail::Load<std::uint16_t>(rep, i));
+                i += 2;
+            }
+            if (i < rep.size()) {
+                crc = _mm_crc32_u8(crc, static_cast<std::uint8_t>(rep[i]));
+            }
+            return ~crc;
+        }
+#endif
+        for (; i < rep.size(); ++i) {
+            crc = (crc >> 8) ^ HashDetail::CRC32C_TABLE[(crc ^ static_cast<std::uint32_t>(rep[i])) & 0xFF];
+        }
+        return ~crc;
+    }
+
+    template <HashDetail::ByteHashable T>
+    constexpr std::size_t operator()(const T& v, std::uint32_t crc = 0) const noexcept {
+        if (std::is_constant_evaluated()) {
+            return HashDetail::MulFold(Compute(HashDetail::Bytes(v), crc), WIDEN);
+        } else {
+            return HashDetail::MulFold(Compute({reinterpret_cast<const std::byte*>(&v), sizeof(v)}, crc), WIDEN);
+        }
+    }
+
+    constexpr std::size_t operator()(std::string_view v, std::uint32_t crc = 0) const noexcept {
+        if (std::is_constant_evaluated()) {
+            std::uint32_t result = ~crc;
+            for (const char c : v) {
+                result = (result >> 8) ^ HashDetail::CRC32C_TABLE[(result ^ static_cast<unsigned char>(c)) & 0xFF];
+            }
+            return HashDetail::MulFold(~result, WIDEN);
+        } else {
+            return HashDetail::MulFold(Compute(std::as_bytes(std::span{v}), crc), WIDEN);
+        }
+    }
+};
+
+// Check value of the CRC-32C catalogue entry
+static_assert(CrcHash::Compute(HashDetail::Bytes(std::array{'1', '2', '3', '4', '5', '6', '7', '8', '9'})) ==
+              0xE3069283);
+static_assert(CrcHash{}(std::string_view{"123456789"}) == HashDetail::MulFold(0xE3069283, CrcHash::WIDEN));
+
+/// <summary>
+/// wyhash style hash: the key is read as at most two 64 bit words per 16 bytes, each round is a full 64x64 multiply
+/// folded back to 64 bits. Not bit compatible with wyhash, but built the same way and just as well mixed.
+/// </summary>
+struct WyHash {
+    using is_avalanching = std::true_type;
+
+    static constexpr std::array<std::uint64_t, 3> SECRET{0xa0761d6478bd642f, 0xe7037ed1a0b428db, 0x8ebc6af09c88c6e3};
+
+    static constexpr std::uint64_t Compute(std::span<const std::byte> rep, std::uint64_t seed = 0) noexcept {
+        using HashDetail::Load;
+        using HashDetail::MulFold;
+        const std::size_t size = rep.size();
+        seed ^= MulFold(seed ^ SECRET[0], SECRET[1]);
+        std::uint64_t a{0};
+        std::uint64_t b{0};
+        if (size <= 16) {
+            if (size >= 4) {
+                // Two overlapping 4 byte reads from each end cover 4 to 16 bytes without a branch per size
+                const std::size_t quarter = (size >> 3) << 2;
+                a = (std::uint64_t{Load<std::uint32_t>(rep, 0)} << 32) | Load<std::uint32_t>(rep, quarter);
+                b = (std::uint64_t{Load<std::uint32_t>(rep, size - 4)} << 32) |
+                    Load<std::uint32_t>(rep, size - 4 - quarter);
+            } else if (size > 0) {
+                a = (static_cast<std::uint64_t>(rep[0]) << 16) | (static_cast<std::uint64_t>(rep[size >> 1]) << 8) |
+                    static_cast<std::uint64_t>(rep[size - 1]);
+            }
+        } else {
+            std::size_t i{0};
+            for (; i + 16 < size; i += 16) {
+                seed = MulFold(Load<std::uint64_t>(rep, i) ^ SECRET[1], Load<std::uint64_t>(rep, i + 8) ^ seed);
+            }
+            a = Load<std::uint64_t>(rep, size - 16);
+            b = Load<std::uint64_t>(rep, size - 8);
+        }
+        return MulFold(SECRET[1] ^ size, MulFold(a ^ SECRET[1], b ^ seed) ^ SECRET[2]);
+    }
+
+    template <HashDetail::ByteHashable T>
+    constexpr std::size_t operator()(const T& v, std::uint64_t seed = 0) const noexcept {
+        if (std::is_constant_evaluated()) {
+            return Compute(HashDetail::Bytes(v), seed);
+        } else {
+            return Compute({reinterpret_cast<const std::byte*>(&v), sizeof(v)}, seed);
+        }
+    }
+
+    std::size_t operator()(std::string_view v, std::uint64_t seed = 0) const noexcept {
+        return Compute(std::as_bytes(std::span{v}), seed);
+    }
+};
@@ -0,0 +1,239 @@
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/// Shortest path searches over grids and other flat state spaces
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "Attr.hpp"
+
+namespace GridSearchDetail {
+
+/// Default stop condition, the search runs until every reachable state is settled
+struct NeverDone {
+    constexpr bool operator()(int32_t) const noexcept { return false; }
+};
+
+} // namespace GridSearchDetail
+
+/// <summary>
+/// Shortest distances from a set of sources over states numbered 0..stateCount-1, a grid index or a grid index times 4
+/// plus a direction. The graph is never stored: expand(state, edge) calls edge(next) for each unit edge of bfs(), or
+/// edge(next, weight) for zeroOneBfs() and dial(). It is a template parameter, so expanding a state inlines into the
+/// search loop and allocates nothing. Distances are one flat array and the queues keep their capacity from search to
+/// search, so rerunning on the same object doesn't allocate either.
+///
+/// With MaxPredecessors above 0, each state also records its predecessors on shortest paths. They form the DAG that
+/// forEachOnShortestPath() walks back. MaxPredecessors must bound the in-degree of the state graph.
+/// </summary>
+template <class Distance = int32_t, int32_t MaxPredecessors = 0, class Allocator = std::allocator<Distance>>
+class GridSearch {
+    static_assert(MaxPredecessors >= 0 && MaxPredecessors <= std::numeric_limits<uint8_t>::max());
+
+public:
+    static constexpr Distance UNREACHED        = std::numeric_limits<Distance>::max();
+    static constexpr bool RECORDS_PREDECESSORS = MaxPredecessors > 0;
+
+    explicit GridSearch(int32_t stateCount, const Allocator& allocator = {})
+        : distanceOf(static_cast<std::size_t>(stateCount), UNREACHED, allocator), frontier(allocator),
+          nextFrontier(allocator), buckets(allocator), predecessorOf(allocator), predecessorCount(allocator) {
+        if constexpr (RECORDS_PREDECESSORS) {
+            predecessorOf.resize(static_cast<std::size_t>(stateCount) * MaxPredecessors);
+            predecessorCount.resize(static_cast<std::size_t>(stateCount));
+        }
+    }
+
+    [[nodiscard]] int32_t stateCount() const noexcept { return static_cast<int32_t>(distanceOf.size()); }
+    [[nodiscard, attr_forceinline]] Distance distance(int32_t state) const noexcept { return distanceOf[state]; }
+    [[nodiscard, attr_forceinline]] bool reached(int32_t state) const noexcept {
+        return distanceOf[state] != UNREACHED;
+    }
+    [[nodiscard]] std::span<const Distance> distances() const noexcept { return distanceOf; }
+
+    /// Predecessors of state on its shortest paths, empty for the sources and unreached states
+    [[nodiscard]] std::span<const int32_t> predecessors(int32_t state) const noexcept
+        requires RECORDS_PREDECESSORS
+    {
+        return {predecessorOf.data() + static_cast<std::size_t>(state) * MaxPredecessors, predecessorCount[state]};
+    }
+
+    /// <summary>
+    /// Breadth-first search over unit edges, one frontier per distance. Stops as soon as it settles a state for which
+    /// done(state) is true. Every state nearer than that one is settled by then, and so are its predecessors.
+    /// </summary>
+    template <class Expand, class Done = GridSearchDetail::NeverDone>
+    void bfs(std::span<const int32_t> sources, Expand&& expand, Done&& done = {}) {
+        reset(sources, frontier);
+        for (Distance level{0}; !frontier.empty(); ++level) {
+            for (const int32_t state : frontier) {
+                if (done(state)) {
+                    return;
+                }
+                expand(state, [&](int32_t next) {
+                    if (relax(state, next, level + 1)) {
+                        nextFrontier.push_back(next);
+                    }
+                });
+            }
+            frontier.swap(nextFrontier);
+            nextFrontier.clear();
+        }
+    }
+
+    /// <summary>
+    /// Breadth-first search with edges of weight 0 or 1. A weight 0 edge appends to the frontier being expanded, a
+    /// weight 1 edge to the next frontier, so two buckets stand in for the usual deque. Stops like bfs(). With weight 0
+    /// edges, a predecessor at the same distance may be recorded only after done stops the search.
+    /// </summary>
+    template <class Expand, class Done = GridSearchDetail::NeverDone>
+    void zeroOneBfs(std::span<const int32_t> sources, Expand&& expand, Done&& done = {}) {
+        reset(sources, frontier);
+        for (Distance level{0}; !frontier.empty(); ++level) {
+            // Indexed, weight 0 edges grow the frontier while it is walked
+            for (std::size_t f{0}; f < frontier.size(); ++f) {
+                const int32_t state = frontier[f];
+                // Also queued at level + 1 before a weight 0 edge brought it to level
+                if (distanceOf[state] != level) {
+                    continue;
+                }
+                if (done(state)) {
+                    return;
+                }
+                expand(state, [&](int32_t next, Distance weight) {
+                    assert(weight == 0 || weight == 1);
+                    if (relax(state, next, level + weight)) {
+                        (weight == 0 ? frontier : nextFrontier).push_back(next);
+                    }
+                });
+            }
+            frontier.swap(nextFrontier);
+            nextFrontier.clear();
+        }
+    }
+
+    /// <summary>
+    /// Dijkstra over a bucket queue (Dial's algorithm), for integer edge weights 0..maxWeight. Each of the
+    /// maxWeight + 1 buckets holds the states queued at one distance modulo maxWeight + 1, so a push is an append and
+    /// a pop scans forward to the next non-empty bucket. Entries left behind by a later improvement are skipped when
+    /// popped. Stops like bfs(), and with positive weights every predecessor of a state is known once it is settled.
+    /// </summary>
+    template <class Expand, class Done = GridSearchDetail::NeverDone>
+    void dial(std::span<const int32_t> sources, Distance maxWeight, Expand&& expand, Done&& done = {}) {
+        const auto bucketCount = static_cast<std::size_t>(maxWeight) + 1;
+        if (buckets.size() < bucketCount) {
+            buckets.resize(bucketCount, Queue(buckets.get_allocator()));
+        }
+        for (Queue& bucket : buckets) {
+            bucket.clear();
+        }
+        reset(sources, buckets[0]);
+        std::size_t queued = buckets[0].size();
+        for (Distance level{0}; queued != 0; ++level) {
+            Queue& bucket = buckets[static_cast<std::size_t>(level) % bucketCount];
+            for (std::size_t b{0}; b < bucket.size(); ++b) {
+                const int32_t state = bucket[b];
+                if (distanceOf[state] != level) {
+                    continue;
+                }
+                if (done(state)) {
+                    return;
+                }
+                expand(state, [&](int32_t next, Distance weight) {
+                    assert(weight >= 0 && weight <= maxWeight);
+                    if (relax(state, next, level + weight)) {
+                        buckets[static_cast<std::size_t>(level + weight) % bucketCount].push_back(next);
+                        ++queued;
+                    }
+                });
+            }
+            queued -= bucket.size();
+            bucket.clear();
+        }
+    }
+
+    /// Calls visit(state) once for every state on a shortest path from the sources to one of targets, targets included
+    template <class Visit>
+    void forEachOnShortestPath(std::span<const int32_t> targets, Visit&& visit)
+        requires RECORDS_PREDECESSORS
+    {
+        std::vector<bool, typename Traits::template rebind_alloc<bool>> seen(distanceOf.size(), false,
+                                                                             distanceOf.get_allocator());
+        frontier.clear();
+        for (const int32_t target : targets) {
+            if (reached(target) && !seen[target]) {
+                seen[target] = true;
+                frontier.push_back(target);
+            }
+        }
+        while (!frontier.empty()) {
+            const int32_t state = frontier.back();
+            frontier.pop_back();
+            visit(state);
+            for (const int32_t predecessor : predecessors(state)) {
+                if (!seen[predecessor]) {
+                    seen[predecessor] = true;
+                    frontier.push_back(predecessor);
+                }
+            }
+        }
+    }
+
+private:
+    using Traits = std::allocator_traits<Allocator>;
+    using Queue  = std::vector<int32_t, typename Traits::template rebind_alloc<int32_t>>;
+
+    std::vector<Distance, Allocator> distanceOf;
+    Queue frontier;
+    Queue nextFrontier;
+    std::vector<Queue, typename Traits::template rebind_alloc<Queue>> buckets;
+    /// MaxPredecessors slots per state, the first predecessorCount[state] of them used
+    Queue predecessorOf;
+    std::vector<uint8_t, typename Traits::template rebind_alloc<uint8_t>> predecessorCount;
+
+    void reset(std::span<const int32_t> sources, Queue& queue) {
+        std::ranges::fill(distanceOf, UNREACHED);
+        if constexpr (RECORDS_PREDECESSORS) {
+            std::ranges::fill(predecessorCount, uint8_t{0});
+        }
+        frontier.clear();
+        nextFrontier.clear();
+        for (const int32_t source : sources) {
+            if (std::exchange(distanceOf[source], Distance{0}) != Distance{0}) {
+                queue.push_back(source);
+            }
+        }
+    }
+
+    /// Whether next got nearer through from and has to be queued, ties only add a predecessor
+    [[nodiscard, attr_forceinline]] bool relax(int32_t from, int32_t next, Distance nextDistance) noexcept {
+        Distance& current = distanceOf[next];
+        if (nextDistance < current) {
+            current = nextDistance;
+            if constexpr (RECORDS_PREDECESSORS) {
+                predecessorCount[next] = 0;
+                addPredecessor(next, from);
+            }
+            return true;
+        }
+        if constexpr (RECORDS_PREDECESSORS) {
+            if (nextDistance == current) {
+                addPredecessor(next, from);
+            }
+        }
+        return false;
+    }
+
+    [[attr_forceinline]] void addPredecessor(int32_t state, int32_t predecessor) noexcept {
+        uint8_t& count = predecessorCount[state];
+        assert(count < MaxPredecessors && "MaxPredecessors is below the in-degree of the state graph");
+        predecessorOf[static_cast<std::size_t>(state) * MaxPredecessors + count++] = predecessor;
+    }
+};
@@ -0,0 +1,218 @@
+// Checks the GridSearch algorithms against a reference Dijkstra on random grids, and dial() with
+// forEachOnShortestPath on the reindeer maze examples whose best path cell counts are known.
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <format>
+#include <functional>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "GridSearch.hpp"
+
+namespace {
+
+int failures{0};
+
+void Check(bool condition, std::string_view what) {
+    if (!condition) {
+        ++failures;
+        std::cerr << "Failed: " << what << '\n';
+    }
+}
+
+std::mt19937 rng{2024};
+
+/// <summary>
+/// Random grid of walls and open cells, each open cell costing 0 or 1 to enter. Edges go to the 4 neighbours, so
+/// every state has at most 4 predecessors.
+/// </summary>
+struct WeightedGrid {
+    int32_t height;
+    int32_t width;
+    /// -1 for a wall, else the weight of stepping onto the cell
+    std::vector<int32_t> enterCost;
+
+    WeightedGrid(int32_t h, int32_t w) : height{h}, width{w}, enterCost(static_cast<std::size_t>(h * w)) {
+        for (int32_t& cost : enterCost) {
+            const uint32_t roll = rng() % 8;
+            cost                = roll == 0 ? -1 : static_cast<int32_t>(roll % 2);
+        }
+    }
+
+    template <class Edge>
+    void expand(int32_t cell, Edge&& edge) const {
+        const int32_t y = cell / width;
+        const int32_t x = cell % width;
+        const auto step = [&](int32_t ny, int32_t nx) {
+            if (ny >= 0 && ny < height && nx >= 0 && nx < width && enterCost[ny * width + nx] >= 0) {
+                edge(ny * width + nx, enterCost[ny * width + nx]);
+            }
+        };
+        step(y - 1, x);
+        step(y, x - 1);
+        step(y, x + 1);
+        step(y + 1, x);
+    }
+
+    /// Plain Dijkstra over a binary heap, the reference every search is compared with
+    std::vector<int32_t> reference(std::span<const int32_t> sources, bool unitWeights) const {
+        std::vector<int32_t> distance(enterCost.size(), GridSearch<>::UNREACHED);
+        std::priority_queue<std::pair<int32_t, int32_t>, std::vector<std::pair<int32_t, int32_t>>, std::greater<>>
+            queue;
+        for (const int32_t source : sources) {
+            distance[source] = 0;
+            queue.emplace(0, source);
+        }
+        while (!queue.empty()) {
+            const auto [d, cell] = queue.top();
+            queue.pop();
+            if (d != distance[cell]) {
+                continue;
+            }
+            expand(cell, [&](int32_t next, int32_t weight) {
+                const int32_t nextDistance = d + (unitWeights ? 1 : weight);
+                if (nextDistance < distance[next]) {
+                    distance[next] = nextDistance;
+                    queue.emplace(nextDistance, next);
+                }
+            });
+        }
+        return distance;
+    }
+};
+
+void CheckRandomGrids() {
+    // Square, wide, tall and single row or column grids
+    for (const auto& [height, width] : {std::pair{1, 1}, std::pair{1, 17}, std::pair{17, 1}, std::pair{9, 9},
+                                        std::pair{5, 23}, std::pair{31, 7}, std::pair{40, 40}}) {
+        for (int trial{0}; trial < 20; ++trial) {
+            WeightedGrid grid{height, width};
+            std::vector<int32_t> sources(1 + rng() % 3);
+            for (int32_t& source : sources) {
+                source                 = static_cast<int32_t>(rng() % grid.enterCost.size());
+                grid.enterCost[source] = 0;
+            }
+            const std::string where = std::format("{}x{} grid, trial {}", height, width, trial);
+
+            GridSearch<int32_t, 4> search{height * width};
+            const std::vector<int32_t> weighted = grid.reference(sources, false);
+            search.zeroOneBfs(sources, [&](int32_t cell, auto&& edge) { grid.expand(cell, edge); });
+            Check(std::ranges::equal(search.distances(), weighted), "zeroOneBfs distances on the " + where);
+            search.dial(sources, 1, [&](int32_t cell, auto&& edge) { grid.expand(cell, edge); });
+            Check(std::ranges::equal(search.distances(), weighted), "dial distances on the " + where);
+            // Every recorded predecessor lies on a shortest path: it is reached, and one edge away
+            for (int32_t cell{0}; cell < search.stateCount(); ++cell) {
+                for (const int32_t predecessor : search.predecessors(cell)) {
+                    bool edgeFits{false};
+                    grid.expand(predecessor, [&](int32_t next, int32_t weight) {
+                        edgeFits |= next == cell && search.distance(predecessor) + weight == search.distance(cell);
+                    });
+                    Check(edgeFits, std::format("dial predecessor {} of {} on the {}", predecessor, cell, where));
+                }
+            }
+
+            const std::vector<int32_t> unit = grid.reference(sources, true);
+            search.bfs(sources, [&](int32_t cell, auto&& edge) {
+                grid.expand(cell, [&](int32_t next, int32_t) { edge(next); });
+            });
+            Check(std::ranges::equal(search.distances(), unit), "bfs distances on the " + where);
+
+            // Stopping at a target still settles the target at its shortest distance
+            const auto target = static_cast<int32_t>(rng() % grid.enterCost.size());
+            search.zeroOneBfs(
+                sources, [&](int32_t cell, auto&& edge) { grid.expand(cell, edge); },
+                [target](int32_t cell) { return cell == target; });
+            Check(search.distance(target) == weighted[target], "zeroOneBfs stopped at a target on the " + where);
+        }
+    }
+}
+
+/// <summary>
+/// Lowest score and number of cells on a best path through a reindeer maze, found like reindeer_maze does: states are
+/// a cell times 4 plus the direction faced, a step costs 1 and a quarter turn with a step 1001.
+/// </summary>
+std::pair<int32_t, std::size_t> SolveReindeerMaze(std::span<const std::string_view> rows) {
+    const auto height = static_cast<int32_t>(rows.size());
+    const auto width  = static_cast<int32_t>(rows[0].size());
+    int32_t start{0};
+    int32_t end{0};
+    for (int32_t y{0}; y < height; ++y) {
+        for (int32_t x{0}; x < width; ++x) {
+            start = rows[y][x] == 'S' ? y * width + x : start;
+            end   = rows[y][x] == 'E' ? y * width + x : end;
+        }
+    }
+    // Right, down, left, up, so turning is adding 1 or 3
+    const std::array<int32_t, 4> offsets{1, width, -1, -width};
+
+    GridSearch<int32_t, 3> search{height * width * 4};
+    const int32_t startState = start * 4;
+    search.dial(std::span{&startState, 1}, 1001, [&](int32_t state, auto&& edge) {
+        const int32_t cell = state >> 2;
+        for (const auto& [turn, score] : {std::pair{0, 1}, std::pair{1, 1001}, std::pair{3, 1001}}) {
+            const int32_t direction = (state + turn) & 0b11;
+            const int32_t next      = cell + offsets[direction];
+            if (rows[next / width][next % width] != '#') {
+                edge(next * 4 + direction, score);
+            }
+        }
+    });
+
+    int32_t best{GridSearch<>::UNREACHED};
+    for (int32_t direction{0}; direction < 4; ++direction) {
+        best = std::min(best, search.distance(end * 4 + direction));
+    }
+    std::vector<int32_t> bestEnds;
+    for (int32_t direction{0}; direction < 4; ++direction) {
+        if (search.distance(end * 4 + direction) == best) {
+            bestEnds.push_back(end * 4 + direction);
+        }
+    }
+    std::vector<bool> onBestPath(static_cast<std::size_t>(height * width));
+    std::size_t cells{0};
+    search.forEachOnShortestPath(bestEnds, [&](int32_t state) {
+        cells += !onBestPath[state >> 2];
+        onBestPath[state >> 2] = true;
+    });
+    return {best, cells};
+}
+
+void CheckReindeerMazes() {
+    constexpr std::array<std::string_view, 15> FIRST{
+        "###############", "#.......#....E#", "#.#.###.#.###.#", "#.....#.#...#.#", "#.###.#####.#.#",
+        "#.#.#.......#.#", "#.#.#####.###.#", "#...........#.#", "###.#.#####.#.#", "#...#.....#.#.#",
+        "#.#.#.###.#.#.#", "#.....#...#.#.#", "#.###.#.#.#.#.#", "#S..#.....#...#", "###############",
+    };
+    constexpr std::array<std::string_view, 17> SECOND{
+        "#################", "#...#...#...#..E#", "#.#.#.#.#.#.#.#.#", "#.#.#.#...#...#.#", "#.#.#.#.###.#.#.#",
+        "#...#.#.#.....#.#", "#.#.#.#.#.#####.#", "#.#...#.#.#.....#", "#.#.#####.#.###.#", "#.#.#.......#...#",
+        "#.#.###.#####.###", "#.#.#...#.....#.#", "#.#.#.#####.###.#", "#.#.#.........#.#", "#.#.#.#########.#",
+        "#S#.............#", "#################",
+    };
+    const auto [firstScore, firstCells] = SolveReindeerMaze(FIRST);
+    Check(firstScore == 7036, std::format("first maze scores {}, not 7036", firstScore));
+    Check(firstCells == 45, std::format("first maze has {} cells on best paths, not 45", firstCells));
+    const auto [secondScore, secondCells] = SolveReindeerMaze(SECOND);
+    Check(secondScore == 11048, std::format("second maze scores {}, not 11048", secondScore));
+    Check(secondCells == 64, std::format("second maze has {} cells on best paths, not 64", secondCells));
+}
+
+} // namespace
+
+int main() {
+    CheckRandomGrids();
+    CheckReindeerMazes();
+    if (failures != 0) {
+        std::cerr << failures << " checks failed\n";
+        return 1;
+    }
+    return 0;
+}
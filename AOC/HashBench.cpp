@@ -0,0 +1,155 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/// Hasher microbenchmark on the key types the days hash
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <concepts>
+#include <cstdio>
+#include <format>
+#include <limits>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <boost/container_hash/hash.hpp>
+#include <boost/unordered/unordered_flat_map.hpp>
+
+#include "Fnv.hpp"
+
+namespace {
+
+constexpr int ROUNDS = 7;
+
+std::mt19937_64 rng{2024};
+
+/// Change sequences as in monkey_market, each delta in [-9, 9]
+std::vector<std::array<int8_t, 4>> ChangeSequences(std::size_t count) {
+    std::uniform_int_distribution<int> delta{-9, 9};
+    std::vector<std::array<int8_t, 4>> keys(count);
+    for (std::array<int8_t, 4>& key : keys) {
+        for (int8_t& d : key) {
+            d = static_cast<int8_t>(delta(rng));
+        }
+    }
+    return keys;
+}
+
+/// Stone numbers as in plutonian_pebbles, small numbers are far more common than long ones
+std::vector<uint64_t> Pebbles(std::size_t count) {
+    std::uniform_int_distribution<int> digits{1, 12};
+    std::vector<uint64_t> keys(count);
+    for (uint64_t& key : keys) {
+        uint64_t limit{1};
+        for (int d = digits(rng); d > 0; --d) {
+            limit *= 10;
+        }
+        key = std::uniform_int_distribution<uint64_t>{0, limit - 1}(rng);
+    }
+    return keys;
+}
+
+/// Design prefixes and suffixes as in linen_layout, views into one backing string
+std::vector<std::string_view> Patterns(std::string& backing, std::size_t count) {
+    constexpr std::string_view COLOURS = "wubrg";
+    std::uniform_int_distribution<std::size_t> colour{0, COLOURS.size() - 1};
+    std::uniform_int_distribution<std::size_t> length{1, 60};
+    backing.resize(64 * 1024);
+    std::ranges::generate(backing, [&] { return COLOURS[colour(rng)]; });
+    std::uniform_int_distribution<std::size_t> start{0, backing.size() - 61};
+    std::vector<std::string_view> keys(count);
+    for (std::string_view& key : keys) {
+        key = std::string_view{backing}.substr(start(rng), length(rng));
+    }
+    return keys;
+}
+
+/// Computer names as in lan_party
+std::vector<std::array<char, 2>> NodeIds(std::size_t count) {
+    std::uniform_int_distribution<int> letter{'a', 'z'};
+    std::vector<std::array<char, 2>> keys(count);
+    for (std::array<char, 2>& key : keys) {
+        key = {static_cast<char>(letter(rng)), static_cast<char>(letter(rng))};
+    }
+    return keys;
+}
+
+template <typename Function>
+double BestNsPerKey(std::size_t keyCount, Function&& function) {
+    double best{std::numeric_limits<double>::infinity()};
+    for (int round{0}; round < ROUNDS; ++round) {
+        const auto start = std::chrono::steady_clock::now();
+        function();
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count() / static_cast<double>(keyCount));
+    }
+    return best;
+}
+
+template <typename Key, typename Hasher>
+void Measure(std::string_view keyName, std::string_view hasherName, const std::vector<Key>& keys) {
+    const Hasher hasher{};
+    volatile std::size_t sink{0};
+    const double hashNs = BestNsPerKey(keys.size(), [&] {
+        std::size_t combined{0};
+        for (const Key& key : keys) {
+            combined ^= hasher(key);
+        }
+        sink = combined;
+    });
+    // Counting occurrences is the access pattern of every map the days keep
+    const double mapNs = BestNsPerKey(keys.size(), [&] {
+        boost::unordered_flat_map<Key, uint32_t, Hasher> counts;
+        for (const Key& key : keys) {
+            ++counts[key];
+        }
+        sink = counts.size();
+    });
+    std::fputs(std::format("{:<22}{:<14}{:>10.2f}{:>12.2f}\n", keyName, hasherName, hashNs, mapNs).c_str(), stdout);
+}
+
+template <typename Key>
+void MeasureAll(std::string_view keyName, const std::vector<Key>& keys) {
+    Measure<Key, boost::hash<Key>>(keyName, "boost::hash", keys);
+    if constexpr (!std::same_as<Key, std::string_view>) {
+        Measure<Key, Fnv1a>(keyName, "Fnv1a", keys);
+    }
+    Measure<Key, CrcHash>(keyName, "CrcHash", keys);
+    Measure<Key, WyHash>(keyName, "WyHash", keys);
+}
+
+/// The crc32 instruction path has to agree with the table used at compile time
+bool CrcPathsAgree() {
+    std::uniform_int_distribution<int> byte{0, 255};
+    for (std::size_t size{0}; size < 200; ++size) {
+        std::vector<std::byte> bytes(size);
+        std::ranges::generate(bytes, [&] { return static_cast<std::byte>(byte(rng)); });
+        std::uint32_t crc{~0u};
+        for (const std::byte b : bytes) {
+            crc = (crc >> 8) ^ HashDetail::CRC32C_TABLE[(crc ^ static_cast<std::uint32_t>(b)) & 0xFF];
+        }
+        if (CrcHash::Compute(bytes) != ~crc) {
+            std::fputs(std::format("CrcHash mismatch for {} bytes\n", size).c_str(), stderr);
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main() {
+    if (!CrcPathsAgree()) {
+        return 1;
+    }
+    constexpr std::size_t KEY_COUNT = 1 << 20;
+    std::string patternBacking;
+    std::fputs(std::format("{:<22}{:<14}{:>10}{:>12}\n", "key", "hasher", "hash ns", "count ns").c_str(), stdout);
+    MeasureAll("array<int8_t, 4>", ChangeSequences(KEY_COUNT));
+    MeasureAll("uint64_t", Pebbles(KEY_COUNT));
+    MeasureAll("string_view", Patterns(patternBacking, KEY_COUNT));
+    MeasureAll("NodeId", NodeIds(KEY_COUNT));
+    return 0;
+}
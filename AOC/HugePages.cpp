@@ -0,0 +1,220 @@
+#include "HugePages.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
+#include <cstdio>
+#include <mutex>
+#include <new>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "Logger.hpp"
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+#ifndef MAP_HUGE_2MB
+#define MAP_HUGE_2MB (21 << 26)
+#endif
+
+namespace {
+
+/// Blocks freed since the last report
+std::atomic<uint64_t> blockCount{0};
+std::atomic<uint64_t> blockBytes{0};
+
+constexpr std::size_t RoundUp(std::size_t bytes) noexcept {
+    return (bytes + HugePages::HUGE_PAGE_SIZE - 1) / HugePages::HUGE_PAGE_SIZE * HugePages::HUGE_PAGE_SIZE;
+}
+
+double MiB(uint64_t bytes) noexcept {
+    return static_cast<double>(bytes) / static_cast<double>(1 << 20);
+}
+
+#ifdef __linux__
+/// A freed block kept mapped for HugePages::sampleBacking
+struct Block {
+    uintptr_t begin;
+    std::size_t size;
+};
+
+std::mutex pendingMutex;
+std::vector<Block> pendingBlocks;
+
+struct Backing {
+    /// Bytes of the blocks on explicit hugetlbfs pages, all of a block or nothing
+    std::size_t hugetlb{0};
+    /// Bytes of the blocks the kernel promoted to transparent huge pages
+    std::size_t transparent{0};
+};
+
+/// <summary>
+/// How the kernel backs blocks, sorted by address, read in one pass over /proc/self/smaps. Neighbouring blocks with the
+/// same flags may have been merged into one mapping, its transparent huge pages are then shared out by size.
+/// </summary>
+Backing SampleBacking(std::span<const Block> blocks) noexcept {
+    Backing backing;
+    std::FILE* smaps = std::fopen("/proc/self/smaps", "r");
+    if (smaps == nullptr) {
+        return backing;
+    }
+    struct Mapping {
+        uintptr_t begin{0};
+        uintptr_t end{0};
+        std::size_t kernelPageKiB{0};
+        std::size_t anonHugeKiB{0};
+    } mapping;
+    std::size_t next{0};
+    // smaps lists mappings by address too, so each block is passed once
+    const auto attribute = [&] {
+        for (; next < blocks.size() && blocks[next].begin < mapping.end; ++next) {
+            const Block& block = blocks[next];
+            if (block.begin < mapping.begin) {
+                continue;
+            }
+            if (mapping.kernelPageKiB * 1024 >= HugePages::HUGE_PAGE_SIZE) {
+                backing.hugetlb += block.size;
+            } else {
+                const double share = static_cast<double>(block.size) / static_cast<double>(mapping.end - mapping.begin);
+                const auto promoted = static_cast<std::size_t>(share * static_cast<double>(mapping.anonHugeKiB * 1024));
+                backing.transparent += std::min(block.size, promoted);
+            }
+        }
+    };
+    char line[256];
+    while (std::fgets(line, sizeof(line), smaps) != nullptr) {
+        uintptr_t begin{};
+        uintptr_t end{};
+        if (std::sscanf(line, "%" SCNxPTR "-%" SCNxPTR " ", &begin, &end) == 2) {
+            attribute();
+            mapping = {.begin = begin, .end = end};
+        } else {
+            std::sscanf(line, "KernelPageSize: %zu kB", &mapping.kernelPageKiB);
+            std::sscanf(line, "AnonHugePages: %zu kB", &mapping.anonHugeKiB);
+        }
+    }
+    attribute();
+    std::fclose(smaps);
+    return backing;
+}
+
+/// "always", "madvise" or "never", the bracketed choice in the sysfs file
+std::string TransparentMode() {
+    std::FILE* file = std::fopen("/sys/kernel/mm/transparent_hugepage/enabled", "r");
+    if (file == nullptr) {
+        return "unavailable";
+    }
+    char line[128]{};
+    const bool read = std::fgets(line, sizeof(line), file) != nullptr;
+    std::fclose(file);
+    const std::string text{line};
+    const std::size_t open  = text.find('[');
+    const std::size_t close = text.find(']', open);
+    return read && open != text.npos && close != text.npos ? text.substr(open + 1, close - open - 1) : "unknown";
+}
+#endif
+
+} // namespace
+
+#ifdef __linux__
+void* HugePages::Allocate(const std::size_t bytes) {
+    const std::size_t mappingSize = RoundUp(bytes);
+    if (enabled) {
+        // Fails straight away unless pages were reserved in /proc/sys/vm/nr_hugepages
+        void* explicitPages = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE,
+                                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_HUGE_2MB, -1, 0);
+        if (explicitPages != MAP_FAILED) {
+            return explicitPages;
+        }
+    }
+    // Transparent huge pages only back aligned 2 MiB ranges, so one extra page is reserved to align the start
+    void* reservation = mmap(nullptr, mappingSize + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (reservation == MAP_FAILED) {
+        throw std::bad_alloc{};
+    }
+    const auto reservationBegin = reinterpret_cast<uintptr_t>(reservation);
+    const uintptr_t begin       = RoundUp(reservationBegin);
+    if (begin != reservationBegin) {
+        munmap(reservation, begin - reservationBegin);
+    }
+    if (const std::size_t tail = reservationBegin + HUGE_PAGE_SIZE - begin; tail != 0) {
+        munmap(reinterpret_cast<void*>(begin + mappingSize), tail);
+    }
+    if (enabled) {
+        madvise(reinterpret_cast<void*>(begin), mappingSize, MADV_HUGEPAGE);
+    }
+    return reinterpret_cast<void*>(begin);
+}
+
+void HugePages::Deallocate(void* pointer, const std::size_t bytes) noexcept {
+    const std::size_t mappingSize = RoundUp(bytes);
+    blockCount.fetch_add(1, std::memory_order_relaxed);
+    blockBytes.fetch_add(mappingSize, std::memory_order_relaxed);
+    if (sampleBacking) {
+        const std::scoped_lock lock{pendingMutex};
+        try {
+            pendingBlocks.push_back({reinterpret_cast<uintptr_t>(pointer), mappingSize});
+            return;
+        } catch (const std::bad_alloc&) {
+            // Unmapped unsampled instead
+        }
+    }
+    munmap(pointer, mappingSize);
+}
+
+void HugePages::Report() {
+    std::vector<Block> sampled;
+    {
+        const std::scoped_lock lock{pendingMutex};
+        sampled.swap(pendingBlocks);
+    }
+    std::ranges::sort(sampled, {}, &Block::begin);
+    const Backing backing = SampleBacking(sampled);
+    for (const Block& block : sampled) {
+        munmap(reinterpret_cast<void*>(block.begin), block.size);
+    }
+
+    const uint64_t blocks = blockCount.exchange(0, std::memory_order_relaxed);
+    const uint64_t total  = blockBytes.exchange(0, std::memory_order_relaxed);
+    if (blocks == 0) {
+        return;
+    }
+    if (sampled.empty()) {
+        logger.perf("HugePages: {} blocks, {:.1f}MiB in all (mode {}{}, --huge-pages-stats samples their backing)",
+                    blocks, MiB(total), TransparentMode(), enabled ? "" : ", disabled by --no-huge-pages");
+        return;
+    }
+    uint64_t sampledBytes{0};
+    for (const Block& block : sampled) {
+        sampledBytes += block.size;
+    }
+    logger.perf("HugePages: {} blocks, {:.1f}MiB in all, {:.1f}MiB on hugetlbfs, {:.1f}MiB on transparent huge pages "
+                "({:.0f}% of the {:.1f}MiB sampled, mode {}{})",
+                blocks, MiB(total), MiB(backing.hugetlb), MiB(backing.transparent),
+                100.0 * static_cast<double>(backing.hugetlb + backing.transparent) / static_cast<double>(sampledBytes),
+                MiB(sampledBytes), TransparentMode(), enabled ? "" : ", disabled by --no-huge-pages");
+}
+#else
+// Large pages need a privilege on Windows, the blocks stay aligned so the layout matches
+void* HugePages::Allocate(const std::size_t bytes) {
+    return ::operator new(RoundUp(bytes), std::align_val_t{HUGE_PAGE_SIZE});
+}
+
+void HugePages::Deallocate(void* pointer, const std::size_t bytes) noexcept {
+    ::operator delete(pointer, RoundUp(bytes), std::align_val_t{HUGE_PAGE_SIZE});
+    blockCount.fetch_add(1, std::memory_order_relaxed);
+    blockBytes.fetch_add(RoundUp(bytes), std::memory_order_relaxed);
+}
+
+void HugePages::Report() {
+    const uint64_t blocks = blockCount.exchange(0, std::memory_order_relaxed);
+    const uint64_t total  = blockBytes.exchange(0, std::memory_order_relaxed);
+    if (blocks != 0) {
+        logger.perf("HugePages: {} blocks, {:.1f}MiB in all, none on huge pages on this platform", blocks, MiB(total));
+    }
+}
+#endif
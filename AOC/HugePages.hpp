@@ -0,0 +1,80 @@
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/// Huge page backed storage for large grids
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Mdspan.hpp"
+
+/// <summary>
+/// Blocks of at least one huge page are mapped 2 MiB aligned straight from the kernel. Explicit hugetlbfs pages are
+/// taken when the system has some reserved, otherwise the block is madvised for transparent huge pages. A 10k x 10k
+/// grid then takes a few dozen dTLB entries instead of tens of thousands. Smaller blocks aren't worth a mapping of
+/// their own and come from the heap. Report() sums up the blocks freed, and with sampleBacking also how much of them
+/// the kernel really backed with huge pages.
+/// </summary>
+class HugePages {
+public:
+    static constexpr std::size_t HUGE_PAGE_SIZE = std::size_t{2} << 20;
+
+    /// Cleared by --no-huge-pages, large blocks are still mapped but with the default page size
+    static inline bool enabled{true};
+
+    /// <summary>
+    /// Set by --huge-pages-stats. A freed block then stays mapped until Report(), which reads /proc/self/smaps once
+    /// for all of them. Freeing in a timed section is no slower, but the memory of freed blocks is held until the
+    /// report, so a --benchmark run holds one copy per sample.
+    /// </summary>
+    static inline bool sampleBacking{false};
+
+    /// Whether a block of bytes is mapped here rather than taken from the heap
+    [[nodiscard]] static constexpr bool Worthwhile(std::size_t bytes) noexcept { return bytes >= HUGE_PAGE_SIZE; }
+
+    /// bytes must be Worthwhile
+    static void* Allocate(std::size_t bytes);
+    static void Deallocate(void* pointer, std::size_t bytes) noexcept;
+
+    /// Logs the blocks freed since the last report, with sampleBacking also how many of their bytes were on huge pages
+    /// before unmapping them, then resets
+    static void Report();
+};
+
+/// Allocator putting large containers on huge pages, see HugePages
+template <class T>
+class HugePageAllocator {
+public:
+    using value_type = T;
+
+    HugePageAllocator() noexcept = default;
+    template <class U>
+    HugePageAllocator(const HugePageAllocator<U>&) noexcept {}
+
+    [[nodiscard]] T* allocate(std::size_t n) {
+        if (HugePages::Worthwhile(n * sizeof(T))) {
+            return static_cast<T*>(HugePages::Allocate(n * sizeof(T)));
+        }
+        return std::allocator<T>{}.allocate(n);
+    }
+
+    void deallocate(T* pointer, std::size_t n) noexcept {
+        if (HugePages::Worthwhile(n * sizeof(T))) {
+            HugePages::Deallocate(pointer, n * sizeof(T));
+        } else {
+            std::allocator<T>{}.deallocate(pointer, n);
+        }
+    }
+
+    friend bool operator==(const HugePageAllocator&, const HugePageAllocator&) noexcept = default;
+};
+
+template <class T>
+using HugePageVector = std::vector<T, HugePageAllocator<T>>;
+
+/// mdarray on huge pages once it is large enough, chosen per grid in place of the default std::vector container
+template <class T, class Extents, class Layout = layout_right>
+using HugePageMdarray = mdarray<T, Extents, Layout, HugePageVector<T>>;
@@ -0,0 +1,254 @@
+#include "Input.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#ifdef WIN32
+#include <io.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#ifndef MAP_POPULATE
+#define MAP_POPULATE 0
+#endif
+
+namespace {
+
+// Room for an appended '\n' plus the '\0' sentinel
+constexpr std::size_t TAIL_PADDING = 2;
+
+[[noreturn]] void ThrowErrno(const std::string& what) {
+    throw std::system_error{errno, std::generic_category(), what};
+}
+
+struct FileDescriptor {
+    int fd;
+
+    ~FileDescriptor() {
+#ifdef WIN32
+        _close(fd);
+#else
+        close(fd);
+#endif
+    }
+};
+
+/// One read, retried when a signal interrupts it. 0 at the end of the input.
+std::size_t ReadSome(const int fd, char* destination, const std::size_t count) {
+    while (true) {
+#ifdef WIN32
+        const auto bytesRead = _read(fd, destination, static_cast<unsigned>(count));
+#else
+        const auto bytesRead = read(fd, destination, count);
+#endif
+        if (bytesRead >= 0) {
+            return static_cast<std::size_t>(bytesRead);
+        }
+        if (errno != EINTR) {
+            ThrowErrno("read input");
+        }
+    }
+}
+
+int StdinDescriptor() {
+#ifdef WIN32
+    // Text mode would turn "\r\n" into "\n" and stop at the first ^Z
+    _setmode(0, _O_BINARY);
+#endif
+    return 0;
+}
+
+/// Appends the newline the last row may be missing. data must have TAIL_PADDING zeroed bytes after size.
+std::string_view Terminate(char* data, std::size_t size) noexcept {
+    if (size != 0 && data[size - 1] != '\n') {
+        data[size++] = '\n';
+    }
+    return {data, size};
+}
+
+} // namespace
+
+void InputBuffer::Unmapper::operator()([[maybe_unused]] char* mapping) const noexcept {
+#ifndef WIN32
+    munmap(mapping, mappingSize);
+#endif
+}
+
+#ifndef WIN32
+InputBuffer InputBuffer::Map(const int fd, const std::size_t fileSize) {
+    const auto pageSize{static_cast<std::size_t>(sysconf(_SC_PAGESIZE))};
+    const std::size_t mappingSize{(fileSize + TAIL_PADDING + pageSize - 1) / pageSize * pageSize};
+
+    // Reserve zeroed anonymous memory first so the sentinel exists even when the file ends on a page boundary,
+    // then map the file over the front of the reservation.
+    void* reservation = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (reservation == MAP_FAILED) {
+        ThrowErrno("mmap reservation");
+    }
+    InputBuffer buffer;
+    buffer.mapping = {static_cast<char*>(reservation), Unmapper{mappingSize}};
+
+    // Private so the trailing newline can be patched in without touching the file
+    void* file = mmap(reservation, fileSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED | MAP_POPULATE, fd, 0);
+    if (file == MAP_FAILED) {
+        ThrowErrno("mmap input");
+    }
+    madvise(file, fileSize, MADV_SEQUENTIAL);
+
+    buffer.input = Terminate(buffer.mapping.get(), fileSize);
+    return buffer;
+}
+#endif
+
+InputBuffer InputBuffer::Read(const int fd) {
+    std::size_t capacity{std::size_t{1} << 16};
+    std::size_t size{0};
+    auto storage = std::make_unique<char[]>(capacity);
+    while (true) {
+        if (capacity - size <= TAIL_PADDING) {
+            auto grown = std::make_unique<char[]>(capacity * 2);
+            std::memcpy(grown.get(), storage.get(), size);
+            storage = std::move(grown);
+            capacity *= 2;
+        }
+        const std::size_t bytesRead = ReadSome(fd, storage.get() + size, capacity - size - TAIL_PADDING);
+        if (bytesRead == 0) {
+            break;
+        }
+        size += bytesRead;
+    }
+
+    InputBuffer buffer;
+    buffer.heapStorage = std::move(storage);
+    buffer.input       = Terminate(buffer.heapStorage.get(), size);
+    return buffer;
+}
+
+InputBuffer InputBuffer::Load(const std::filesystem::path& path) {
+#ifdef WIN32
+    const FileDescriptor file{_wopen(path.c_str(), _O_RDONLY | _O_BINARY)};
+#else
+    const FileDescriptor file{open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+#endif
+    if (file.fd < 0) {
+        ThrowErrno(path.string());
+    }
+#ifndef WIN32
+    struct stat fileStat {};
+    if (fstat(file.fd, &fileStat) != 0) {
+        ThrowErrno("fstat input");
+    }
+    if (S_ISREG(fileStat.st_mode) && fileStat.st_size > 0) {
+        return Map(file.fd, static_cast<std::size_t>(fileStat.st_size));
+    }
+#endif
+    return Read(file.fd);
+}
+
+InputBuffer InputBuffer::LoadStdin() {
+    return Read(StdinDescriptor());
+}
+
+InputStream::InputStream(const int fd, const bool ownsFd, const std::size_t chunkSize)
+    : fd{fd}, ownsFd{ownsFd}, chunkSize{chunkSize} {}
+
+InputStream::InputStream(InputStream&& other) noexcept
+    : fd{other.fd}, ownsFd{std::exchange(other.ownsFd, false)}, chunkSize{other.chunkSize},
+      storage{std::move(other.storage)}, capacity{std::exchange(other.capacity, 0)},
+      filled{std::exchange(other.filled, 0)}, chunk{std::exchange(other.chunk, {})}, endOfInput{other.endOfInput},
+      totalBytes{other.totalBytes} {}
+
+InputStream::~InputStream() {
+    if (ownsFd) {
+#ifdef WIN32
+        _close(fd);
+#else
+        close(fd);
+#endif
+    }
+}
+
+InputStream InputStream::Open(const std::filesystem::path& path, const std::size_t chunkSize) {
+    if (chunkSize == 0) {
+        throw std::invalid_argument{"Input chunks can't be empty"};
+    }
+    if (path == "-") {
+        return InputStream{StdinDescriptor(), false, chunkSize};
+    }
+#ifdef WIN32
+    const int fd = _wopen(path.c_str(), _O_RDONLY | _O_BINARY);
+#else
+    const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+#endif
+    if (fd < 0) {
+        ThrowErrno(path.string());
+    }
+    InputStream stream{fd, true, chunkSize};
+#ifdef POSIX_FADV_SEQUENTIAL
+    // Larger readahead, the pages are only read once
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+    return stream;
+}
+
+std::string_view InputStream::refill(const std::size_t keepFrom) {
+    if (endOfInput) {
+        filled = 0;
+        chunk  = {};
+        return chunk;
+    }
+    const std::size_t kept   = filled - keepFrom;
+    const std::size_t needed = kept + chunkSize + TAIL_PADDING;
+    if (needed > capacity) {
+        auto grown = std::make_unique<char[]>(needed);
+        if (kept != 0) {
+            std::memcpy(grown.get(), storage.get() + keepFrom, kept);
+        }
+        storage  = std::move(grown);
+        capacity = needed;
+    } else if (kept != 0) {
+        std::memmove(storage.get(), storage.get() + keepFrom, kept);
+    }
+    filled = kept;
+
+    // Pipes hand out a few pages per read, keep reading so every chunk but the last is full
+    const std::size_t target = kept + chunkSize;
+    while (filled < target) {
+        const std::size_t bytesRead = ReadSome(fd, storage.get() + filled, target - filled);
+        if (bytesRead == 0) {
+            endOfInput = true;
+            break;
+        }
+        filled += bytesRead;
+        totalBytes += bytesRead;
+    }
+    // The buffer is reused, so the bytes Terminate relies on being zero have to be cleared
+    storage[filled]     = '\0';
+    storage[filled + 1] = '\0';
+    chunk  = endOfInput ? Terminate(storage.get(), filled) : std::string_view{storage.get(), filled};
+    filled = chunk.size();
+    return chunk;
+}
+
+std::string_view InputStream::next(const std::size_t unconsumed) {
+    return refill(chunk.size() - std::min(unconsumed, chunk.size()));
+}
+
+std::string_view InputStream::nextLines() {
+    std::string_view data = refill(chunk.size());
+    // A line longer than the chunk size grows the buffer until all of it fits
+    while (!endOfInput && data.rfind('\n') == data.npos) {
+        data = refill(0);
+    }
+    chunk = endOfInput ? data : data.substr(0, data.rfind('\n') + 1);
+    return chunk;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/// Puzzle input loading
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <string_view>
+
+/// <summary>
+/// Owns the bytes of a puzzle input.
+/// Regular files are memory mapped instead of copied. The view is always terminated by '\n' (unless the input is
+/// empty) and is followed by at least one readable '\0' sentinel byte, so ToGrid and Split('\n') see every row.
+/// </summary>
+class InputBuffer {
+    struct Unmapper {
+        std::size_t mappingSize;
+        void operator()(char* mapping) const noexcept;
+    };
+
+    std::unique_ptr<char[], Unmapper> mapping{nullptr, Unmapper{0}};
+    std::unique_ptr<char[]> heapStorage;
+    std::string_view input;
+
+    static InputBuffer Map(int fd, std::size_t fileSize);
+    static InputBuffer Read(int fd);
+
+public:
+    InputBuffer() = default;
+
+    static InputBuffer Load(const std::filesystem::path& path);
+    /// Reads standard input to the end, it can't be mapped
+    static InputBuffer LoadStdin();
+
+    [[nodiscard]] std::string_view view() const noexcept { return input; }
+    [[nodiscard]] bool isMapped() const noexcept { return mapping != nullptr; }
+};
+
+/// <summary>
+/// Reads a puzzle input a fixed size chunk at a time, for inputs too large to hold or arriving through a pipe.
+/// Whatever the caller leaves unconsumed at the end of a chunk is moved to the front of the next one, so records and
+/// tokens straddling a chunk boundary are always seen whole. The buffer only grows past the chunk size for a single
+/// record longer than it. Like InputBuffer, the final chunk ends with '\n' and every chunk is followed by '\0'.
+/// </summary>
+class InputStream {
+    int fd{-1};
+    bool ownsFd{false};
+    std::size_t chunkSize;
+    std::unique_ptr<char[]> storage;
+    std::size_t capacity{0};
+    /// Bytes in storage, the last chunk returned is a prefix of them
+    std::size_t filled{0};
+    std::string_view chunk;
+    bool endOfInput{false};
+    std::size_t totalBytes{0};
+
+    InputStream(int fd, bool ownsFd, std::size_t chunkSize);
+    /// Moves storage[keepFrom, filled) to the front and reads until a chunk's worth of new bytes or the end
+    std::string_view refill(std::size_t keepFrom);
+
+public:
+    static constexpr std::size_t DEFAULT_CHUNK_SIZE = std::size_t{1} << 20;
+
+    /// '-' opens standard input
+    static InputStream Open(const std::filesystem::path& path, std::size_t chunkSize = DEFAULT_CHUNK_SIZE);
+
+    InputStream(InputStream&& other) noexcept;
+    InputStream& operator=(InputStream&&) = delete;
+    ~InputStream();
+
+    /// Next chunk, starting with the last unconsumed bytes of the previous one. Empty once the final chunk was read,
+    /// which has to be consumed whole.
+    std::string_view next(std::size_t unconsumed = 0);
+    /// Next chunk cut after its last '\n', the partial line after it comes first in the following chunk
+    std::string_view nextLines();
+
+    /// Whether the chunk returned last is the final one
+    [[nodiscard]] bool atEnd() const noexcept { return endOfInput; }
+    /// Bytes read from the input so far
+    [[nodiscard]] std::size_t bytesRead() const noexcept { return totalBytes; }
+    /// Largest the buffer grew, the memory the stream holds
+    [[nodiscard]] std::size_t bufferSize() const noexcept { return capacity; }
+};
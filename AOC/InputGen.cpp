@@ -0,0 +1,924 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/// Synthetic inputs for every day at a chosen scale and seed
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <format>
+#include <iterator>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+constexpr std::string_view USAGE = R"(Usage: InputGen <day> [options]
+Writes a valid input for the day, sized relative to a real puzzle input.
+
+  --scale S      Size relative to a puzzle input, 1 by default. Grids grow in area, lists in length
+  --seed N       Random seed, the same day, scale and seed always write the same input
+  --output path  Output file, stdout by default
+  --list         Prints every day with what its scale grows
+)";
+
+using Rng = std::mt19937_64;
+
+/// <summary>
+/// Draws from [low, high]. Written out rather than std::uniform_int_distribution, whose output differs between
+/// standard libraries, so a seed writes the same input on every platform.
+/// </summary>
+int64_t Uniform(Rng& rng, int64_t low, int64_t high) {
+    return low + static_cast<int64_t>(rng() % static_cast<uint64_t>(high - low + 1));
+}
+
+bool Chance(Rng& rng, double probability) {
+    return static_cast<double>(rng() >> 11) * 0x1.0p-53 < probability;
+}
+
+template <class T>
+void Shuffle(std::vector<T>& values, Rng& rng) {
+    for (std::size_t i{values.size()}; i > 1; --i) {
+        std::swap(values[i - 1], values[static_cast<std::size_t>(Uniform(rng, 0, static_cast<int64_t>(i) - 1))]);
+    }
+}
+
+/// Length of a list that is base entries long in a puzzle input
+std::size_t Scaled(double base, double scale, std::size_t minimum = 1) {
+    return std::max(minimum, static_cast<std::size_t>(std::llround(base * scale)));
+}
+
+/// Side of a grid that is base cells wide in a puzzle input, the area grows with the scale
+int32_t ScaledSide(double base, double scale, int32_t minimum) {
+    return std::max(minimum, static_cast<int32_t>(std::lround(base * std::sqrt(scale))));
+}
+
+template <class... Args>
+void Append(std::string& out, std::format_string<Args...> format, Args&&... args) {
+    std::format_to(std::back_inserter(out), format, std::forward<Args>(args)...);
+}
+
+struct Cell {
+    int32_t y;
+    int32_t x;
+
+    friend bool operator==(const Cell&, const Cell&) = default;
+};
+
+constexpr std::array<Cell, 4> STEPS{{{-1, 0}, {0, 1}, {1, 0}, {0, -1}}};
+
+/// Rows of one width, written out with a newline after each as ToGrid expects
+struct CharGrid {
+    int32_t height;
+    int32_t width;
+    std::string cells;
+
+    CharGrid(int32_t height, int32_t width, char fill)
+        : height{height}, width{width},
+          cells(static_cast<std::size_t>(height) * static_cast<std::size_t>(width), fill) {}
+
+    char& operator()(int32_t y, int32_t x) {
+        return cells[static_cast<std::size_t>(y) * static_cast<std::size_t>(width) + static_cast<std::size_t>(x)];
+    }
+    char& operator()(const Cell& cell) { return (*this)(cell.y, cell.x); }
+    bool contains(const Cell& cell) const { return cell.y >= 0 && cell.y < height && cell.x >= 0 && cell.x < width; }
+
+    Cell randomCell(Rng& rng) const {
+        return {static_cast<int32_t>(Uniform(rng, 0, height - 1)), static_cast<int32_t>(Uniform(rng, 0, width - 1))};
+    }
+
+    void appendTo(std::string& out) const {
+        out.reserve(out.size() + cells.size() + static_cast<std::size_t>(height));
+        for (int32_t y{0}; y < height; ++y) {
+            out.append(std::string_view{cells}.substr(static_cast<std::size_t>(y) * width, width));
+            out += '\n';
+        }
+    }
+};
+
+/// <summary>
+/// Random depth-first spanning tree over the odd cells of a side x side grid, parent index per lattice cell.
+/// Lattice cell (i, j) is grid cell (2i + 1, 2j + 1), the root is its own parent.
+/// Iterative, the recursion of a 10k grid would run past any stack.
+/// </summary>
+std::vector<int32_t> SpanningTree(int32_t side, int32_t root, Rng& rng) {
+    const int32_t cells = (side - 1) / 2;
+    std::vector<int32_t> parent(static_cast<std::size_t>(cells) * cells, -1);
+    std::vector<int32_t> stack{root};
+    parent[root] = root;
+    while (!stack.empty()) {
+        const int32_t current = stack.back();
+        std::array<int32_t, 4> open{};
+        int32_t openCount{0};
+        for (const Cell& step : STEPS) {
+            const int32_t i = current / cells + step.y;
+            const int32_t j = current % cells + step.x;
+            if (i >= 0 && i < cells && j >= 0 && j < cells && parent[i * cells + j] < 0) {
+                open[openCount++] = i * cells + j;
+            }
+        }
+        if (openCount == 0) {
+            stack.pop_back();
+            continue;
+        }
+        const int32_t next = open[Uniform(rng, 0, openCount - 1)];
+        parent[next]       = current;
+        stack.push_back(next);
+    }
+    return parent;
+}
+
+/// Opens lattice cell index and the wall between it and its parent
+void OpenTreeEdge(CharGrid& grid, const std::vector<int32_t>& parent, int32_t index) {
+    const int32_t cells = (grid.height - 1) / 2;
+    const Cell from{2 * (index / cells) + 1, 2 * (index % cells) + 1};
+    const Cell to{2 * (parent[index] / cells) + 1, 2 * (parent[index] % cells) + 1};
+    grid(from)                                     = '.';
+    grid((from.y + to.y) / 2, (from.x + to.x) / 2) = '.';
+}
+
+/// Odd side so the maze lattice fills the grid up to a one cell border
+int32_t OddSide(double base, double scale) {
+    return ScaledSide(base, scale, 7) | 1;
+}
+
+void HistorianHysteria(std::string& out, double scale, Rng& rng) {
+    const std::size_t count = Scaled(1000, scale);
+    std::vector<int64_t> left(count);
+    for (int64_t& location : left) {
+        location = Uniform(rng, 10000, 99999);
+    }
+    for (const int64_t location : left) {
+        // Part 2 scores locations the right list repeats
+        const int64_t right =
+            Chance(rng, 0.25) ? left[Uniform(rng, 0, std::ssize(left) - 1)] : Uniform(rng, 10000, 99999);
+        Append(out, "{}   {}\n", location, right);
+    }
+}
+
+void RedNosedReports(std::string& out, double scale, Rng& rng) {
+    for (std::size_t report{0}; report < Scaled(1000, scale); ++report) {
+        std::vector<int64_t> levels(static_cast<std::size_t>(Uniform(rng, 5, 8)));
+        const int64_t direction = Chance(rng, 0.5) ? 1 : -1;
+        levels[0]               = Uniform(rng, 30, 70);
+        for (std::size_t l{1}; l < levels.size(); ++l) {
+            levels[l] = levels[l - 1] + direction * Uniform(rng, 1, 3);
+        }
+        // Half the reports break once, some of those the dampener forgives
+        if (Chance(rng, 0.5)) {
+            levels[static_cast<std::size_t>(Uniform(rng, 0, std::ssize(levels) - 1))] = Uniform(rng, 1, 99);
+        }
+        for (std::size_t l{0}; l < levels.size(); ++l) {
+            Append(out, "{}{}", levels[l], l + 1 == levels.size() ? '\n' : ' ');
+        }
+    }
+}
+
+void MullItOver(std::string& out, double scale, Rng& rng) {
+    constexpr std::string_view NOISE = "!@#$%^&*()[]{}<>,;:'+- ?/~";
+    constexpr std::array<std::string_view, 6> DECOYS{"why()", "from()", "select()", "what()", "when()", "who()"};
+    const std::size_t size = Scaled(18000, scale);
+    std::size_t lineStart  = out.size();
+    const std::size_t end  = out.size() + size;
+    while (out.size() < end) {
+        const int64_t roll = Uniform(rng, 0, 99);
+        if (roll < 55) {
+            out += NOISE[static_cast<std::size_t>(Uniform(rng, 0, NOISE.size() - 1))];
+        } else if (roll < 75) {
+            Append(out, "mul({},{})", Uniform(rng, 1, 999), Uniform(rng, 1, 999));
+        } else if (roll < 83) {
+            // Almost instructions the parser has to skip
+            switch (Uniform(rng, 0, 4)) {
+            case 0: Append(out, "mul({},{}", Uniform(rng, 1, 999), Uniform(rng, 1, 999)); break;
+            case 1: Append(out, "mul ( {},{})", Uniform(rng, 1, 999), Uniform(rng, 1, 999)); break;
+            case 2: Append(out, "mul({},{})", Uniform(rng, 1000, 9999), Uniform(rng, 1, 999)); break;
+            case 3: Append(out, "mul[{},{}]", Uniform(rng, 1, 999), Uniform(rng, 1, 999)); break;
+            default: Append(out, "mul({}*", Uniform(rng, 1, 999)); break;
+            }
+        } else if (roll < 90) {
+            out += DECOYS[static_cast<std::size_t>(Uniform(rng, 0, DECOYS.size() - 1))];
+        } else if (roll < 95) {
+            out += "do()";
+        } else {
+            out += "don't()";
+        }
+        if (out.size() - lineStart >= 3000) {
+            out += '\n';
+            lineStart = out.size();
+        }
+    }
+    out += '\n';
+}
+
+void CeresSearch(std::string& out, double scale, Rng& rng) {
+    constexpr std::string_view LETTERS = "XMAS";
+    // The solver walks extent(1) as rows, only a square grid reads the same both ways
+    const int32_t side = ScaledSide(140, scale, 4);
+    CharGrid grid{side, side, '.'};
+    for (char& cell : grid.cells) {
+        cell = LETTERS[static_cast<std::size_t>(Uniform(rng, 0, 3))];
+    }
+    grid.appendTo(out);
+}
+
+void PrintQueue(std::string& out, double scale, Rng& rng) {
+    // Rules cover every pair of the pages, so each update has exactly one correct order
+    std::vector<int64_t> pages;
+    for (int64_t page{11}; page < 100; ++page) {
+        pages.push_back(page);
+    }
+    Shuffle(pages, rng);
+    pages.resize(49);
+    std::vector<std::pair<int64_t, int64_t>> rules;
+    for (std::size_t before{0}; before < pages.size(); ++before) {
+        for (std::size_t after{before + 1}; after < pages.size(); ++after) {
+            rules.emplace_back(pages[before], pages[after]);
+        }
+    }
+    Shuffle(rules, rng);
+    for (const auto& [before, after] : rules) {
+        Append(out, "{}|{}\n", before, after);
+    }
+    out += '\n';
+    std::vector<std::size_t> ranks(pages.size());
+    for (std::size_t r{0}; r < ranks.size(); ++r) {
+        ranks[r] = r;
+    }
+    for (std::size_t update{0}; update < Scaled(200, scale); ++update) {
+        Shuffle(ranks, rng);
+        std::vector<std::size_t> chosen(ranks.begin(), ranks.begin() + Uniform(rng, 2, 11) * 2 + 1);
+        if (Chance(rng, 0.5)) {
+            std::ranges::sort(chosen);
+        }
+        for (std::size_t p{0}; p < chosen.size(); ++p) {
+            Append(out, "{}{}", pages[chosen[p]], p + 1 == chosen.size() ? '\n' : ',');
+        }
+    }
+}
+
+/// Walks the patrol from start and counts its steps. The wall it turns at twice if it loops, nullopt if it leaves
+std::optional<Cell> PatrolLoopWall(CharGrid& grid, const Cell& start, std::size_t& steps) {
+    std::unordered_set<uint64_t> turns;
+    Cell guard{start};
+    std::size_t heading{0};
+    for (steps = 0;;) {
+        const Cell ahead{guard.y + STEPS[heading].y, guard.x + STEPS[heading].x};
+        if (!grid.contains(ahead)) {
+            return std::nullopt;
+        }
+        if (grid(ahead) != '#') {
+            guard = ahead;
+            ++steps;
+            continue;
+        }
+        const uint64_t turn = (static_cast<uint64_t>(guard.y) * grid.width + guard.x) * 4 + heading;
+        if (!turns.insert(turn).second) {
+            return ahead;
+        }
+        heading = (heading + 1) % 4;
+    }
+}
+
+void GuardGallivant(std::string& out, double scale, Rng& rng) {
+    constexpr int CANDIDATES = 64;
+    const int32_t side       = ScaledSide(130, scale, 8);
+    CharGrid grid{side, side, '.'};
+    for (char& cell : grid.cells) {
+        cell = Chance(rng, 0.045) ? '#' : '.';
+    }
+    // Most random starts walk off the map within a few legs, the longest patrol of a few starts is kept
+    Cell start{side / 2, side / 2};
+    std::size_t longest{0};
+    for (int candidate{0}; candidate < CANDIDATES; ++candidate) {
+        const Cell cell{static_cast<int32_t>(Uniform(rng, side / 4, side * 3 / 4)),
+                        static_cast<int32_t>(Uniform(rng, side / 4, side * 3 / 4))};
+        std::size_t steps{0};
+        if (grid(cell) != '#' && !PatrolLoopWall(grid, cell, steps) && steps >= longest) {
+            start   = cell;
+            longest = steps;
+        }
+    }
+    grid(start) = '^';
+    // The guard has to leave the map, a wall the patrol turns at twice is taken out until it does
+    std::size_t steps{0};
+    while (const std::optional<Cell> loopWall = PatrolLoopWall(grid, start, steps)) {
+        grid(*loopWall) = '.';
+    }
+    grid.appendTo(out);
+}
+
+void BridgeRepair(std::string& out, double scale, Rng& rng) {
+    constexpr uint64_t LIMIT = 1'000'000'000'000'000;
+    for (std::size_t equation{0}; equation < Scaled(850, scale); ++equation) {
+        std::vector<uint64_t> numbers;
+        uint64_t test{0};
+        bool fits{false};
+        while (!fits) {
+            numbers.assign(static_cast<std::size_t>(Uniform(rng, 3, 12)), 0);
+            for (uint64_t& number : numbers) {
+                number = static_cast<uint64_t>(Chance(rng, 0.8) ? Uniform(rng, 1, 99) : Uniform(rng, 100, 999));
+            }
+            // Operators part 2 knows, so about half the equations only part 2 solves
+            test = numbers[0];
+            fits = true;
+            for (std::size_t n{1}; n < numbers.size() && fits; ++n) {
+                switch (Uniform(rng, 0, 2)) {
+                case 0: test += numbers[n]; break;
+                case 1: test *= numbers[n]; break;
+                default: test = test * (numbers[n] < 10 ? 10 : numbers[n] < 100 ? 100 : 1000) + numbers[n]; break;
+                }
+                fits = test < LIMIT;
+            }
+        }
+        if (Chance(rng, 0.3)) {
+            test += static_cast<uint64_t>(Uniform(rng, 1, 1000));
+        }
+        Append(out, "{}:", test);
+        for (const uint64_t number : numbers) {
+            Append(out, " {}", number);
+        }
+        out += '\n';
+    }
+}
+
+void ResonantCollinearity(std::string& out, double scale, Rng& rng) {
+    constexpr std::string_view FREQUENCIES = "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    const int32_t side = ScaledSide(50, scale, 4);
+    CharGrid grid{side, side, '.'};
+    const std::size_t antennae = Scaled(0.08 * side * side, 1.0);
+    for (std::size_t a{0}; a < antennae; ++a) {
+        grid(grid.randomCell(rng)) = FREQUENCIES[static_cast<std::size_t>(Uniform(rng, 0, FREQUENCIES.size() - 1))];
+    }
+    grid.appendTo(out);
+}
+
+void DiskFragmenter(std::string& out, double scale, Rng& rng) {
+    // Files and free spans alternate, starting and ending on a file
+    const std::size_t digits = Scaled(19999, scale) | 1;
+    for (std::size_t d{0}; d < digits; ++d) {
+        out += static_cast<char>('0' + (d % 2 == 0 ? Uniform(rng, 1, 9) : Uniform(rng, 0, 9)));
+    }
+    out += '\n';
+}
+
+void HoofIt(std::string& out, double scale, Rng& rng) {
+    const int32_t side = ScaledSide(45, scale, 4);
+    CharGrid grid{side, side, '.'};
+    for (char& cell : grid.cells) {
+        cell = static_cast<char>('0' + Uniform(rng, 0, 9));
+    }
+    // Random heights rarely climb, walked trails give every map trailheads with a score
+    for (std::size_t trail{0}; trail < Scaled(side * side / 20.0, 1.0); ++trail) {
+        Cell cell = grid.randomCell(rng);
+        for (char height{'0'}; height <= '9'; ++height) {
+            grid(cell) = height;
+            for (int attempt{0}; attempt < 4; ++attempt) {
+                const Cell& step = STEPS[static_cast<std::size_t>(Uniform(rng, 0, 3))];
+                const Cell next{cell.y + step.y, cell.x + step.x};
+                if (grid.contains(next)) {
+                    cell = next;
+                    break;
+                }
+            }
+        }
+    }
+    grid.appendTo(out);
+}
+
+void PlutonianPebbles(std::string& out, double scale, Rng& rng) {
+    const std::size_t count = Scaled(8, scale);
+    for (std::size_t p{0}; p < count; ++p) {
+        int64_t limit{1};
+        for (int64_t d{Uniform(rng, 1, 7)}; d > 0; --d) {
+            limit *= 10;
+        }
+        Append(out, "{}{}", Uniform(rng, 0, limit - 1), p + 1 == count ? '\n' : ' ');
+    }
+}
+
+void GardenGroups(std::string& out, double scale, Rng& rng) {
+    // Nearest of one jittered seed per block, so regions stay about BLOCK² cells whatever the scale and the
+    // solver's recursive flood fill stays shallow
+    constexpr int32_t BLOCK = 10;
+    const int32_t side      = ScaledSide(140, scale, 4);
+    const int32_t blocks    = (side + BLOCK - 1) / BLOCK;
+    std::vector<Cell> seeds(static_cast<std::size_t>(blocks) * blocks);
+    std::vector<char> plants(seeds.size());
+    for (std::size_t b{0}; b < seeds.size(); ++b) {
+        const auto by = static_cast<int32_t>(b / blocks);
+        const auto bx = static_cast<int32_t>(b % blocks);
+        seeds[b]      = {by * BLOCK + static_cast<int32_t>(Uniform(rng, 0, BLOCK - 1)),
+                         bx * BLOCK + static_cast<int32_t>(Uniform(rng, 0, BLOCK - 1))};
+        plants[b]     = static_cast<char>('A' + Uniform(rng, 0, 25));
+    }
+    CharGrid grid{side, side, '.'};
+    for (int32_t y{0}; y < side; ++y) {
+        for (int32_t x{0}; x < side; ++x) {
+            int64_t nearest{INT64_MAX};
+            for (int32_t by{std::max(0, y / BLOCK - 1)}; by <= std::min(blocks - 1, y / BLOCK + 1); ++by) {
+                for (int32_t bx{std::max(0, x / BLOCK - 1)}; bx <= std::min(blocks - 1, x / BLOCK + 1); ++bx) {
+                    const std::size_t b    = static_cast<std::size_t>(by) * blocks + bx;
+                    const int64_t dy       = seeds[b].y - y;
+                    const int64_t dx       = seeds[b].x - x;
+                    const int64_t distance = dy * dy + dx * dx;
+                    if (distance < nearest) {
+                        nearest    = distance;
+                        grid(y, x) = plants[b];
+                    }
+                }
+            }
+        }
+    }
+    grid.appendTo(out);
+}
+
+void ClawContraption(std::string& out, double scale, Rng& rng) {
+    const std::size_t count = Scaled(320, scale);
+    for (std::size_t m{0}; m < count; ++m) {
+        int64_t ax{0}, ay{0}, bx{0}, by{0};
+        // Parallel buttons leave the solver's system singular
+        while (ax * by == ay * bx) {
+            ax = Uniform(rng, 10, 99);
+            ay = Uniform(rng, 10, 99);
+            bx = Uniform(rng, 10, 99);
+            by = Uniform(rng, 10, 99);
+        }
+        int64_t px = Uniform(rng, 1000, 20000);
+        int64_t py = Uniform(rng, 1000, 20000);
+        if (Chance(rng, 0.5)) {
+            const int64_t a = Uniform(rng, 1, 100);
+            const int64_t b = Uniform(rng, 1, 100);
+            px              = a * ax + b * bx;
+            py              = a * ay + b * by;
+        }
+        Append(out, "Button A: X+{}, Y+{}\nButton B: X+{}, Y+{}\nPrize: X={}, Y={}\n{}", ax, ay, bx, by, px, py,
+               m + 1 == count ? "" : "\n");
+    }
+}
+
+void RestroomRedoubt(std::string& out, double scale, Rng& rng) {
+    // The solver's room is fixed, more robots crowd the same 101 x 103 tiles
+    constexpr int64_t WIDTH        = 101;
+    constexpr int64_t HEIGHT       = 103;
+    constexpr int32_t FRAME_WIDTH  = 31;
+    constexpr int32_t FRAME_HEIGHT = 33;
+    // A framed tree the robots form at one step, placed there by running each robot backwards
+    std::vector<Cell> tree;
+    for (int32_t x{0}; x < FRAME_WIDTH; ++x) {
+        tree.push_back({0, x});
+        tree.push_back({FRAME_HEIGHT - 1, x});
+    }
+    for (int32_t y{1}; y < FRAME_HEIGHT - 1; ++y) {
+        tree.push_back({y, 0});
+        tree.push_back({y, FRAME_WIDTH - 1});
+    }
+    for (int32_t row{0}; row < 14; ++row) {
+        for (int32_t x{FRAME_WIDTH / 2 - row}; x <= FRAME_WIDTH / 2 + row; ++x) {
+            tree.push_back({row + 2, x});
+        }
+    }
+    for (int32_t y{16}; y < 19; ++y) {
+        for (int32_t x{FRAME_WIDTH / 2 - 1}; x <= FRAME_WIDTH / 2 + 1; ++x) {
+            tree.push_back({y, x});
+        }
+    }
+    const int64_t treeStep  = Uniform(rng, 0, WIDTH * HEIGHT - 1);
+    const int64_t treeX     = Uniform(rng, 0, WIDTH - FRAME_WIDTH);
+    const int64_t treeY     = Uniform(rng, 0, HEIGHT - FRAME_HEIGHT);
+    const std::size_t count = Scaled(500, scale);
+    for (std::size_t r{0}; r < count; ++r) {
+        const int64_t vx = Uniform(rng, -100, 100);
+        const int64_t vy = Uniform(rng, -100, 100);
+        int64_t px       = Uniform(rng, 0, WIDTH - 1);
+        int64_t py       = Uniform(rng, 0, HEIGHT - 1);
+        if (r < std::min(tree.size(), count * 6 / 10)) {
+            px = ((treeX + tree[r].x - vx * treeStep) % WIDTH + WIDTH) % WIDTH;
+            py = ((treeY + tree[r].y - vy * treeStep) % HEIGHT + HEIGHT) % HEIGHT;
+        }
+        Append(out, "p={},{} v={},{}\n", px, py, vx, vy);
+    }
+}
+
+void WarehouseWoes(std::string& out, double scale, Rng& rng) {
+    const int32_t side = ScaledSide(50, scale, 6);
+    CharGrid grid{side, side, '#'};
+    for (int32_t y{1}; y < side - 1; ++y) {
+        for (int32_t x{1}; x < side - 1; ++x) {
+            const int64_t roll = Uniform(rng, 0, 99);
+            grid(y, x)         = roll < 5 ? '#' : roll < 35 ? 'O' : '.';
+        }
+    }
+    grid(static_cast<int32_t>(Uniform(rng, 1, side - 2)), static_cast<int32_t>(Uniform(rng, 1, side - 2))) = '@';
+    grid.appendTo(out);
+    out += '\n';
+    constexpr std::string_view MOVES = "<>^v";
+    const std::size_t moves          = Scaled(20000, scale);
+    for (std::size_t m{0}; m < moves; ++m) {
+        out += MOVES[static_cast<std::size_t>(Uniform(rng, 0, 3))];
+        if (m % 1000 == 999 || m + 1 == moves) {
+            out += '\n';
+        }
+    }
+}
+
+void ReindeerMaze(std::string& out, double scale, Rng& rng) {
+    // A perfect maze with a few walls knocked out, so there are several best paths to count
+    const int32_t side  = OddSide(141, scale);
+    const int32_t cells = (side - 1) / 2;
+    CharGrid grid{side, side, '#'};
+    const std::vector<int32_t> parent = SpanningTree(side, (cells - 1) * cells, rng);
+    for (int32_t index{0}; index < cells * cells; ++index) {
+        OpenTreeEdge(grid, parent, index);
+    }
+    for (int32_t y{1}; y < side - 1; ++y) {
+        for (int32_t x{1 + y % 2}; x < side - 1; x += 2) {
+            if (Chance(rng, 0.05)) {
+                grid(y, x) = '.';
+            }
+        }
+    }
+    grid(side - 2, 1) = 'S';
+    grid(1, side - 2) = 'E';
+    grid.appendTo(out);
+}
+
+void ChronospatialComputer(std::string& out, double, Rng& rng) {
+    // The solver reverses this one program by hand, one octal digit at a time with no backtracking, so only register A
+    // varies and the scale doesn't apply. Sixteen octal digits of A print one output per instruction.
+    Append(out, "Register A: {}\nRegister B: 0\nRegister C: 0\n\nProgram: 2,4,1,2,7,5,4,5,0,3,1,7,5,5,3,0\n",
+           Uniform(rng, int64_t{1} << 45, (int64_t{1} << 48) - 1));
+}
+
+/// Whether (0, 0) still reaches the far corner of a dim x dim space with the given bytes fallen
+bool Reachable(const std::vector<Cell>& bytes, std::size_t fallen, int32_t dim) {
+    CharGrid space{dim, dim, '.'};
+    for (std::size_t b{0}; b < fallen; ++b) {
+        space(bytes[b]) = '#';
+    }
+    std::vector<Cell> frontier{{0, 0}};
+    space(0, 0) = 'O';
+    while (!frontier.empty()) {
+        const Cell cell = frontier.back();
+        frontier.pop_back();
+        if (cell == Cell{dim - 1, dim - 1}) {
+            return true;
+        }
+        for (const Cell& step : STEPS) {
+            const Cell next{cell.y + step.y, cell.x + step.x};
+            if (space.contains(next) && space(next) == '.') {
+                space(next) = 'O';
+                frontier.push_back(next);
+            }
+        }
+    }
+    return false;
+}
+
+void RamRun(std::string& out, double scale, Rng& rng) {
+    // The solver fixes the space at 71 x 71 and part 1 at 1024 bytes, the scale only lengthens the list
+    constexpr int32_t DIM              = 71;
+    constexpr std::size_t PART1_FALLEN = 1024;
+    std::vector<Cell> bytes;
+    for (int32_t y{0}; y < DIM; ++y) {
+        for (int32_t x{0}; x < DIM; ++x) {
+            if (Cell{y, x} != Cell{0, 0} && Cell{y, x} != Cell{DIM - 1, DIM - 1}) {
+                bytes.push_back({y, x});
+            }
+        }
+    }
+    do {
+        Shuffle(bytes, rng);
+    } while (!Reachable(bytes, PART1_FALLEN, DIM));
+    // Part 2 needs the path cut within the list
+    std::size_t open{PART1_FALLEN};
+    std::size_t cut{bytes.size()};
+    while (cut - open > 1) {
+        const std::size_t middle = open + (cut - open) / 2;
+        (Reachable(bytes, middle, DIM) ? open : cut) = middle;
+    }
+    bytes.resize(std::clamp(Scaled(3450, scale), cut, bytes.size()));
+    for (const Cell& byte : bytes) {
+        Append(out, "{},{}\n", byte.x, byte.y);
+    }
+}
+
+void LinenLayout(std::string& out, double scale, Rng& rng) {
+    constexpr std::string_view COLOURS = "wubrg";
+    const auto RandomStripes           = [&](std::size_t length) {
+        std::string stripes(length, ' ');
+        for (char& stripe : stripes) {
+            stripe = COLOURS[static_cast<std::size_t>(Uniform(rng, 0, COLOURS.size() - 1))];
+        }
+        return stripes;
+    };
+    // One colour has no towel of its own, which leaves some designs impossible
+    const char lonely = COLOURS[static_cast<std::size_t>(Uniform(rng, 0, COLOURS.size() - 1))];
+    std::vector<std::string> patterns;
+    std::unordered_set<std::string> seen;
+    while (patterns.size() < 447) {
+        std::string pattern = RandomStripes(static_cast<std::size_t>(Uniform(rng, 1, 8)));
+        if (pattern != std::string(1, lonely) && seen.insert(pattern).second) {
+            patterns.push_back(std::move(pattern));
+        }
+    }
+    for (std::size_t p{0}; p < patterns.size(); ++p) {
+        Append(out, "{}{}", patterns[p], p + 1 == patterns.size() ? "\n\n" : ", ");
+    }
+    for (std::size_t design{0}; design < Scaled(400, scale); ++design) {
+        const auto length = static_cast<std::size_t>(Uniform(rng, 20, 60));
+        if (Chance(rng, 0.5)) {
+            std::string stripes;
+            while (stripes.size() < length) {
+                stripes += patterns[static_cast<std::size_t>(Uniform(rng, 0, std::ssize(patterns) - 1))];
+            }
+            out += stripes;
+        } else {
+            out += RandomStripes(length);
+        }
+        out += '\n';
+    }
+}
+
+void RaceCondition(std::string& out, double scale, Rng& rng) {
+    // One track with no branches, the solver follows it by always stepping onto the unvisited neighbour.
+    // Only the maze path between the corners is opened, and lattice cells keep a wall between parallel runs.
+    const int32_t side  = OddSide(141, scale);
+    const int32_t cells = (side - 1) / 2;
+    CharGrid grid{side, side, '#'};
+    const int32_t start               = (cells - 1) * cells;
+    const int32_t end                 = cells - 1;
+    const std::vector<int32_t> parent = SpanningTree(side, start, rng);
+    for (int32_t index{end}; index != start; index = parent[index]) {
+        OpenTreeEdge(grid, parent, index);
+    }
+    grid(side - 2, 1) = 'S';
+    grid(1, side - 2) = 'E';
+    grid.appendTo(out);
+}
+
+void KeypadConundrum(std::string& out, double scale, Rng& rng) {
+    for (std::size_t code{0}; code < Scaled(5, scale); ++code) {
+        Append(out, "{:03}A\n", Uniform(rng, 0, 999));
+    }
+}
+
+void MonkeyMarket(std::string& out, double scale, Rng& rng) {
+    for (std::size_t buyer{0}; buyer < Scaled(2000, scale); ++buyer) {
+        Append(out, "{}\n", Uniform(rng, 1, (1 << 24) - 1));
+    }
+}
+
+void LanParty(std::string& out, double scale, Rng& rng) {
+    // Two letter names allow 676 computers and the solver holds 13 connections per computer,
+    // so the scale stops growing the graph there
+    constexpr std::size_t DEGREE = 13;
+    std::vector<std::string> names;
+    for (char first{'a'}; first <= 'z'; ++first) {
+        for (char second{'a'}; second <= 'z'; ++second) {
+            names.push_back({first, second});
+        }
+    }
+    Shuffle(names, rng);
+    names.resize(std::clamp<std::size_t>(Scaled(520, scale), DEGREE + 1, names.size()));
+
+    std::vector<std::size_t> degree(names.size());
+    std::unordered_set<uint64_t> edges;
+    std::vector<std::pair<std::size_t, std::size_t>> edgeList;
+    const auto Connect = [&](std::size_t a, std::size_t b) {
+        if (a == b || degree[a] == DEGREE || degree[b] == DEGREE ||
+            !edges.insert(std::min(a, b) * names.size() + std::max(a, b)).second) {
+            return;
+        }
+        ++degree[a];
+        ++degree[b];
+        edgeList.emplace_back(a, b);
+    };
+    // The password clique, each member keeps one connection outside it
+    for (std::size_t a{0}; a < DEGREE; ++a) {
+        for (std::size_t b{a + 1}; b < DEGREE; ++b) {
+            Connect(a, b);
+        }
+    }
+    std::vector<std::size_t> stubs;
+    for (std::size_t node{0}; node < names.size(); ++node) {
+        stubs.insert(stubs.end(), DEGREE - degree[node], node);
+    }
+    Shuffle(stubs, rng);
+    for (std::size_t s{1}; s < stubs.size(); s += 2) {
+        Connect(stubs[s - 1], stubs[s]);
+    }
+    Shuffle(edgeList, rng);
+    for (const auto& [a, b] : edgeList) {
+        Append(out, "{}-{}\n", names[a], names[b]);
+    }
+}
+
+void CrossedWires(std::string& out, double scale, Rng& rng) {
+    // A ripple carry adder with four pairs of outputs swapped. The solver's part 2 swaps the pairs it found in
+    // the puzzle input by name, so the same names are planted at the same bits for it to find.
+    const auto bits = static_cast<int32_t>(std::clamp<std::size_t>(Scaled(45, scale), 40, 63));
+    struct Gate {
+        std::string lhs;
+        std::string_view op;
+        std::string rhs;
+        std::string output;
+    };
+    std::unordered_set<std::string> used{"nbc", "svm", "kqk", "fnr", "cgq"};
+    const auto Fresh = [&] {
+        for (;;) {
+            std::string name(3, ' ');
+            for (char& letter : name) {
+                letter = static_cast<char>('a' + Uniform(rng, 0, 22));
+            }
+            if (used.insert(name).second) {
+                return name;
+            }
+        }
+    };
+    const auto Wire = [](char prefix, int32_t bit) { return std::format("{}{:02}", prefix, bit); };
+    const int32_t swappedHalfAdder = static_cast<int32_t>(Uniform(rng, 1, 14));
+
+    std::vector<Gate> gates;
+    gates.push_back({Wire('x', 0), "XOR", Wire('y', 0), Wire('z', 0)});
+    std::string carry = Fresh();
+    gates.push_back({Wire('x', 0), "AND", Wire('y', 0), carry});
+    std::array<std::size_t, 2> halfAdder{};
+    std::size_t z15{0}, kqk{0}, z23{0}, cgq{0}, fnr{0}, z39{0};
+    for (int32_t bit{1}; bit < bits; ++bit) {
+        const std::string sum       = bit == swappedHalfAdder ? "nbc" : Fresh();
+        const std::string generate  = bit == swappedHalfAdder ? "svm" : bit == 39 ? "fnr" : Fresh();
+        const std::string propagate = bit == 15 ? "kqk" : Fresh();
+        std::string nextCarry       = bit + 1 == bits ? Wire('z', bits) : bit == 23 ? "cgq" : Fresh();
+        if (bit == swappedHalfAdder) {
+            halfAdder = {gates.size(), gates.size() + 1};
+        }
+        fnr = bit == 39 ? gates.size() + 1 : fnr;
+        gates.push_back({Wire('x', bit), "XOR", Wire('y', bit), sum});
+        gates.push_back({Wire('x', bit), "AND", Wire('y', bit), generate});
+        z15 = bit == 15 ? gates.size() : z15;
+        z23 = bit == 23 ? gates.size() : z23;
+        z39 = bit == 39 ? gates.size() : z39;
+        gates.push_back({sum, "XOR", carry, Wire('z', bit)});
+        kqk = bit == 15 ? gates.size() : kqk;
+        gates.push_back({sum, "AND", carry, propagate});
+        cgq = bit == 23 ? gates.size() : cgq;
+        gates.push_back({generate, "OR", propagate, nextCarry});
+        carry = std::move(nextCarry);
+    }
+    std::swap(gates[halfAdder[0]].output, gates[halfAdder[1]].output);
+    std::swap(gates[z15].output, gates[kqk].output);
+    std::swap(gates[z23].output, gates[cgq].output);
+    std::swap(gates[z39].output, gates[fnr].output);
+
+    for (const char prefix : {'x', 'y'}) {
+        for (int32_t bit{0}; bit < bits; ++bit) {
+            Append(out, "{}: {}\n", Wire(prefix, bit), Uniform(rng, 0, 1));
+        }
+    }
+    out += '\n';
+    Shuffle(gates, rng);
+    for (Gate& gate : gates) {
+        if (Chance(rng, 0.5)) {
+            std::swap(gate.lhs, gate.rhs);
+        }
+        Append(out, "{} {} {} -> {}\n", gate.lhs, gate.op, gate.rhs, gate.output);
+    }
+}
+
+void CodeChronicle(std::string& out, double scale, Rng& rng) {
+    const std::size_t count = Scaled(500, scale);
+    for (std::size_t schematic{0}; schematic < count; ++schematic) {
+        const bool lock = Chance(rng, 0.5);
+        std::array<int64_t, 5> heights{};
+        for (int64_t& height : heights) {
+            height = Uniform(rng, 0, 5);
+        }
+        // Locks hang from the top row, keys stand on the bottom one
+        for (int64_t row{0}; row < 7; ++row) {
+            for (const int64_t height : heights) {
+                out += (lock ? row <= height : row >= 6 - height) ? '#' : '.';
+            }
+            out += '\n';
+        }
+        if (schematic + 1 != count) {
+            out += '\n';
+        }
+    }
+}
+
+struct Generator {
+    std::string_view day;
+    /// What the scale multiplies
+    std::string_view grows;
+    void (*generate)(std::string& out, double scale, Rng& rng);
+};
+
+constexpr std::array<Generator, 25> GENERATORS{{
+    {"historian_hysteria", "1000 location pairs", HistorianHysteria},
+    {"red_nosed_reports", "1000 reports", RedNosedReports},
+    {"mull_it_over", "18000 bytes of memory", MullItOver},
+    {"ceres_search", "140 x 140 letters", CeresSearch},
+    {"print_queue", "200 updates", PrintQueue},
+    {"guard_gallivant", "130 x 130 map", GuardGallivant},
+    {"bridge_repair", "850 equations", BridgeRepair},
+    {"resonant_collinearity", "50 x 50 map", ResonantCollinearity},
+    {"disk_fragmenter", "19999 digit disk map", DiskFragmenter},
+    {"hoof_it", "45 x 45 map", HoofIt},
+    {"plutonian_pebbles", "8 stones", PlutonianPebbles},
+    {"garden_groups", "140 x 140 garden", GardenGroups},
+    {"claw_contraption", "320 machines", ClawContraption},
+    {"restroom_redoubt", "500 robots, the room stays 101 x 103", RestroomRedoubt},
+    {"warehouse_woes", "50 x 50 warehouse and 20000 moves", WarehouseWoes},
+    {"reindeer_maze", "141 x 141 maze", ReindeerMaze},
+    {"chronospatial_computer", "nothing, the program is fixed", ChronospatialComputer},
+    {"ram_run", "3450 bytes, the space stays 71 x 71", RamRun},
+    {"linen_layout", "400 designs", LinenLayout},
+    {"race_condition", "141 x 141 track", RaceCondition},
+    {"keypad_conundrum", "5 codes", KeypadConundrum},
+    {"monkey_market", "2000 buyers", MonkeyMarket},
+    {"lan_party", "520 computers, at most 676", LanParty},
+    {"crossed_wires", "45 bit adder, between 40 and 63 bits", CrossedWires},
+    {"code_chronicle", "500 locks and keys", CodeChronicle},
+}};
+
+template <class T>
+std::optional<T> ParseArgument(std::string_view text) {
+    T value{};
+    const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (error != std::errc{} || end != text.data() + text.size()) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+int Fail(std::string_view message) {
+    std::fputs(std::format("{}\n\n{}", message, USAGE).c_str(), stderr);
+    return 1;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const Generator* generator{nullptr};
+    double scale{1.0};
+    uint64_t seed{2024};
+    std::optional<std::string> outputPath;
+    for (int a{1}; a < argc; ++a) {
+        const std::string_view argument{argv[a]};
+        const bool hasValue = a + 1 < argc;
+        if (argument == "--help") {
+            std::fputs(USAGE.data(), stdout);
+            return 0;
+        }
+        if (argument == "--list") {
+            for (const Generator& listed : GENERATORS) {
+                std::fputs(std::format("{:<24}{}\n", listed.day, listed.grows).c_str(), stdout);
+            }
+            return 0;
+        }
+        if (argument == "--scale" && hasValue) {
+            const std::optional<double> parsed = ParseArgument<double>(argv[++a]);
+            if (!parsed || !(*parsed > 0.0)) {
+                return Fail(std::format("--scale takes a positive number, not {}", argv[a]));
+            }
+            scale = *parsed;
+        } else if (argument == "--seed" && hasValue) {
+            const std::optional<uint64_t> parsed = ParseArgument<uint64_t>(argv[++a]);
+            if (!parsed) {
+                return Fail(std::format("--seed takes an unsigned integer, not {}", argv[a]));
+            }
+            seed = *parsed;
+        } else if (argument == "--output" && hasValue) {
+            outputPath = argv[++a];
+        } else if (const auto found = std::ranges::find(GENERATORS, argument, &Generator::day);
+                   found != GENERATORS.end() && generator == nullptr) {
+            generator = &*found;
+        } else {
+            return Fail(std::format("Unexpected argument {}", argument));
+        }
+    }
+    if (generator == nullptr) {
+        return Fail("No day given, --list shows them");
+    }
+
+    Rng rng{seed};
+    std::string input;
+    generator->generate(input, scale, rng);
+
+    // Binary mode keeps the newlines single on Windows, the days split on '\n' only
+    std::FILE* file = outputPath ? std::fopen(outputPath->c_str(), "wb") : stdout;
+    if (file == nullptr) {
+        return Fail(std::format("Can't open {} for writing", *outputPath));
+    }
+    const bool written = std::fwrite(input.data(), 1, input.size(), file) == input.size();
+    if (outputPath) {
+        std::fclose(file);
+    }
+    return written ? 0 : 1;
+}
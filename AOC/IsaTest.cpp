@@ -0,0 +1,144 @@
+// Runs every dispatched kernel at each instruction set this processor supports and fails unless all of them agree
+// with the portable code. Kernels above the processor's tier are skipped, they can't run here.
+
+#include <cstdint>
+#include <format>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "BitTricks.hpp"
+#include "BulkParse.hpp"
+#include "CpuFeatures.hpp"
+#include "LineIndex.hpp"
+#include "Mdspan.hpp"
+
+using namespace std::literals;
+
+namespace {
+
+int failures{0};
+
+void Check(bool condition, std::string_view what) {
+    if (!condition) {
+        ++failures;
+        std::cerr << "Failed: " << what << '\n';
+    }
+}
+
+std::mt19937_64 rng{2024};
+
+/// Digits, separators and minus signs, never two minus signs in a row nor a number too long for int64_t
+std::string RandomNumbers(std::size_t length) {
+    constexpr std::string_view ALPHABET{"0123456789 ,\n-"};
+    std::string text;
+    std::size_t digits{0};
+    for (std::size_t i{0}; i < length; ++i) {
+        char c = ALPHABET[rng() % ALPHABET.size()];
+        digits = (c >= '0' && c <= '9') ? digits + 1 : 0;
+        if (digits > 18) {
+            c      = ' ';
+            digits = 0;
+        }
+        if (c != '-' || text.empty() || text.back() != '-') {
+            text += c;
+        }
+    }
+    return text;
+}
+
+std::string RandomLines(std::size_t length) {
+    constexpr std::string_view ALPHABET{"ab\n\n,"};
+    std::string text;
+    for (std::size_t i{0}; i < length; ++i) {
+        text += ALPHABET[rng() % ALPHABET.size()];
+    }
+    return text;
+}
+
+void CheckBitTricks(IsaLevel level) {
+    WithActiveIsa([&]<IsaLevel Isa> {
+        for (int i{0}; i < 10000; ++i) {
+            const uint64_t x    = rng();
+            const uint64_t mask = rng() & rng();
+            Check(Bitreverse<Isa>(x) == BitreversePortable(x),
+                  std::format("Bitreverse<{}>({:#x})", CpuFeatures::Name(level), x));
+            Check(Bitreverse<Isa>(static_cast<uint32_t>(x)) == BitreversePortable(static_cast<uint32_t>(x)),
+                  std::format("Bitreverse<{}>(uint32_t {:#x})", CpuFeatures::Name(level), static_cast<uint32_t>(x)));
+            Check(pdep<Isa>(x, mask) == PdepPortable(x, mask),
+                  std::format("pdep<{}>({:#x}, {:#x})", CpuFeatures::Name(level), x, mask));
+        }
+    });
+    Check(BitreversePortable(uint64_t{1}) == uint64_t{1} << 63, "BitreversePortable moves bit 0 to bit 63");
+    Check(PdepPortable(0b101, 0b11010) == 0b10010, "PdepPortable scatters to the mask bits");
+}
+
+void CheckBulkParse(IsaLevel level) {
+    for (int i{0}; i < 500; ++i) {
+        const std::string text = RandomNumbers(rng() % 300);
+        CpuFeatures::Select(IsaLevel::SCALAR);
+        const std::vector<int64_t> expected = text | BulkParseNumbers<int64_t>;
+        CpuFeatures::Select(level);
+        Check((text | BulkParseNumbers<int64_t>) == expected,
+              std::format("BulkParseNumbers at {} on \"{}\"", CpuFeatures::Name(level), text));
+    }
+}
+
+void CheckLineIndex(IsaLevel level) {
+    for (int i{0}; i < 500; ++i) {
+        const std::string text = RandomLines(rng() % 300);
+        for (const std::string_view separator : {"\n"sv, "\n\n"sv, ",a\n"sv}) {
+            CpuFeatures::Select(IsaLevel::SCALAR);
+            const LineIndex expected{text, separator};
+            CpuFeatures::Select(level);
+            const LineIndex lines{text, separator};
+            bool same = lines.size() == expected.size();
+            for (std::size_t r{0}; same && r < lines.size(); ++r) {
+                same = lines[r] == expected[r];
+            }
+            Check(same, std::format("LineIndex at {} with a {} byte separator", CpuFeatures::Name(level),
+                                    separator.size()));
+        }
+    }
+}
+
+void CheckTranslate(IsaLevel level) {
+    CpuFeatures::Select(level);
+    // Every length around the 4 and 2 position blocks, so each tail is taken
+    for (std::size_t count{0}; count < 12; ++count) {
+        std::vector<Pos2D> positions(count);
+        std::vector<Vec2D> offsets(count);
+        std::vector<Pos2D> expected(count);
+        for (std::size_t p{0}; p < count; ++p) {
+            const auto coordinate = [] { return static_cast<int32_t>(rng() % 2001) - 1000; };
+            positions[p]          = Pos2D{coordinate(), coordinate()};
+            offsets[p]            = Vec2D{coordinate(), coordinate()};
+            expected[p]           = Pos2D{positions[p][0] + offsets[p][0], positions[p][1] + offsets[p][1]};
+        }
+        Translate(positions, offsets);
+        Check(positions == expected, std::format("Translate of {} positions at {}", count, CpuFeatures::Name(level)));
+    }
+}
+
+} // namespace
+
+int main() {
+    for (const IsaLevel level : {IsaLevel::SCALAR, IsaLevel::AVX2, IsaLevel::AVX512}) {
+        if (level > CpuFeatures::Supported()) {
+            std::cout << "Skipping " << CpuFeatures::Name(level) << ", this processor doesn't support it\n";
+            continue;
+        }
+        CpuFeatures::Select(level);
+        CheckBitTricks(level);
+        CheckBulkParse(level);
+        CheckLineIndex(level);
+        CheckTranslate(level);
+    }
+    if (failures != 0) {
+        std::cerr << failures << " checks failed\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,83 @@
+#include "LineIndex.hpp"
+
+#include <immintrin.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#include "Attr.hpp"
+#include "CpuFeatures.hpp"
+
+namespace {
+
+/// <summary>
+/// Appends the offset after every separator in the whole 32 byte blocks of text and returns the position the scalar
+/// search resumes at. Blocks compare the first and last separator byte at every position, the middle is checked per
+/// candidate.
+/// </summary>
+[[attr_target("avx2")]] std::size_t FindSeparatorsAvx2(std::string_view text, std::string_view separator,
+                                                       std::vector<uint32_t>& offsets) {
+    constexpr std::size_t BLOCK_SIZE = 32;
+    // Separators don't overlap, a match must start at or after nextMatch
+    std::size_t nextMatch{0};
+    const __m256i first = _mm256_set1_epi8(separator.front());
+    const __m256i last  = _mm256_set1_epi8(separator.back());
+    std::size_t base{0};
+    for (; base + BLOCK_SIZE + separator.size() - 1 <= text.size(); base += BLOCK_SIZE) {
+        const char* block     = text.data() + base;
+        const __m256i firsts  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+        const __m256i lasts   = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + separator.size() - 1));
+        const __m256i matches = _mm256_and_si256(_mm256_cmpeq_epi8(firsts, first), _mm256_cmpeq_epi8(lasts, last));
+        for (auto candidates = static_cast<uint32_t>(_mm256_movemask_epi8(matches)); candidates != 0;
+             candidates &= candidates - 1) {
+            const std::size_t match = base + static_cast<std::size_t>(std::countr_zero(candidates));
+            if (match < nextMatch) {
+                continue;
+            }
+            if (separator.size() > 2 &&
+                std::memcmp(text.data() + match + 1, separator.data() + 1, separator.size() - 2) != 0) {
+                continue;
+            }
+            nextMatch = match + separator.size();
+            offsets.push_back(static_cast<uint32_t>(nextMatch));
+        }
+    }
+    return std::max(nextMatch, base);
+}
+
+} // namespace
+
+LineIndex::LineIndex(std::string_view input, char separator) : text{input}, separatorSize{1} {
+    build({&separator, 1});
+}
+
+LineIndex::LineIndex(std::string_view input, std::string_view separator)
+    : text{input}, separatorSize{static_cast<uint32_t>(separator.size())} {
+    if (separator.empty()) {
+        throw std::invalid_argument{"LineIndex separator is empty"};
+    }
+    build(separator);
+}
+
+void LineIndex::build(std::string_view separator) {
+    if (text.size() + separator.size() > std::numeric_limits<uint32_t>::max()) {
+        throw std::length_error{"LineIndex offsets are 32 bit"};
+    }
+    offsets.push_back(0);
+    // Where the scalar search starts, past whatever the block search covered
+    std::size_t nextMatch{0};
+    if (CpuFeatures::Active() >= IsaLevel::AVX2) {
+        nextMatch = FindSeparatorsAvx2(text, separator, offsets);
+    }
+    for (std::size_t match = text.find(separator, nextMatch); match != text.npos;
+         match = text.find(separator, match + separator.size())) {
+        offsets.push_back(static_cast<uint32_t>(match + separator.size()));
+    }
+    // A trailing separator already closed the last record
+    if (offsets.back() != text.size()) {
+        offsets.push_back(static_cast<uint32_t>(text.size() + separator.size()));
+    }
+}
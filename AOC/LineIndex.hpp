@@ -0,0 +1,86 @@
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/// Line and record index
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string_view>
+#include <vector>
+
+/// <summary>
+/// Splits text on a separator in one pass and keeps the record offsets, so records can be visited in any order or
+/// handed out in blocks. Matches Split: empty records are kept, except after a trailing separator.
+/// </summary>
+class LineIndex {
+public:
+    class Iterator {
+    public:
+        using iterator_concept  = std::random_access_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+        using value_type        = std::string_view;
+        using difference_type   = std::ptrdiff_t;
+
+        Iterator() = default;
+        Iterator(const LineIndex* lineIndex, std::size_t position) noexcept : index{lineIndex}, record{position} {}
+
+        std::string_view operator*() const noexcept { return (*index)[record]; }
+        std::string_view operator[](difference_type n) const noexcept { return (*index)[record + n]; }
+
+        Iterator& operator++() noexcept {
+            ++record;
+            return *this;
+        }
+        Iterator operator++(int) noexcept { return {index, record++}; }
+        Iterator& operator--() noexcept {
+            --record;
+            return *this;
+        }
+        Iterator operator--(int) noexcept { return {index, record--}; }
+        Iterator& operator+=(difference_type n) noexcept {
+            record += n;
+            return *this;
+        }
+        Iterator& operator-=(difference_type n) noexcept {
+            record -= n;
+            return *this;
+        }
+
+        friend Iterator operator+(Iterator it, difference_type n) noexcept { return it += n; }
+        friend Iterator operator+(difference_type n, Iterator it) noexcept { return it += n; }
+        friend Iterator operator-(Iterator it, difference_type n) noexcept { return it -= n; }
+        friend difference_type operator-(const Iterator& lhs, const Iterator& rhs) noexcept {
+            return static_cast<difference_type>(lhs.record) - static_cast<difference_type>(rhs.record);
+        }
+        friend bool operator==(const Iterator& lhs, const Iterator& rhs) noexcept { return lhs.record == rhs.record; }
+        friend auto operator<=>(const Iterator& lhs, const Iterator& rhs) noexcept { return lhs.record <=> rhs.record; }
+
+    private:
+        const LineIndex* index{nullptr};
+        std::size_t record{0};
+    };
+
+    explicit LineIndex(std::string_view input, char separator = '\n');
+    explicit LineIndex(std::string_view input, std::string_view separator);
+
+    std::size_t size() const noexcept { return offsets.size() - 1; }
+    bool empty() const noexcept { return size() == 0; }
+
+    std::string_view operator[](std::size_t record) const noexcept {
+        return text.substr(offsets[record], offsets[record + 1] - separatorSize - offsets[record]);
+    }
+
+    Iterator begin() const noexcept { return {this, 0}; }
+    Iterator end() const noexcept { return {this, size()}; }
+
+private:
+    std::string_view text;
+    /// Start of every record, then one past the separator that would follow the last one
+    std::vector<uint32_t> offsets;
+    uint32_t separatorSize;
+
+    void build(std::string_view separator);
+};
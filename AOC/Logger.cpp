@@ -0,0 +1,147 @@
+#include "Logger.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <thread>
+
+Logger logger;
+thread_local std::string_view Logger::context;
+thread_local bool Logger::muted;
+
+namespace {
+
+constexpr std::array<std::string_view, 3> LEVEL_STYLES{"", "\x1b[36m", "\x1b[92m"};
+constexpr std::array<std::string_view, 3> LEVEL_NAMES{"info", "perf", "solution"};
+
+} // namespace
+
+void AppendJsonString(std::string& out, std::string_view text) {
+    out += '"';
+    for (const char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            std::format_to(std::back_inserter(out), "\\u{:04x}", static_cast<unsigned>(c));
+        } else {
+            out += c;
+        }
+    }
+    out += '"';
+}
+
+/// Hands the calling thread a ring for its lifetime, rings of exited threads are reused by new ones
+struct Logger::RingLease {
+    Ring* ring;
+
+    explicit RingLease(Logger& owner) {
+        const std::lock_guard flushLock{owner.flushMutex};
+        const auto orphan = std::ranges::find_if(owner.rings, [](const std::unique_ptr<Ring>& candidate) {
+            return !candidate->owned.load(std::memory_order_acquire);
+        });
+        if (orphan != owner.rings.end()) {
+            ring = orphan->get();
+            ring->owned.store(true, std::memory_order_relaxed);
+        } else {
+            ring = owner.rings.emplace_back(std::make_unique<Ring>()).get();
+        }
+    }
+
+    RingLease(const RingLease&)            = delete;
+    RingLease& operator=(const RingLease&) = delete;
+
+    ~RingLease() { ring->owned.store(false, std::memory_order_release); }
+};
+
+Logger::Logger() {
+    rings.reserve(std::max(1u, std::thread::hardware_concurrency()));
+}
+
+Logger::~Logger() = default;
+
+Logger::Ring& Logger::threadRing() {
+    thread_local const RingLease lease{*this};
+    return *lease.ring;
+}
+
+void Logger::appendLine(std::string& out, const RecordHeader& header, const std::byte* payload) const {
+    const auto formatMessage = [&](std::string& message) {
+        try {
+            header.formatter(header.fmt, payload, message);
+        } catch (const std::format_error& e) {
+            // Specs are checked against the logged types, eagerly formatted arguments may no longer accept them
+            std::format_to(std::back_inserter(message), "<{}: {}>", header.fmt, e.what());
+        }
+    };
+
+    if (header.level == LogLevel::SOLUTION && options.solutionSink) {
+        std::string message;
+        formatMessage(message);
+        options.solutionSink(header.context, message);
+        if (options.quietSolutions) {
+            return;
+        }
+    }
+    if (options.format == LogFormat::JSON) {
+        std::string message;
+        formatMessage(message);
+        std::format_to(std::back_inserter(out), R"({{"sequence":{},"level":"{}","context":)", header.sequence,
+                       LEVEL_NAMES[static_cast<std::size_t>(header.level)]);
+        AppendJsonString(out, header.context);
+        out += R"(,"message":)";
+        AppendJsonString(out, message);
+        out += "}\n";
+        return;
+    }
+    out += LEVEL_STYLES[static_cast<std::size_t>(header.level)];
+    if (!header.context.empty()) {
+        std::format_to(std::back_inserter(out), "[{}] ", header.context);
+    }
+    formatMessage(out);
+    out += "\x1b[0m\n";
+}
+
+void Logger::writeOversized(const RecordHeader& header, const std::byte* payload) {
+    flush();
+    std::string line;
+    appendLine(line, header, payload);
+    const std::lock_guard flushLock{flushMutex};
+    std::fwrite(line.data(), sizeof(char), line.size(), stdout);
+}
+
+void Logger::flush() {
+    struct PendingRecord {
+        uint64_t sequence;
+        const std::byte* record;
+    };
+
+    const std::lock_guard flushLock{flushMutex};
+    std::vector<PendingRecord> pending;
+    std::vector<uint64_t> heads(rings.size());
+    for (std::size_t r{0}; r < rings.size(); ++r) {
+        Ring& ring = *rings[r];
+        heads[r]   = ring.head.load(std::memory_order_acquire);
+        for (uint64_t position = ring.tail.load(std::memory_order_relaxed); position < heads[r];) {
+            RecordHeader header;
+            std::memcpy(&header, ring.slot(position), sizeof(header));
+            if (header.formatter) {
+                pending.push_back({header.sequence, ring.slot(position)});
+            }
+            position += header.slotCount;
+        }
+    }
+    // Threads log into separate rings, the global sequence restores the order lines were logged in
+    std::ranges::sort(pending, {}, &PendingRecord::sequence);
+
+    std::string out;
+    for (const PendingRecord& record : pending) {
+        RecordHeader header;
+        std::memcpy(&header, record.record, sizeof(header));
+        appendLine(out, header, record.record + PAYLOAD_OFFSET);
+    }
+    std::fwrite(out.data(), sizeof(char), out.size(), stdout);
+
+    for (std::size_t r{0}; r < rings.size(); ++r) {
+        rings[r]->tail.store(heads[r], std::memory_order_release);
+    }
+}
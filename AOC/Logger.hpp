@@ -0,0 +1,348 @@
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/// Deferred formatting logger
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <range/v3/algorithm/copy.hpp>
+#include <range/v3/iterator/operations.hpp>
+#include <range/v3/range/concepts.hpp>
+#include <range/v3/range/traits.hpp>
+
+enum class LogLevel : uint8_t { INFO, PERF, SOLUTION };
+
+/// TEXT writes ANSI coloured lines, JSON writes one object per line for scripts comparing runs
+enum class LogFormat : uint8_t { TEXT, JSON };
+
+#ifndef AOC_MIN_LOG_LEVEL
+#define AOC_MIN_LOG_LEVEL 0
+#endif
+
+/// Lines below this level compile to nothing, see the AOC_MIN_LOG_LEVEL CMake cache variable
+inline constexpr LogLevel MIN_LOG_LEVEL{AOC_MIN_LOG_LEVEL};
+
+namespace LogDetail {
+
+constexpr std::size_t AlignOffset(std::size_t offset, std::size_t alignment) {
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+template <typename T>
+concept StringLike = std::convertible_to<T&, std::string_view> ||
+                     (ranges::input_range<T&> && std::same_as<ranges::range_value_t<T&>, char>);
+
+/// Copied byte for byte into the record. Ranges and pointers are excluded as they would dangle by the time the
+/// line is formatted.
+template <typename T>
+concept StoredInPlace = std::is_trivially_copyable_v<T> && !std::is_pointer_v<T> && !ranges::range<T&>;
+
+template <typename T>
+concept StoredAsSpan = !StringLike<T> && ranges::forward_range<T&> &&
+                       StoredInPlace<std::remove_cv_t<ranges::range_value_t<T&>>>;
+
+template <typename T>
+concept Encodable = StringLike<T> || StoredInPlace<std::remove_cv_t<T>> || StoredAsSpan<T>;
+
+/// Anything that can't be copied into a record is formatted on the spot instead
+template <typename T>
+decltype(auto) Prepare(T& value) {
+    if constexpr (Encodable<T>) {
+        return (value);
+    } else {
+        return std::format("{}", value);
+    }
+}
+
+template <typename T>
+struct Codec;
+
+template <typename T>
+    requires StringLike<T>
+struct Codec<T> {
+    using Decoded = std::string_view;
+
+    static std::size_t Size(T& value) {
+        if constexpr (std::convertible_to<T&, std::string_view>) {
+            return std::string_view{value}.size();
+        } else {
+            return static_cast<std::size_t>(ranges::distance(value));
+        }
+    }
+
+    static std::size_t Layout(std::size_t offset, T& value) {
+        return AlignOffset(offset, alignof(std::size_t)) + sizeof(std::size_t) + Size(value);
+    }
+
+    static std::size_t Encode(std::byte* payload, std::size_t offset, T& value) {
+        const std::size_t size = Size(value);
+        offset                 = AlignOffset(offset, alignof(std::size_t));
+        std::memcpy(payload + offset, &size, sizeof(size));
+        offset += sizeof(size);
+        if constexpr (std::convertible_to<T&, std::string_view>) {
+            std::memcpy(payload + offset, std::string_view{value}.data(), size);
+        } else {
+            ranges::copy(value, reinterpret_cast<char*>(payload + offset));
+        }
+        return offset + size;
+    }
+
+    static Decoded Decode(const std::byte* payload, std::size_t& offset) {
+        std::size_t size{};
+        offset = AlignOffset(offset, alignof(std::size_t));
+        std::memcpy(&size, payload + offset, sizeof(size));
+        offset += sizeof(size);
+        const Decoded decoded{reinterpret_cast<const char*>(payload + offset), size};
+        offset += size;
+        return decoded;
+    }
+};
+
+template <typename T>
+    requires StoredInPlace<std::remove_cv_t<T>>
+struct Codec<T> {
+    using Decoded = std::remove_cv_t<T>;
+
+    static std::size_t Layout(std::size_t offset, T&) {
+        return AlignOffset(offset, alignof(Decoded)) + sizeof(Decoded);
+    }
+
+    static std::size_t Encode(std::byte* payload, std::size_t offset, T& value) {
+        offset = AlignOffset(offset, alignof(Decoded));
+        std::memcpy(payload + offset, std::addressof(value), sizeof(Decoded));
+        return offset + sizeof(Decoded);
+    }
+
+    static Decoded Decode(const std::byte* payload, std::size_t& offset) {
+        std::array<std::byte, sizeof(Decoded)> bytes;
+        offset = AlignOffset(offset, alignof(Decoded));
+        std::memcpy(bytes.data(), payload + offset, sizeof(Decoded));
+        offset += sizeof(Decoded);
+        return std::bit_cast<Decoded>(bytes);
+    }
+};
+
+template <typename T>
+    requires StoredAsSpan<T>
+struct Codec<T> {
+    using Element = std::remove_cv_t<ranges::range_value_t<T&>>;
+    using Decoded = std::span<const Element>;
+
+    static std::size_t Layout(std::size_t offset, T& value) {
+        const auto count = static_cast<std::size_t>(ranges::distance(value));
+        offset           = AlignOffset(offset, alignof(std::size_t)) + sizeof(std::size_t);
+        return AlignOffset(offset, alignof(Element)) + count * sizeof(Element);
+    }
+
+    static std::size_t Encode(std::byte* payload, std::size_t offset, T& value) {
+        const auto count = static_cast<std::size_t>(ranges::distance(value));
+        offset           = AlignOffset(offset, alignof(std::size_t));
+        std::memcpy(payload + offset, &count, sizeof(count));
+        offset = AlignOffset(offset + sizeof(count), alignof(Element));
+        for (const Element element : value) {
+            std::memcpy(payload + offset, std::addressof(element), sizeof(Element));
+            offset += sizeof(Element);
+        }
+        return offset;
+    }
+
+    static Decoded Decode(const std::byte* payload, std::size_t& offset) {
+        std::size_t count{};
+        offset = AlignOffset(offset, alignof(std::size_t));
+        std::memcpy(&count, payload + offset, sizeof(count));
+        offset = AlignOffset(offset + sizeof(count), alignof(Element));
+        const Decoded decoded{std::launder(reinterpret_cast<const Element*>(payload + offset)), count};
+        offset += count * sizeof(Element);
+        return decoded;
+    }
+};
+
+template <typename... Prepared>
+struct RecordFormatter {
+    static void Format(std::string_view fmt, const std::byte* payload, std::string& out) {
+        [[maybe_unused]] std::size_t offset{0};
+        // Braced initialization decodes in argument order
+        std::tuple<typename Codec<Prepared>::Decoded...> decoded{Codec<Prepared>::Decode(payload, offset)...};
+        std::apply(
+            [&](auto&... values) {
+                std::vformat_to(std::back_inserter(out), fmt, std::make_format_args(values...));
+            },
+            decoded);
+    }
+};
+
+} // namespace LogDetail
+
+/// <summary>
+/// Log lines are encoded as fixed-size binary records into a ring buffer owned by the logging thread and only
+/// formatted by flush(). Logging takes no lock, only flush() and the first line from a new thread do.
+/// </summary>
+class Logger {
+    struct RecordHeader {
+        using Formatter = void (*)(std::string_view fmt, const std::byte* payload, std::string& out);
+
+        Formatter formatter{nullptr}; // nullptr marks padding up to the end of the ring
+        std::string_view fmt{};
+        std::string_view context{};
+        uint64_t sequence{0};
+        uint32_t slotCount{0};
+        LogLevel level{LogLevel::INFO};
+    };
+
+    static constexpr std::size_t SLOT_SIZE  = 64;
+    static constexpr std::size_t SLOT_COUNT = 2048;
+    /// <summary>
+    /// Largest record the ring takes, bigger ones are written by writeOversized. A record that doesn't fit before the
+    /// end of the ring starts over at the front. That fits a flushed ring only if the record is no larger than the
+    /// slots before the write position, which holds wherever that is once records take at most half the ring.
+    /// </summary>
+    static constexpr std::size_t MAX_RECORD_SLOTS = SLOT_COUNT / 2;
+    static constexpr std::size_t PAYLOAD_OFFSET =
+        LogDetail::AlignOffset(sizeof(RecordHeader), alignof(std::max_align_t));
+
+    /// Single producer (the owning thread), single consumer (flush under flushMutex)
+    struct alignas(SLOT_SIZE) Ring {
+        std::atomic<uint64_t> head{0};
+        std::atomic<bool> owned{true};
+        alignas(SLOT_SIZE) std::atomic<uint64_t> tail{0};
+        alignas(SLOT_SIZE) std::array<std::byte, SLOT_SIZE * SLOT_COUNT> slots;
+
+        std::byte* slot(uint64_t position) noexcept { return slots.data() + (position % SLOT_COUNT) * SLOT_SIZE; }
+
+        template <typename Encode>
+        bool tryPush(uint32_t slotCount, Encode&& encode) {
+            const uint64_t headPosition = head.load(std::memory_order_relaxed);
+            const uint64_t tailPosition = tail.load(std::memory_order_acquire);
+            const uint64_t index        = headPosition % SLOT_COUNT;
+            // Records are contiguous, so one that would wrap starts over at the front of the ring
+            const uint64_t padding = (index + slotCount > SLOT_COUNT) ? SLOT_COUNT - index : 0;
+            if (SLOT_COUNT - (headPosition - tailPosition) < padding + slotCount) {
+                return false;
+            }
+            if (padding != 0) {
+                const RecordHeader paddingHeader{.formatter = nullptr, .slotCount = static_cast<uint32_t>(padding)};
+                std::memcpy(slot(headPosition), &paddingHeader, sizeof(paddingHeader));
+            }
+            encode(slot(headPosition + padding));
+            head.store(headPosition + padding + slotCount, std::memory_order_release);
+            return true;
+        }
+    };
+
+    struct RingLease;
+
+    std::mutex flushMutex;
+    std::vector<std::unique_ptr<Ring>> rings;
+    std::atomic<uint64_t> nextSequence{0};
+
+    Ring& threadRing();
+    void writeOversized(const RecordHeader& header, const std::byte* payload);
+    void appendLine(std::string& out, const RecordHeader& header, const std::byte* payload) const;
+
+    template <typename... Prepared>
+    void push(LogLevel level, std::string_view fmt, Prepared&... prepared) {
+        std::size_t payloadSize{0};
+        ((payloadSize = LogDetail::Codec<Prepared>::Layout(payloadSize, prepared)), ...);
+        const RecordHeader header{
+            .formatter = &LogDetail::RecordFormatter<Prepared...>::Format,
+            .fmt       = fmt,
+            .context   = context,
+            .sequence  = nextSequence.fetch_add(1, std::memory_order_relaxed),
+            .slotCount = static_cast<uint32_t>(DivCeilSlots(PAYLOAD_OFFSET + payloadSize)),
+            .level     = level,
+        };
+        const auto encode = [&](std::byte* record) {
+            std::memcpy(record, &header, sizeof(header));
+            [[maybe_unused]] std::size_t offset{0};
+            ((offset = LogDetail::Codec<Prepared>::Encode(record + PAYLOAD_OFFSET, offset, prepared)), ...);
+        };
+        if (header.slotCount > MAX_RECORD_SLOTS) [[unlikely]] {
+            auto record = std::make_unique<std::max_align_t[]>(DivCeilSlots(PAYLOAD_OFFSET + payloadSize) *
+                                                               SLOT_SIZE / sizeof(std::max_align_t));
+            encode(reinterpret_cast<std::byte*>(record.get()));
+            writeOversized(header, reinterpret_cast<const std::byte*>(record.get()) + PAYLOAD_OFFSET);
+            return;
+        }
+        Ring& ring = threadRing();
+        // At most twice, a flush empties the ring and MAX_RECORD_SLOTS fits an empty ring
+        while (!ring.tryPush(header.slotCount, encode)) [[unlikely]] {
+            flush();
+        }
+    }
+
+    template <LogLevel level, typename... Args>
+    void addLogline(std::format_string<Args...> fmt, Args&&... args) {
+        if constexpr (level >= MIN_LOG_LEVEL) {
+            // Quiet solutions still reach the sink, only their lines are dropped at flush
+            if (muted || (level == LogLevel::SOLUTION && options.quietSolutions && !options.solutionSink)) {
+                return;
+            }
+            // Prepared arguments are bound here so eagerly formatted strings live until push returns
+            [&](auto&&... prepared) { push(level, fmt.get(), prepared...); }(LogDetail::Prepare(args)...);
+        }
+    }
+
+    static constexpr std::size_t DivCeilSlots(std::size_t bytes) { return (bytes + SLOT_SIZE - 1) / SLOT_SIZE; }
+
+public:
+    struct Options {
+        LogFormat format{LogFormat::TEXT};
+        /// Drops solution lines, for runs that only compare timings
+        bool quietSolutions{false};
+        /// Sees every solution line once formatted, called by flush() in the order the lines were logged
+        void (*solutionSink)(std::string_view context, std::string_view message){nullptr};
+    };
+
+    /// Prefixed to every line logged from the current thread so interleaved days can be told apart
+    static thread_local std::string_view context;
+    /// Drops every line logged from the current thread, used while benchmark iterations repeat a section
+    static thread_local bool muted;
+
+    explicit Logger();
+    ~Logger();
+
+    /// Not synchronized with logging threads, call before the first line is logged
+    void configure(const Options& newOptions) noexcept { options = newOptions; }
+
+    void flush();
+
+    template <typename... Args>
+    void info(std::format_string<Args...> fmt, Args&&... args) {
+        addLogline<LogLevel::INFO>(fmt, std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    void perf(std::format_string<Args...> fmt, Args&&... args) {
+        addLogline<LogLevel::PERF>(fmt, std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    void solution(std::format_string<Args...> fmt, Args&&... args) {
+        addLogline<LogLevel::SOLUTION>(fmt, std::forward<Args>(args)...);
+    }
+
+private:
+    Options options{};
+};
+
+extern Logger logger;
+
+/// Appends text as a quoted JSON string
+void AppendJsonString(std::string& out, std::string_view text);
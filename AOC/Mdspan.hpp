@@ -1,15 +1,26 @@
 #pragma once
 
 #include "Attr.hpp"
+#include "CpuFeatures.hpp"
+#include "Fnv.hpp"
+
+#include <immintrin.h>
 
 #include <mdspan/mdarray.hpp>
 #include <mdspan/mdspan.hpp>
 
 #include <algorithm>
 #include <array>
+#include <bit>
+#include <climits>
+#include <cstdint>
 #include <functional>
+#include <optional>
 #include <ranges>
+#include <span>
+#include <string_view>
 #include <utility>
+#include <vector>
 
 using namespace Kokkos;
 using Kokkos::Experimental::layout_left_padded;
@@ -36,9 +47,105 @@ struct ZYX {
     }
 };
 
+namespace PosDetail {
+
+/// int32 coordinates of rank 2 and 3 fit in the low lanes of one SSE register
+template <class IndexType, std::size_t Rank>
+concept SseLanes = std::same_as<IndexType, int32_t> && (Rank == 2 || Rank == 3);
+
+template <std::size_t Rank>
+[[attr_forceinline]] inline __m128i LoadLanes(const std::array<int32_t, Rank>& a) noexcept {
+    if constexpr (Rank == 2) {
+        return _mm_loadl_epi64(reinterpret_cast<const __m128i*>(a.data()));
+    } else {
+        return _mm_setr_epi32(a[0], a[1], a[2], 0);
+    }
+}
+
+template <std::size_t Rank>
+[[attr_forceinline]] inline void StoreLanes(std::array<int32_t, Rank>& a, __m128i lanes) noexcept {
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(a.data()), lanes);
+    if constexpr (Rank == 3) {
+        a[2] = _mm_cvtsi128_si32(_mm_unpackhi_epi64(lanes, lanes));
+    }
+}
+
+/// True when the comparison mask is set in each of the first Rank lanes
+template <std::size_t Rank>
+[[attr_forceinline]] inline bool AllLanes(__m128i mask) noexcept {
+    constexpr int ALL = (1 << Rank) - 1;
+    return (_mm_movemask_ps(_mm_castsi128_ps(mask)) & ALL) == ALL;
+}
+
+/// lhs < rhs as unsigned, so a negative coordinate is never below an extent
+[[attr_forceinline]] inline __m128i LessUnsigned(__m128i lhs, __m128i rhs) noexcept {
+    const __m128i signBit = _mm_set1_epi32(INT32_MIN);
+    return _mm_cmplt_epi32(_mm_xor_si128(lhs, signBit), _mm_xor_si128(rhs, signBit));
+}
+
+[[attr_forceinline]] inline __m128i MinLanes(__m128i a, __m128i b) noexcept {
+#ifdef __SSE4_1__
+    return _mm_min_epi32(a, b);
+#else
+    const __m128i aGreater = _mm_cmpgt_epi32(a, b);
+    return _mm_or_si128(_mm_and_si128(aGreater, b), _mm_andnot_si128(aGreater, a));
+#endif
+}
+
+[[attr_forceinline]] inline __m128i MaxLanes(__m128i a, __m128i b) noexcept {
+#ifdef __SSE4_1__
+    return _mm_max_epi32(a, b);
+#else
+    const __m128i aGreater = _mm_cmpgt_epi32(a, b);
+    return _mm_or_si128(_mm_and_si128(aGreater, a), _mm_andnot_si128(aGreater, b));
+#endif
+}
+
+/// dst[r] = scalarOp(dst[r], src[r]) for every r, as one laneOp on an SSE register where the type allows it
+template <class IndexType, std::size_t Rank, class LaneOp, class ScalarOp>
+[[attr_forceinline]] constexpr void Combine(std::array<IndexType, Rank>& dst, const std::array<IndexType, Rank>& src,
+                                            LaneOp laneOp, ScalarOp scalarOp) noexcept {
+    if constexpr (SseLanes<IndexType, Rank>) {
+        if (!std::is_constant_evaluated()) {
+            StoreLanes<Rank>(dst, laneOp(LoadLanes<Rank>(dst), LoadLanes<Rank>(src)));
+            return;
+        }
+    }
+    for (std::size_t r{0}; r < Rank; ++r) {
+        dst[r] = static_cast<IndexType>(scalarOp(dst[r], src[r]));
+    }
+}
+
+template <class IndexType, std::size_t Rank>
+constexpr std::array<IndexType, Rank> Broadcast(IndexType scalar) noexcept {
+    std::array<IndexType, Rank> broadcast;
+    broadcast.fill(scalar);
+    return broadcast;
+}
+
+inline constexpr auto ADD_LANES = [](__m128i a, __m128i b) { return _mm_add_epi32(a, b); };
+inline constexpr auto SUB_LANES = [](__m128i a, __m128i b) { return _mm_sub_epi32(a, b); };
+
+} // namespace PosDetail
+
 template <class IndexType, size_t Rank>
 struct Vec : std::array<IndexType, Rank>, ZYX {
     using Base = std::array<IndexType, Rank>;
+
+    [[attr_forceinline]] constexpr Vec& operator+=(const Vec& vec) noexcept {
+        PosDetail::Combine(*this, vec, PosDetail::ADD_LANES, std::plus{});
+        return *this;
+    }
+    [[attr_forceinline]] constexpr Vec& operator-=(const Vec& vec) noexcept {
+        PosDetail::Combine(*this, vec, PosDetail::SUB_LANES, std::minus{});
+        return *this;
+    }
+    [[attr_forceinline]] constexpr Vec& operator*=(IndexType scalar) noexcept {
+        for (IndexType& vecE : *this) {
+            vecE *= scalar;
+        }
+        return *this;
+    }
 };
 
 template <class IndexType, size_t Rank>
@@ -49,29 +156,21 @@ struct Pos : std::array<IndexType, Rank>, ZYX {
     // Pos(const extents<IndexType, Extents...>& extents) noexcept : Base{} {
     // }
 
-    [[attr_forceinline]]  constexpr Pos& operator+=(IndexType scalar) noexcept {
-        for (IndexType& posE : *this) {
-            posE += scalar;
-        }
+    [[attr_forceinline]] constexpr Pos& operator+=(IndexType scalar) noexcept {
+        PosDetail::Combine(*this, PosDetail::Broadcast<IndexType, Rank>(scalar), PosDetail::ADD_LANES, std::plus{});
         return *this;
     }
     [[attr_forceinline]] constexpr Pos& operator-=(IndexType scalar) noexcept {
-        for (IndexType& posE : *this) {
-            posE -= scalar;
-        }
+        PosDetail::Combine(*this, PosDetail::Broadcast<IndexType, Rank>(scalar), PosDetail::SUB_LANES, std::minus{});
         return *this;
     }
 
     [[attr_forceinline]] constexpr Pos& operator+=(const Vec<IndexType, Rank>& vec) noexcept {
-        for (size_t r{0}; r < Rank; ++r) {
-            (*this)[r] += vec[r];
-        }
+        PosDetail::Combine(*this, vec, PosDetail::ADD_LANES, std::plus{});
         return *this;
     }
     [[attr_forceinline]] constexpr Pos& operator-=(const Vec<IndexType, Rank>& vec) noexcept {
-        for (size_t r{0}; r < Rank; ++r) {
-            (*this)[r] -= vec[r];
-        }
+        PosDetail::Combine(*this, vec, PosDetail::SUB_LANES, std::minus{});
         return *this;
     }
 };
@@ -84,43 +183,147 @@ template <class IndexType, size_t Rank>
     return result;
 }
 
+template <class IndexType, size_t Rank>
+[[nodiscard, attr_forceinline]] constexpr Pos<IndexType, Rank> operator-(const Pos<IndexType, Rank>& lhs,
+                                                       const Vec<IndexType, Rank>& rhs) noexcept {
+    Pos<IndexType, Rank> result{lhs};
+    result -= rhs;
+    return result;
+}
+
 template <class IndexType, size_t Rank>
 [[nodiscard, attr_forceinline]] constexpr Vec<IndexType, Rank> operator-(const Pos<IndexType, Rank>& lhs,
                                                         const Pos<IndexType, Rank>& rhs) noexcept {
-    Vec<IndexType, Rank> result;
-    for (size_t r{0}; r < Rank; ++r) {
-        result[r] = lhs[r] - rhs[r];
-    }
+    Vec<IndexType, Rank> result{static_cast<const std::array<IndexType, Rank>&>(lhs)};
+    PosDetail::Combine(result, rhs, PosDetail::SUB_LANES, std::minus{});
     return result;
 }
 
 template <class IndexType, size_t Rank>
-[[nodiscard, attr_forceinline]] constexpr bool operator<(const Pos<IndexType, Rank>& lhs, const Pos<IndexType, Rank>& rhs) noexcept {
-    return std::ranges::fold_left(std::views::zip_transform(std::less{}, lhs, rhs), true, std::bit_and{});
+[[nodiscard, attr_forceinline]] constexpr Vec<IndexType, Rank> operator+(const Vec<IndexType, Rank>& lhs,
+                                                        const Vec<IndexType, Rank>& rhs) noexcept {
+    Vec<IndexType, Rank> result{lhs};
+    result += rhs;
+    return result;
 }
 
-template <class IndexType, std::size_t Rank>
-struct std::hash<Vec<IndexType, Rank>> {
-    [[nodiscard]] constexpr std::size_t operator()(const Vec<IndexType, Rank>& vec) const noexcept {
-        size_t seed = 0;
-        for (const IndexType vecE : vec) {
-            seed = HashCombine(seed, vecE);
+template <class IndexType, size_t Rank>
+[[nodiscard, attr_forceinline]] constexpr Vec<IndexType, Rank> operator*(const Vec<IndexType, Rank>& lhs,
+                                                        IndexType rhs) noexcept {
+    Vec<IndexType, Rank> result{lhs};
+    result *= rhs;
+    return result;
+}
+
+/// True when every component of lhs is below the same component of rhs
+template <class IndexType, size_t Rank>
+[[nodiscard, attr_forceinline]] constexpr bool operator<(const Pos<IndexType, Rank>& lhs,
+                                                         const Pos<IndexType, Rank>& rhs) noexcept {
+    if constexpr (PosDetail::SseLanes<IndexType, Rank>) {
+        if (!std::is_constant_evaluated()) {
+            return PosDetail::AllLanes<Rank>(
+                _mm_cmplt_epi32(PosDetail::LoadLanes<Rank>(lhs), PosDetail::LoadLanes<Rank>(rhs)));
+        }
+    }
+    for (size_t r{0}; r < Rank; ++r) {
+        if (!(lhs[r] < rhs[r])) {
+            return false;
         }
-        return seed;
     }
+    return true;
+}
+
+/// Componentwise minimum
+template <class IndexType, size_t Rank>
+[[nodiscard, attr_forceinline]] constexpr Pos<IndexType, Rank> Min(const Pos<IndexType, Rank>& lhs,
+                                                                   const Pos<IndexType, Rank>& rhs) noexcept {
+    Pos<IndexType, Rank> result{lhs};
+    PosDetail::Combine(result, rhs, PosDetail::MinLanes, [](IndexType a, IndexType b) { return std::min(a, b); });
+    return result;
+}
+
+/// Componentwise maximum
+template <class IndexType, size_t Rank>
+[[nodiscard, attr_forceinline]] constexpr Pos<IndexType, Rank> Max(const Pos<IndexType, Rank>& lhs,
+                                                                   const Pos<IndexType, Rank>& rhs) noexcept {
+    Pos<IndexType, Rank> result{lhs};
+    PosDetail::Combine(result, rhs, PosDetail::MaxLanes, [](IndexType a, IndexType b) { return std::max(a, b); });
+    return result;
+}
+
+namespace PosDetail {
+
+template <std::size_t Size>
+struct UintOfSize;
+template <>
+struct UintOfSize<1> {
+    using type = uint8_t;
+};
+template <>
+struct UintOfSize<2> {
+    using type = uint16_t;
+};
+template <>
+struct UintOfSize<4> {
+    using type = uint32_t;
+};
+template <>
+struct UintOfSize<8> {
+    using type = uint64_t;
 };
 
+template <class T>
+struct IsPosOrVec : std::false_type {};
 template <class IndexType, std::size_t Rank>
-struct std::hash<Pos<IndexType, Rank>> {
-    [[nodiscard]] constexpr std::size_t operator()(const Pos<IndexType, Rank>& pos) const noexcept {
-        size_t seed = 0;
-        for (const IndexType posE : pos) {
-            seed = HashCombine(seed, posE);
+struct IsPosOrVec<Pos<IndexType, Rank>> : std::true_type {};
+template <class IndexType, std::size_t Rank>
+struct IsPosOrVec<Vec<IndexType, Rank>> : std::true_type {};
+
+} // namespace PosDetail
+
+/// Pos or Vec whose components fit in one machine word together
+template <class T>
+concept PackableKey = PosDetail::IsPosOrVec<T>::value && std::integral<typename T::Base::value_type> &&
+                      requires { typename PosDetail::UintOfSize<sizeof(typename T::Base)>::type; };
+
+/// All components of key in one integer, equal keys pack to equal integers
+template <PackableKey Key>
+[[nodiscard, attr_forceinline]] constexpr uint64_t PackKey(const Key& key) noexcept {
+    using Packed = typename PosDetail::UintOfSize<sizeof(typename Key::Base)>::type;
+    return std::bit_cast<Packed>(static_cast<const typename Key::Base&>(key));
+}
+
+template <PackableKey Key>
+[[nodiscard, attr_forceinline]] constexpr Key UnpackKey(uint64_t packed) noexcept {
+    using Packed = typename PosDetail::UintOfSize<sizeof(typename Key::Base)>::type;
+    return Key{std::bit_cast<typename Key::Base>(static_cast<Packed>(packed))};
+}
+
+/// <summary>
+/// Hashes a Pos or Vec with one 64x64 multiply of its packed key. The high half of the product mixes every component
+/// into the bits boost::unordered picks buckets with, the low half into its tag bits. Keys too wide to pack are
+/// hashed by their bytes.
+/// </summary>
+struct PosHash {
+    using is_avalanching = std::true_type;
+
+    template <class Key>
+        requires PosDetail::IsPosOrVec<Key>::value
+    [[nodiscard, attr_forceinline]] constexpr std::size_t operator()(const Key& key) const noexcept {
+        if constexpr (PackableKey<Key>) {
+            return HashDetail::MulFold(PackKey(key), 0x9E3779B97F4A7C15);
+        } else {
+            return WyHash{}(static_cast<const typename Key::Base&>(key));
         }
-        return seed;
     }
 };
 
+template <class IndexType, std::size_t Rank>
+struct std::hash<Vec<IndexType, Rank>> : PosHash {};
+
+template <class IndexType, std::size_t Rank>
+struct std::hash<Pos<IndexType, Rank>> : PosHash {};
+
 template <class IndexType, std::size_t Rank>
 struct std::less<Pos<IndexType, Rank>> {
     [[nodiscard]] constexpr bool operator()(const Pos<IndexType, Rank>& lhs,
@@ -131,9 +334,25 @@ struct std::less<Pos<IndexType, Rank>> {
 
 template <class IndexType, std::size_t Rank>
 struct std::equal_to<Pos<IndexType, Rank>> {
-    [[nodiscard]] constexpr bool operator()(const Pos<IndexType, Rank>& lhs,
-                                            const Pos<IndexType, Rank>& rhs) const noexcept {
-        return std::ranges::equal(lhs, rhs);
+    [[nodiscard, attr_forceinline]] constexpr bool operator()(const Pos<IndexType, Rank>& lhs,
+                                                              const Pos<IndexType, Rank>& rhs) const noexcept {
+        if constexpr (PackableKey<Pos<IndexType, Rank>>) {
+            return PackKey(lhs) == PackKey(rhs);
+        } else {
+            return std::ranges::equal(lhs, rhs);
+        }
+    }
+};
+
+template <class IndexType, std::size_t Rank>
+struct std::equal_to<Vec<IndexType, Rank>> {
+    [[nodiscard, attr_forceinline]] constexpr bool operator()(const Vec<IndexType, Rank>& lhs,
+                                                              const Vec<IndexType, Rank>& rhs) const noexcept {
+        if constexpr (PackableKey<Vec<IndexType, Rank>>) {
+            return PackKey(lhs) == PackKey(rhs);
+        } else {
+            return std::ranges::equal(lhs, rhs);
+        }
     }
 };
 
@@ -193,11 +412,480 @@ template <std::size_t I, typename IndexType, std::size_t Rank>
 };
 
 template <class IndexType, size_t... Extents>
-constexpr bool InBounds(const extents<IndexType, Extents...>& extents, const Pos<IndexType, sizeof...(Extents)>& pos) {
-    for (size_t r{0}; r < sizeof...(Extents); ++r) {
-        if (pos[r] < 0 || pos[r] >= extents.extent(r)) {
+[[nodiscard, attr_forceinline]] constexpr bool InBounds(const extents<IndexType, Extents...>& extents,
+                                                        const Pos<IndexType, sizeof...(Extents)>& pos) noexcept {
+    constexpr std::size_t RANK = sizeof...(Extents);
+    if constexpr (PosDetail::SseLanes<IndexType, RANK>) {
+        if (!std::is_constant_evaluated()) {
+            std::array<IndexType, RANK> bounds;
+            for (size_t r{0}; r < RANK; ++r) {
+                bounds[r] = extents.extent(r);
+            }
+            return PosDetail::AllLanes<RANK>(
+                PosDetail::LessUnsigned(PosDetail::LoadLanes<RANK>(pos), PosDetail::LoadLanes<RANK>(bounds)));
+        }
+    }
+    // One unsigned compare per component also rejects negative coordinates
+    using Unsigned = std::make_unsigned_t<IndexType>;
+    for (size_t r{0}; r < RANK; ++r) {
+        if (static_cast<Unsigned>(pos[r]) >= static_cast<Unsigned>(extents.extent(r))) {
             return false;
         }
     }
     return true;
-}
\ No newline at end of file
+}
+
+static_assert(sizeof(Pos2D) == 8 && sizeof(Vec2D) == 8, "batch operations treat spans of Pos2D as packed int32 pairs");
+
+namespace PosDetail {
+
+/// Translates the whole groups of four positions and returns how many it did
+[[attr_target("avx2")]] inline std::size_t TranslateAvx2(std::span<Pos2D> positions,
+                                                         std::span<const Vec2D> offsets) noexcept {
+    std::size_t i{0};
+    for (; i + 4 <= positions.size(); i += 4) {
+        auto* position     = reinterpret_cast<__m256i*>(positions.data() + i);
+        const auto* offset = reinterpret_cast<const __m256i*>(offsets.data() + i);
+        _mm256_storeu_si256(position, _mm256_add_epi32(_mm256_loadu_si256(position), _mm256_loadu_si256(offset)));
+    }
+    return i;
+}
+
+} // namespace PosDetail
+
+/// positions[i] += offsets[i], four positions per instruction from AVX2 up and two below
+inline void Translate(std::span<Pos2D> positions, std::span<const Vec2D> offsets) noexcept {
+    std::size_t i{0};
+    if (CpuFeatures::Active() >= IsaLevel::AVX2) {
+        i = PosDetail::TranslateAvx2(positions, offsets);
+    }
+    for (; i + 2 <= positions.size(); i += 2) {
+        auto* position     = reinterpret_cast<__m128i*>(positions.data() + i);
+        const auto* offset = reinterpret_cast<const __m128i*>(offsets.data() + i);
+        _mm_storeu_si128(position, _mm_add_epi32(_mm_loadu_si128(position), _mm_loadu_si128(offset)));
+    }
+    for (; i < positions.size(); ++i) {
+        positions[i] += offsets[i];
+    }
+}
+
+/// <summary>
+/// Brings every component from (-bounds, 2 * bounds) back into [0, bounds), as on a torus. One compare and one
+/// masked add or subtract per lane, enough after a Translate by offsets that are already below bounds.
+/// </summary>
+inline void WrapInto(std::span<Pos2D> positions, const Vec2D& bounds) noexcept {
+    const __m128i limit = _mm_setr_epi32(bounds[0], bounds[1], bounds[0], bounds[1]);
+    const __m128i zero  = _mm_setzero_si128();
+    const auto wrap     = [&](__m128i lanes) {
+        lanes = _mm_sub_epi32(lanes, _mm_andnot_si128(_mm_cmplt_epi32(lanes, limit), limit));
+        return _mm_add_epi32(lanes, _mm_and_si128(_mm_cmplt_epi32(lanes, zero), limit));
+    };
+    std::size_t i{0};
+    for (; i + 2 <= positions.size(); i += 2) {
+        auto* position = reinterpret_cast<__m128i*>(positions.data() + i);
+        _mm_storeu_si128(position, wrap(_mm_loadu_si128(position)));
+    }
+    if (i < positions.size()) {
+        PosDetail::StoreLanes<2>(positions[i], wrap(PosDetail::LoadLanes<2>(positions[i])));
+    }
+}
+
+/// Neighbour directions of PaddedGrid::step and the grid layouts, in the order of PaddedGrid::neighborOffsets
+enum GridStep : uint8_t { STEP_UP, STEP_LEFT, STEP_RIGHT, STEP_DOWN };
+inline constexpr std::array<GridStep, 4> GRID_STEPS{STEP_UP, STEP_LEFT, STEP_RIGHT, STEP_DOWN};
+
+/// <summary>
+/// Rank 2 mdspan layout storing the grid as TileRows x TileCols tiles, each tile contiguous and the tiles in row-major
+/// order. A vertical step usually stays inside the same few cache lines, where layout_right crosses a whole row.
+/// Both tile sides are powers of two and the extents are padded up to whole tiles, so the layout isn't exhaustive.
+/// Besides the mdspan mapping interface, neighbor() steps without going through coordinates and position() inverts.
+/// </summary>
+template <int32_t TileRows, int32_t TileCols>
+struct layout_tiled {
+    static_assert(std::has_single_bit(static_cast<uint32_t>(TileRows)) &&
+                      std::has_single_bit(static_cast<uint32_t>(TileCols)),
+                  "tile sides must be powers of two");
+
+    template <class Extents>
+    class mapping {
+    public:
+        using extents_type = Extents;
+        using index_type   = typename Extents::index_type;
+        using size_type    = typename Extents::size_type;
+        using rank_type    = typename Extents::rank_type;
+        using layout_type  = layout_tiled;
+        static_assert(Extents::rank() == 2, "tiled layouts are for grids");
+
+        constexpr mapping() noexcept = default;
+        constexpr mapping(const extents_type& extents) noexcept
+            : bounds{extents}, tilesPerRow{(extents.extent(1) + TileCols - 1) / TileCols} {}
+
+        [[nodiscard]] constexpr const extents_type& extents() const noexcept { return bounds; }
+        [[nodiscard]] constexpr index_type required_span_size() const noexcept {
+            return (bounds.extent(0) + TileRows - 1) / TileRows * tilesPerRow * TILE_SIZE;
+        }
+
+        template <class IndexY, class IndexX>
+        [[nodiscard, attr_forceinline]] constexpr index_type operator()(IndexY y, IndexX x) const noexcept {
+            const auto row    = static_cast<index_type>(y);
+            const auto column = static_cast<index_type>(x);
+            return ((row / TileRows) * tilesPerRow + column / TileCols) * TILE_SIZE + (row % TileRows) * TileCols +
+                   column % TileCols;
+        }
+
+        /// Index of the cell one step away, which has to be inside the extents
+        [[nodiscard, attr_forceinline]] constexpr index_type neighbor(index_type index, GridStep step) const noexcept {
+            const index_type column = index % TileCols;
+            const index_type row    = index / TileCols % TileRows;
+            switch (step) {
+                case STEP_UP: return row != 0 ? index - TileCols : index - tileRowSize() + (TileRows - 1) * TileCols;
+                case STEP_LEFT: return column != 0 ? index - 1 : index - TILE_SIZE + (TileCols - 1);
+                case STEP_RIGHT: return column != TileCols - 1 ? index + 1 : index + TILE_SIZE - (TileCols - 1);
+                case STEP_DOWN:
+                    return row != TileRows - 1 ? index + TileCols : index + tileRowSize() - (TileRows - 1) * TileCols;
+            }
+            std::unreachable();
+        }
+
+        /// Inverse of operator(), also defined for the padding past the extents
+        [[nodiscard]] constexpr Pos<index_type, 2> position(index_type index) const noexcept {
+            const index_type tile  = index / TILE_SIZE;
+            const index_type inner = index % TILE_SIZE;
+            return {tile / tilesPerRow * TileRows + inner / TileCols, tile % tilesPerRow * TileCols + inner % TileCols};
+        }
+
+        static constexpr bool is_always_unique() noexcept { return true; }
+        static constexpr bool is_always_exhaustive() noexcept { return false; }
+        static constexpr bool is_always_strided() noexcept { return false; }
+        static constexpr bool is_unique() noexcept { return true; }
+        [[nodiscard]] constexpr bool is_exhaustive() const noexcept {
+            return required_span_size() == bounds.extent(0) * bounds.extent(1);
+        }
+        static constexpr bool is_strided() noexcept { return false; }
+
+        friend constexpr bool operator==(const mapping& lhs, const mapping& rhs) noexcept {
+            return lhs.bounds == rhs.bounds;
+        }
+
+    private:
+        static constexpr index_type TILE_SIZE = TileRows * TileCols;
+
+        extents_type bounds{};
+        index_type tilesPerRow{0};
+
+        [[nodiscard, attr_forceinline]] constexpr index_type tileRowSize() const noexcept {
+            return tilesPerRow * TILE_SIZE;
+        }
+    };
+};
+
+namespace MortonDetail {
+
+/// Bits of x, the index bits of a Morton code
+inline constexpr uint32_t X_BITS = 0x55555555;
+/// Bits of y
+inline constexpr uint32_t Y_BITS = 0xAAAAAAAA;
+
+/// Moves bit i of the low 16 bits to bit 2i
+[[nodiscard, attr_forceinline]] constexpr uint32_t Spread(uint32_t value) noexcept {
+    value = (value | (value << 8)) & 0x00FF00FF;
+    value = (value | (value << 4)) & 0x0F0F0F0F;
+    value = (value | (value << 2)) & 0x33333333;
+    return (value | (value << 1)) & X_BITS;
+}
+
+/// Inverse of Spread
+[[nodiscard, attr_forceinline]] constexpr uint32_t Compact(uint32_t value) noexcept {
+    value &= X_BITS;
+    value = (value | (value >> 1)) & 0x33333333;
+    value = (value | (value >> 2)) & 0x0F0F0F0F;
+    value = (value | (value >> 4)) & 0x00FF00FF;
+    return (value | (value >> 8)) & 0x0000FFFF;
+}
+
+} // namespace MortonDetail
+
+/// <summary>
+/// Rank 2 mdspan layout in Z-order, the bits of y and x interleaved, so cells close in both directions are close in
+/// memory at every scale without choosing a tile size. Sides up to 32768 with int32_t indices. The span reaches the
+/// Morton code of the last cell, up to about 4x the cell count when the sides are just past a power of two.
+/// Steps add to one coordinate's bits directly, the other coordinate's bits are filled with ones so carries cross them.
+/// </summary>
+struct layout_morton {
+    template <class Extents>
+    class mapping {
+    public:
+        using extents_type = Extents;
+        using index_type   = typename Extents::index_type;
+        using size_type    = typename Extents::size_type;
+        using rank_type    = typename Extents::rank_type;
+        using layout_type  = layout_morton;
+        static_assert(Extents::rank() == 2, "Morton layouts are for grids");
+
+        constexpr mapping() noexcept = default;
+        constexpr mapping(const extents_type& extents) noexcept : bounds{extents} {}
+
+        [[nodiscard]] constexpr const extents_type& extents() const noexcept { return bounds; }
+        [[nodiscard]] constexpr index_type required_span_size() const noexcept {
+            if (bounds.extent(0) == 0 || bounds.extent(1) == 0) {
+                return 0;
+            }
+            return (*this)(bounds.extent(0) - 1, bounds.extent(1) - 1) + 1;
+        }
+
+        template <class IndexY, class IndexX>
+        [[nodiscard, attr_forceinline]] constexpr index_type operator()(IndexY y, IndexX x) const noexcept {
+            return static_cast<index_type>((MortonDetail::Spread(static_cast<uint32_t>(y)) << 1) |
+                                           MortonDetail::Spread(static_cast<uint32_t>(x)));
+        }
+
+        /// Index of the cell one step away, which has to be inside the extents
+        [[nodiscard, attr_forceinline]] static constexpr index_type neighbor(index_type index, GridStep step) noexcept {
+            using namespace MortonDetail;
+            const auto code = static_cast<uint32_t>(index);
+            switch (step) {
+                case STEP_UP: return static_cast<index_type>((((code & Y_BITS) - 2) & Y_BITS) | (code & X_BITS));
+                case STEP_LEFT: return static_cast<index_type>((((code & X_BITS) - 1) & X_BITS) | (code & Y_BITS));
+                case STEP_RIGHT: return static_cast<index_type>((((code | Y_BITS) + 1) & X_BITS) | (code & Y_BITS));
+                case STEP_DOWN: return static_cast<index_type>((((code | X_BITS) + 2) & Y_BITS) | (code & X_BITS));
+            }
+            std::unreachable();
+        }
+
+        /// Inverse of operator()
+        [[nodiscard]] static constexpr Pos<index_type, 2> position(index_type index) noexcept {
+            const auto code = static_cast<uint32_t>(index);
+            return {static_cast<index_type>(MortonDetail::Compact(code >> 1)),
+                    static_cast<index_type>(MortonDetail::Compact(code))};
+        }
+
+        static constexpr bool is_always_unique() noexcept { return true; }
+        static constexpr bool is_always_exhaustive() noexcept { return false; }
+        static constexpr bool is_always_strided() noexcept { return false; }
+        static constexpr bool is_unique() noexcept { return true; }
+        [[nodiscard]] constexpr bool is_exhaustive() const noexcept {
+            return required_span_size() == bounds.extent(0) * bounds.extent(1);
+        }
+        static constexpr bool is_strided() noexcept { return false; }
+
+        friend constexpr bool operator==(const mapping& lhs, const mapping& rhs) noexcept {
+            return lhs.bounds == rhs.bounds;
+        }
+
+    private:
+        extents_type bounds{};
+    };
+};
+
+static_assert(layout_morton::mapping<dextents<int32_t, 2>>{dextents<int32_t, 2>{4, 4}}(2, 1) == 0b1001);
+static_assert(layout_morton::mapping<dextents<int32_t, 2>>::neighbor(0b0111, STEP_RIGHT) == 0b10010);
+static_assert(layout_tiled<4, 4>::mapping<dextents<int32_t, 2>>{dextents<int32_t, 2>{8, 8}}(5, 6) == 54);
+
+/// <summary>
+/// Grid stored with a halo of sentinel cells around it, so cells up to halo steps outside the interior can be read
+/// without bounds checks. Coordinates address the interior, (0, 0) is the first unpadded cell. Inner loops can work
+/// on flat indices and move with step(), or with stride() and neighborOffsets() when the layout is row-major.
+/// Layout is layout_right, layout_tiled or layout_morton, code written against step() and index() runs on any of them.
+/// </summary>
+template <class T, class Container = std::vector<T>, class Layout = layout_right>
+class PaddedGrid {
+public:
+    using Storage = mdarray<T, dextents<int32_t, 2>, Layout, Container>;
+    using Mapping = typename Storage::mapping_type;
+    static constexpr bool ROW_MAJOR = std::same_as<Layout, layout_right>;
+
+    PaddedGrid(const dextents<int32_t, 2>& interior, int32_t halo, const T& sentinel,
+               const typename Container::allocator_type& allocator = {})
+        : interiorExtents{interior}, haloWidth{halo},
+          storage{Padded(interior, halo),
+                  Container(static_cast<std::size_t>(Mapping{Padded(interior, halo)}.required_span_size()), sentinel,
+                            allocator)} {}
+
+    /// Copies the input rows into the interior, converting each cell
+    template <class Convert = std::identity>
+    static PaddedGrid FromInput(const InputGrid<const char>& input, int32_t halo, const T& sentinel,
+                                Convert convert = {}) {
+        PaddedGrid grid{input.extents(), halo, sentinel};
+        for (int32_t y{0}; y < input.extent(0); ++y) {
+            const char* row = &input(y, 0);
+            if constexpr (ROW_MAJOR) {
+                std::transform(row, row + input.extent(1), &grid(y, 0), convert);
+            } else {
+                for (int32_t x{0}; x < input.extent(1); ++x) {
+                    grid(y, x) = convert(row[x]);
+                }
+            }
+        }
+        return grid;
+    }
+
+    [[nodiscard]] const dextents<int32_t, 2>& extents() const noexcept { return interiorExtents; }
+    [[nodiscard]] int32_t extent(std::size_t r) const noexcept { return interiorExtents.extent(r); }
+    [[nodiscard]] int32_t halo() const noexcept { return haloWidth; }
+    /// Flat distance between vertically adjacent cells
+    [[nodiscard]] int32_t stride() const noexcept
+        requires ROW_MAJOR
+    {
+        return storage.extent(1);
+    }
+
+    [[nodiscard, attr_forceinline]] int32_t index(int32_t y, int32_t x) const noexcept {
+        if constexpr (ROW_MAJOR) {
+            return (y + haloWidth) * stride() + x + haloWidth;
+        } else {
+            return storage.mapping()(y + haloWidth, x + haloWidth);
+        }
+    }
+    [[nodiscard, attr_forceinline]] int32_t index(const Pos2D& pos) const noexcept { return index(pos.y(), pos.x()); }
+    [[nodiscard, attr_forceinline]] Pos2D pos(int32_t index) const noexcept {
+        if constexpr (ROW_MAJOR) {
+            return {index / stride() - haloWidth, index % stride() - haloWidth};
+        } else {
+            const Pos2D padded = storage.mapping().position(index);
+            return {padded.y() - haloWidth, padded.x() - haloWidth};
+        }
+    }
+    /// Flat index of the neighbour in direction step, inside the halo at most
+    [[nodiscard, attr_forceinline]] int32_t step(int32_t index, GridStep direction) const noexcept {
+        if constexpr (ROW_MAJOR) {
+            return index + neighborOffsets()[direction];
+        } else {
+            return storage.mapping().neighbor(index, direction);
+        }
+    }
+    [[nodiscard, attr_forceinline]] int32_t offset(const Vec2D& vec) const noexcept
+        requires ROW_MAJOR
+    {
+        return vec.y() * stride() + vec.x();
+    }
+    /// Flat offsets to the up, left, right and down neighbours
+    [[nodiscard]] std::array<int32_t, 4> neighborOffsets() const noexcept
+        requires ROW_MAJOR
+    {
+        return {-stride(), -1, 1, stride()};
+    }
+
+    [[attr_forceinline]] T& operator[](int32_t index) noexcept { return storage.data()[index]; }
+    [[attr_forceinline]] const T& operator[](int32_t index) const noexcept { return storage.data()[index]; }
+    [[attr_forceinline]] T& operator()(int32_t y, int32_t x) noexcept { return (*this)[index(y, x)]; }
+    [[attr_forceinline]] const T& operator()(int32_t y, int32_t x) const noexcept { return (*this)[index(y, x)]; }
+    [[attr_forceinline]] T& operator()(const Pos2D& pos) noexcept { return (*this)[index(pos)]; }
+    [[attr_forceinline]] const T& operator()(const Pos2D& pos) const noexcept { return (*this)[index(pos)]; }
+
+    /// Every cell including the halo and any padding of the layout, in flat index order
+    [[nodiscard]] std::span<T> cells() noexcept { return {storage.data(), cellCount()}; }
+    [[nodiscard]] std::span<const T> cells() const noexcept { return {storage.data(), cellCount()}; }
+
+private:
+    dextents<int32_t, 2> interiorExtents;
+    int32_t haloWidth;
+    Storage storage;
+
+    static dextents<int32_t, 2> Padded(const dextents<int32_t, 2>& interior, int32_t halo) noexcept {
+        return {interior.extent(0) + 2 * halo, interior.extent(1) + 2 * halo};
+    }
+
+    std::size_t cellCount() const noexcept { return static_cast<std::size_t>(storage.mapping().required_span_size()); }
+};
+
+/// Layouts a day's PaddedGrids can be instantiated with, chosen at runtime by --layout
+enum class GridLayout : uint8_t { ROW_MAJOR, TILED, MORTON };
+
+class GridLayouts {
+public:
+    static constexpr std::array<std::string_view, 3> NAMES{"row", "tiled", "morton"};
+
+    /// Set by --layout
+    static inline GridLayout selected{GridLayout::ROW_MAJOR};
+
+    static std::optional<GridLayout> Parse(std::string_view name) noexcept {
+        const auto found = std::ranges::find(NAMES, name);
+        return found == NAMES.end() ? std::nullopt : std::optional{static_cast<GridLayout>(found - NAMES.begin())};
+    }
+};
+
+/// 8x8 cells, one cache line of a char grid
+using layout_tiled8 = layout_tiled<8, 8>;
+
+/// <summary>
+/// Calls body.template operator()<Layout>() with the layout --layout selected, so a day instantiates its grid code for
+/// every layout and the same binary benchmarks each: WithGridLayout([&]<class Layout> { ... }).
+/// </summary>
+template <class Body>
+decltype(auto) WithGridLayout(Body&& body) {
+    switch (GridLayouts::selected) {
+        case GridLayout::TILED: return body.template operator()<layout_tiled8>();
+        case GridLayout::MORTON: return body.template operator()<layout_morton>();
+        case GridLayout::ROW_MAJOR: break;
+    }
+    return body.template operator()<layout_right>();
+}
+
+/// <summary>
+/// Set of positions inside fixed extents, one bit per cell. Insert and lookup are a shift and a mask, with nothing to
+/// hash or probe, which beats a hash set once a fair share of the grid ends up in it. Positions must be in bounds.
+/// </summary>
+class PosSet {
+public:
+    explicit PosSet(const dextents<int32_t, 2>& extents)
+        : bounds{extents},
+          words((static_cast<std::size_t>(extents.extent(0)) * static_cast<std::size_t>(extents.extent(1)) + 63) /
+                64) {}
+
+    [[nodiscard]] const dextents<int32_t, 2>& extents() const noexcept { return bounds; }
+    [[nodiscard]] std::size_t size() const noexcept { return count; }
+    [[nodiscard]] bool empty() const noexcept { return count == 0; }
+
+    [[nodiscard, attr_forceinline]] bool contains(const Pos2D& pos) const noexcept {
+        const std::size_t bit = index(pos);
+        return (words[bit / 64] >> (bit % 64)) & 1;
+    }
+
+    /// True if pos was not in the set yet
+    [[attr_forceinline]] bool insert(const Pos2D& pos) noexcept {
+        const std::size_t bit = index(pos);
+        uint64_t& word        = words[bit / 64];
+        const uint64_t mask   = uint64_t{1} << (bit % 64);
+        const bool inserted   = !(word & mask);
+        word |= mask;
+        count += inserted;
+        return inserted;
+    }
+
+    /// True if pos was in the set
+    [[attr_forceinline]] bool erase(const Pos2D& pos) noexcept {
+        const std::size_t bit = index(pos);
+        uint64_t& word        = words[bit / 64];
+        const uint64_t mask   = uint64_t{1} << (bit % 64);
+        const bool erased     = word & mask;
+        word &= ~mask;
+        count -= erased;
+        return erased;
+    }
+
+    void clear() noexcept {
+        std::ranges::fill(words, uint64_t{0});
+        count = 0;
+    }
+
+    /// Calls visit(pos) for every position in the set, in row-major order
+    template <class Visit>
+    void forEach(Visit&& visit) const {
+        for (std::size_t w{0}; w < words.size(); ++w) {
+            for (uint64_t word = words[w]; word != 0; word &= word - 1) {
+                const auto bit = static_cast<int32_t>(w * 64 + static_cast<std::size_t>(std::countr_zero(word)));
+                visit(Pos2D{bit / bounds.extent(1), bit % bounds.extent(1)});
+            }
+        }
+    }
+
+private:
+    dextents<int32_t, 2> bounds;
+    std::vector<uint64_t> words;
+    std::size_t count{0};
+
+    [[nodiscard, attr_forceinline]] std::size_t index(const Pos2D& pos) const noexcept {
+        return static_cast<std::size_t>(pos.y()) * static_cast<std::size_t>(bounds.extent(1)) +
+               static_cast<std::size_t>(pos.x());
+    }
+};
@@ -1,3 +1,238 @@
+// Checks the SSE paths of the Pos/Vec operations against the component loops they replace, on coordinates that are
+// negative, near the int32_t limits or just outside the bounds, that packed keys keep every bit of the key, and that
+// the tiled and Morton layouts map, invert and step consistently on extents that don't fill a tile or a power of two.
+
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cstdint>
+#include <format>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
 #include "Mdspan.hpp"
 
-int main() {}
\ No newline at end of file
+namespace {
+
+int failures{0};
+
+void Check(bool condition, std::string_view what) {
+    if (!condition) {
+        ++failures;
+        std::cerr << "Failed: " << what << '\n';
+    }
+}
+
+std::mt19937_64 rng{2024};
+
+/// Components as "(y, x)", for failure messages
+template <class IndexType, std::size_t Rank>
+std::string Text(const std::array<IndexType, Rank>& components) {
+    std::string text{"("};
+    for (std::size_t r{0}; r < Rank; ++r) {
+        text += std::format("{}{}", r == 0 ? "" : ", ", components[r]);
+    }
+    return text + ')';
+}
+
+/// Mostly small coordinates around 0 and the bounds, sometimes one at the edge of the int32_t range
+int32_t Coordinate() {
+    switch (rng() % 8) {
+        case 0: return INT32_MIN + static_cast<int32_t>(rng() % 4);
+        case 1: return INT32_MAX - static_cast<int32_t>(rng() % 4);
+        default: return static_cast<int32_t>(rng() % 41) - 10;
+    }
+}
+
+template <std::size_t Rank>
+Pos<int32_t, Rank> RandomPos() {
+    Pos<int32_t, Rank> pos;
+    for (int32_t& component : pos) {
+        component = Coordinate();
+    }
+    return pos;
+}
+
+template <std::size_t Rank, class Extents>
+void CheckInBounds(const Extents& extents) {
+    for (int i{0}; i < 2000; ++i) {
+        const Pos<int32_t, Rank> pos = RandomPos<Rank>();
+        bool inside{true};
+        for (std::size_t r{0}; r < Rank; ++r) {
+            inside = inside && pos[r] >= 0 && pos[r] < extents.extent(r);
+        }
+        Check(InBounds(extents, pos) == inside, std::format("InBounds of {} in rank {} extents", Text(pos), Rank));
+    }
+}
+
+template <std::size_t Rank>
+void CheckComponentwise() {
+    for (int i{0}; i < 2000; ++i) {
+        const Pos<int32_t, Rank> lhs = RandomPos<Rank>();
+        const Pos<int32_t, Rank> rhs = RandomPos<Rank>();
+        Pos<int32_t, Rank> lower;
+        Pos<int32_t, Rank> upper;
+        bool below{true};
+        for (std::size_t r{0}; r < Rank; ++r) {
+            lower[r] = std::min(lhs[r], rhs[r]);
+            upper[r] = std::max(lhs[r], rhs[r]);
+            below    = below && lhs[r] < rhs[r];
+        }
+        Check(Min(lhs, rhs) == lower, std::format("Min({}, {})", Text(lhs), Text(rhs)));
+        Check(Max(lhs, rhs) == upper, std::format("Max({}, {})", Text(lhs), Text(rhs)));
+        Check((lhs < rhs) == below, std::format("{} < {}", Text(lhs), Text(rhs)));
+    }
+}
+
+void CheckWrapInto() {
+    for (const Vec2D bounds : {Vec2D{1, 1}, Vec2D{103, 101}, Vec2D{7, 11}}) {
+        // Odd and even lengths, so both the pairs and the single position at the end are taken
+        for (std::size_t count{0}; count < 10; ++count) {
+            std::vector<Pos2D> positions(count);
+            std::vector<Pos2D> expected(count);
+            for (std::size_t p{0}; p < count; ++p) {
+                for (std::size_t r{0}; r < 2; ++r) {
+                    // Anywhere in (-bounds, 2 * bounds), the range WrapInto promises to handle
+                    positions[p][r] = static_cast<int32_t>(rng() % (3 * bounds[r] - 1)) - bounds[r] + 1;
+                    expected[p][r]  = (positions[p][r] % bounds[r] + bounds[r]) % bounds[r];
+                }
+            }
+            WrapInto(positions, bounds);
+            Check(positions == expected, std::format("WrapInto of {} positions into {}", count, Text(bounds)));
+        }
+    }
+}
+
+static_assert(PackableKey<Pos2D> && PackableKey<Vec2D> && PackableKey<Pos<int16_t, 4>> && PackableKey<Pos<int8_t, 2>>);
+// Too wide for one word, or a size no unsigned integer has
+static_assert(!PackableKey<Pos<int64_t, 2>> && !PackableKey<Pos<int16_t, 3>>);
+static_assert(UnpackKey<Pos2D>(PackKey(Pos2D{-3, 7})) == Pos2D{-3, 7});
+
+/// <summary>
+/// Round trips through PackKey and UnpackKey, and checks that two keys pack to the same integer exactly when they are
+/// equal, which equal_to and PosHash rely on. Components come from a few values around 0 and the type's limits, so
+/// equal and negative keys are common.
+/// </summary>
+template <class Key>
+void CheckPackKey(std::string_view name) {
+    using IndexType = typename Key::Base::value_type;
+    const std::array<IndexType, 6> values{0, 1, -1, -2, std::numeric_limits<IndexType>::min(),
+                                          std::numeric_limits<IndexType>::max()};
+    const auto randomKey = [&] {
+        Key key;
+        for (IndexType& component : key) {
+            component = values[rng() % values.size()];
+        }
+        return key;
+    };
+    for (int i{0}; i < 2000; ++i) {
+        const Key lhs   = randomKey();
+        const Key rhs   = randomKey();
+        const bool same = static_cast<const typename Key::Base&>(lhs) == rhs;
+        Check(UnpackKey<Key>(PackKey(lhs)) == lhs, std::format("{} {} round trips through PackKey", name, Text(lhs)));
+        Check((PackKey(lhs) == PackKey(rhs)) == same,
+              std::format("PackKey tells {} {} and {} apart", name, Text(lhs), Text(rhs)));
+        Check(std::equal_to<Key>{}(lhs, rhs) == same,
+              std::format("equal_to of {} {} and {}", name, Text(lhs), Text(rhs)));
+        Check(!same || PosHash{}(lhs) == PosHash{}(rhs),
+              std::format("PosHash of equal {} {} and {}", name, Text(lhs), Text(rhs)));
+        Check(std::hash<Key>{}(lhs) == PosHash{}(lhs), std::format("std::hash of {} {}", name, Text(lhs)));
+    }
+}
+
+/// Every position of a square around the origin hashes differently, the sign bits of y and x included
+void CheckPosHashSpread() {
+    std::set<std::size_t> hashes;
+    for (int32_t y{-64}; y < 64; ++y) {
+        for (int32_t x{-64}; x < 64; ++x) {
+            hashes.insert(PosHash{}(Pos2D{y, x}));
+        }
+    }
+    Check(hashes.size() == 128 * 128, std::format("{} distinct PosHash values for 128 x 128 positions", hashes.size()));
+}
+
+/// <summary>
+/// For every cell of extents: the index is inside required_span_size() and no other cell's, position() maps it back,
+/// and neighbor() lands on the index of the cell one step away whenever that cell is inside the extents too.
+/// </summary>
+template <class Layout>
+void CheckLayout(std::string_view name, const dextents<int32_t, 2>& extents) {
+    using Mapping = typename Layout::template mapping<dextents<int32_t, 2>>;
+    const Mapping mapping{extents};
+    const std::string where = std::format("{} on {}x{}", name, extents.extent(0), extents.extent(1));
+
+    constexpr std::array<Vec2D, 4> STEP_OFFSETS{Vec2D{-1, 0}, Vec2D{0, -1}, Vec2D{0, 1}, Vec2D{1, 0}};
+    std::set<int32_t> indices;
+    for (int32_t y{0}; y < extents.extent(0); ++y) {
+        for (int32_t x{0}; x < extents.extent(1); ++x) {
+            const Pos2D pos{y, x};
+            const int32_t index = mapping(y, x);
+            Check(index >= 0 && index < mapping.required_span_size(),
+                  std::format("{} maps {} inside required_span_size()", where, Text(pos)));
+            Check(indices.insert(index).second, std::format("{} maps {} to an index of its own", where, Text(pos)));
+            Check(mapping.position(index) == pos, std::format("{} position() inverts {}", where, Text(pos)));
+            for (const GridStep step : GRID_STEPS) {
+                const Pos2D next = pos + STEP_OFFSETS[step];
+                if (InBounds(extents, next)) {
+                    Check(mapping.neighbor(index, step) == mapping(next.y(), next.x()),
+                          std::format("{} neighbor() of {} in direction {}", where, Text(pos), static_cast<int>(step)));
+                }
+            }
+        }
+    }
+    Check(mapping.is_exhaustive() ==
+              (static_cast<std::size_t>(mapping.required_span_size()) == indices.size()),
+          std::format("{} is_exhaustive()", where));
+}
+
+/// Extents a tile or power of two wide, one past it and well short of it, in both directions and both shapes
+void CheckLayouts() {
+    for (const dextents<int32_t, 2> extents :
+         {dextents<int32_t, 2>{8, 8}, dextents<int32_t, 2>{9, 17}, dextents<int32_t, 2>{17, 9},
+          dextents<int32_t, 2>{1, 65}, dextents<int32_t, 2>{65, 1}, dextents<int32_t, 2>{33, 5},
+          dextents<int32_t, 2>{16, 32}, dextents<int32_t, 2>{1, 1}, dextents<int32_t, 2>{0, 7}}) {
+        CheckLayout<layout_tiled8>("layout_tiled8", extents);
+        CheckLayout<layout_tiled<2, 16>>("layout_tiled<2, 16>", extents);
+        CheckLayout<layout_morton>("layout_morton", extents);
+
+        // Tiles pad each side up to a whole tile, the Morton span ends at the code of the last cell
+        const int32_t tileRows = (extents.extent(0) + 7) / 8;
+        const int32_t tileCols = (extents.extent(1) + 7) / 8;
+        Check(layout_tiled8::mapping<dextents<int32_t, 2>>{extents}.required_span_size() == tileRows * tileCols * 64,
+              std::format("layout_tiled8 span of {}x{}", extents.extent(0), extents.extent(1)));
+        const layout_morton::mapping<dextents<int32_t, 2>> morton{extents};
+        const int32_t mortonSpan =
+            extents.extent(0) * extents.extent(1) == 0 ? 0 : morton(extents.extent(0) - 1, extents.extent(1) - 1) + 1;
+        Check(morton.required_span_size() == mortonSpan,
+              std::format("layout_morton span of {}x{}", extents.extent(0), extents.extent(1)));
+    }
+}
+
+} // namespace
+
+int main() {
+    CheckInBounds<2>(dextents<int32_t, 2>{5, 9});
+    CheckInBounds<2>(dextents<int32_t, 2>{0, 9});
+    CheckInBounds<2>(extents<int32_t, 7, 3>{});
+    CheckInBounds<3>(dextents<int32_t, 3>{4, 1, 6});
+    CheckComponentwise<2>();
+    CheckComponentwise<3>();
+    CheckWrapInto();
+    CheckPackKey<Pos2D>("Pos2D");
+    CheckPackKey<Vec2D>("Vec2D");
+    CheckPackKey<Pos<int16_t, 4>>("Pos<int16_t, 4>");
+    CheckPackKey<Pos<int8_t, 2>>("Pos<int8_t, 2>");
+    CheckPosHashSpread();
+    CheckLayouts();
+    if (failures != 0) {
+        std::cerr << failures << " checks failed\n";
+        return 1;
+    }
+    return 0;
+}
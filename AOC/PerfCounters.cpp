@@ -0,0 +1,194 @@
+#include "PerfCounters.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <format>
+#include <mutex>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+#ifdef __linux__
+
+struct EventConfig {
+    uint32_t type;
+    uint64_t config;
+    uint8_t group;
+};
+
+constexpr uint64_t CacheReadMiss(uint64_t cache) {
+    return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+constexpr std::array<EventConfig, PerfCounters::EVENT_COUNT> EVENT_CONFIGS{{
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, 0},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, 0},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, 0},
+    {PERF_TYPE_HW_CACHE, CacheReadMiss(PERF_COUNT_HW_CACHE_L1D), 1},
+    {PERF_TYPE_HW_CACHE, CacheReadMiss(PERF_COUNT_HW_CACHE_LL), 1},
+    {PERF_TYPE_HW_CACHE, CacheReadMiss(PERF_COUNT_HW_CACHE_DTLB), 1},
+}};
+
+std::once_flag unavailableWarning;
+
+int OpenEvent(const EventConfig& event, int groupFd) {
+    perf_event_attr attr{};
+    attr.size           = sizeof(attr);
+    attr.type           = event.type;
+    attr.config         = event.config;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+    attr.read_format    = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    // This thread on any CPU
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, PERF_FLAG_FD_CLOEXEC));
+}
+
+class ThreadCounters {
+    struct Group {
+        int leader{-1};
+        // Events in the order PERF_FORMAT_GROUP returns them
+        std::array<PerfCounters::Event, PerfCounters::EVENT_COUNT> members{};
+        uint8_t memberCount{0};
+    };
+
+    std::array<int, PerfCounters::EVENT_COUNT> fds{};
+    std::array<Group, PerfCounters::GROUP_COUNT> groups{};
+
+public:
+    ThreadCounters() {
+        int firstError{0};
+        for (uint8_t e{0}; e < PerfCounters::EVENT_COUNT; ++e) {
+            Group& group = groups[EVENT_CONFIGS[e].group];
+            fds[e]       = OpenEvent(EVENT_CONFIGS[e], group.leader);
+            if (fds[e] < 0) {
+                firstError = firstError ? firstError : errno;
+                continue;
+            }
+            if (group.leader < 0) {
+                group.leader = fds[e];
+            }
+            group.members[group.memberCount++] = static_cast<PerfCounters::Event>(e);
+        }
+        if (!available()) {
+            std::call_once(unavailableWarning, [firstError] {
+                logger.perf("Hardware counters unavailable ({}), check /proc/sys/kernel/perf_event_paranoid",
+                            std::strerror(firstError));
+            });
+        }
+    }
+
+    ThreadCounters(const ThreadCounters&)            = delete;
+    ThreadCounters& operator=(const ThreadCounters&) = delete;
+
+    ~ThreadCounters() {
+        for (const int fd : fds) {
+            if (fd >= 0) close(fd);
+        }
+    }
+
+    bool available() const noexcept {
+        return std::ranges::any_of(groups, [](const Group& group) { return group.leader >= 0; });
+    }
+
+    std::optional<PerfCounters::Snapshot> read() const {
+        if (!available()) {
+            return std::nullopt;
+        }
+        PerfCounters::Snapshot snapshot;
+        for (std::size_t g{0}; g < groups.size(); ++g) {
+            const Group& group = groups[g];
+            if (group.leader < 0) {
+                continue;
+            }
+            // nr, time_enabled, time_running, values[nr]
+            std::array<uint64_t, 3 + PerfCounters::EVENT_COUNT> buffer{};
+            if (::read(group.leader, buffer.data(), sizeof(buffer)) < 0) {
+                continue;
+            }
+            snapshot.timeEnabled[g] = buffer[1];
+            snapshot.timeRunning[g] = buffer[2];
+            for (uint8_t m{0}; m < group.memberCount; ++m) {
+                snapshot.counts[group.members[m]] = buffer[3 + m];
+                snapshot.presentMask |= 1u << group.members[m];
+            }
+        }
+        return snapshot;
+    }
+};
+
+std::string FormatCount(double count) {
+    if (count >= 1e9) return std::format("{:.2f}G", count / 1e9);
+    if (count >= 1e6) return std::format("{:.2f}M", count / 1e6);
+    if (count >= 1e3) return std::format("{:.2f}K", count / 1e3);
+    return std::format("{:.0f}", count);
+}
+
+#endif
+
+} // namespace
+
+std::optional<PerfCounters::Snapshot> PerfCounters::Read() {
+#ifdef __linux__
+    if (!enabled) {
+        return std::nullopt;
+    }
+    thread_local const ThreadCounters threadCounters;
+    return threadCounters.read();
+#else
+    return std::nullopt;
+#endif
+}
+
+std::string PerfCounters::Describe([[maybe_unused]] const Snapshot& begin, [[maybe_unused]] const Snapshot& end) {
+    std::string description;
+#ifdef __linux__
+    const uint8_t present = begin.presentMask & end.presentMask;
+    // Scaled by enabled / running time in case the kernel multiplexed the group
+    const auto delta = [&](Event event) -> std::optional<double> {
+        const std::size_t g        = EVENT_CONFIGS[event].group;
+        const uint64_t timeRunning = end.timeRunning[g] - begin.timeRunning[g];
+        if (!(present & (1u << event)) || timeRunning == 0) {
+            return std::nullopt;
+        }
+        const double scale = static_cast<double>(end.timeEnabled[g] - begin.timeEnabled[g]) / timeRunning;
+        return static_cast<double>(end.counts[event] - begin.counts[event]) * scale;
+    };
+
+    const std::optional<double> cycles       = delta(CYCLES);
+    const std::optional<double> instructions = delta(INSTRUCTIONS);
+    if (cycles) {
+        description += std::format(" cycles={}", FormatCount(*cycles));
+    }
+    if (instructions) {
+        description += std::format(" instructions={}", FormatCount(*instructions));
+    }
+    if (cycles && instructions && *cycles > 0) {
+        description += std::format(" IPC={:.2f}", *instructions / *cycles);
+    }
+    constexpr std::array<std::pair<Event, std::string_view>, 4> MISS_NAMES{{
+        {L1D_MISSES, "L1D"},
+        {LLC_MISSES, "LLC"},
+        {BRANCH_MISSES, "branch"},
+        {DTLB_MISSES, "dTLB"},
+    }};
+    for (const auto& [event, name] : MISS_NAMES) {
+        const std::optional<double> misses = delta(event);
+        if (!misses) {
+            continue;
+        }
+        if (instructions && *instructions > 0) {
+            description += std::format(" {}-misses={} ({:.2f} MPKI)", name, FormatCount(*misses),
+                                       *misses * 1000.0 / *instructions);
+        } else {
+            description += std::format(" {}-misses={}", name, FormatCount(*misses));
+        }
+    }
+#endif
+    return description;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/// Hardware performance counters
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+/// <summary>
+/// Per-thread perf_event_open counters read around StopWatch sections.
+/// Counters are opened lazily on first use in each thread. Events the kernel, PMU or perf_event_paranoid
+/// refuse are reported as missing instead of failing the run.
+/// </summary>
+class PerfCounters {
+public:
+    enum Event : uint8_t {
+        CYCLES,
+        INSTRUCTIONS,
+        BRANCH_MISSES,
+        L1D_MISSES,
+        LLC_MISSES,
+        DTLB_MISSES,
+        EVENT_COUNT,
+    };
+
+    /// Events are split into two groups so each fits in the general purpose counters of common PMUs
+    static constexpr std::size_t GROUP_COUNT = 2;
+
+    struct Snapshot {
+        std::array<uint64_t, EVENT_COUNT> counts{};
+        std::array<uint64_t, GROUP_COUNT> timeEnabled{};
+        std::array<uint64_t, GROUP_COUNT> timeRunning{};
+        uint8_t presentMask{};
+    };
+
+    /// Set by --perf-counters or AOC_PERF_COUNTERS
+    static inline bool enabled{false};
+
+    /// Current counts for the calling thread, nullopt when disabled or unavailable
+    static std::optional<Snapshot> Read();
+
+    /// Counts between two snapshots with derived IPC and misses per kilo-instruction
+    static std::string Describe(const Snapshot& begin, const Snapshot& end);
+};
@@ -0,0 +1,342 @@
+#include "Regression.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "CpuFeatures.hpp"
+#include "Logger.hpp"
+
+namespace {
+
+/// Runs of a section the history median is taken over
+constexpr std::size_t HISTORY_WINDOW = 5;
+/// Sections that move by less than this are timer noise however large the ratio
+constexpr double NOISE_FLOOR_MS = 0.05;
+/// Blessed budgets are the measured time times this, and at least BUDGET_FLOOR_MS
+constexpr double BUDGET_HEADROOM = 2.0;
+constexpr double BUDGET_FLOOR_MS = 1.0;
+
+struct DayRecord {
+    std::vector<std::string> solutions;
+    std::map<std::string, double, std::less<>> sections;
+};
+
+std::mutex recordsMutex;
+std::map<std::string, DayRecord, std::less<>> records;
+
+/// "[day]" header lines, each followed by the lines of that day. Blank lines and # comments are skipped.
+using DayEntries = std::map<std::string, std::vector<std::string>, std::less<>>;
+
+std::vector<std::string> ReadLines(const std::filesystem::path& path) {
+    std::ifstream file{path};
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(file, line);) {
+        if (line.ends_with('\r')) {
+            line.pop_back();
+        }
+        lines.push_back(std::move(line));
+    }
+    return lines;
+}
+
+std::optional<std::string_view> DayHeader(std::string_view line) {
+    if (line.size() > 2 && line.front() == '[' && line.back() == ']') {
+        return line.substr(1, line.size() - 2);
+    }
+    return std::nullopt;
+}
+
+DayEntries ReadDayEntries(const std::filesystem::path& path) {
+    DayEntries entries;
+    std::vector<std::string>* day{nullptr};
+    for (const std::string& line : ReadLines(path)) {
+        if (line.empty() || line.starts_with('#')) {
+            continue;
+        }
+        if (const std::optional<std::string_view> header = DayHeader(line)) {
+            day = &entries[std::string{*header}];
+        } else if (day != nullptr) {
+            day->push_back(line);
+        }
+    }
+    return entries;
+}
+
+std::string_view Trim(std::string_view text) {
+    const std::size_t begin = text.find_first_not_of(' ');
+    return begin == text.npos ? std::string_view{} : text.substr(begin, text.find_last_not_of(' ') + 1 - begin);
+}
+
+std::optional<double> ParseMilliseconds(std::string_view text) {
+    text = Trim(text);
+    double value{};
+    const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (error != std::errc{} || end != text.data() + text.size()) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+std::vector<std::string> AnswerLines(const DayRecord& record) {
+    return record.solutions;
+}
+
+/// The section's fastest run with headroom, so a budget fails a real slowdown rather than a noisy run
+std::vector<std::string> BudgetLines(const DayRecord& record) {
+    std::vector<std::string> lines;
+    for (const auto& [section, milliseconds] : record.sections) {
+        lines.push_back(std::format("{} = {:.3f}", section, std::max(milliseconds * BUDGET_HEADROOM, BUDGET_FLOOR_MS)));
+    }
+    return lines;
+}
+
+/// Replaces the entries of the blessed days with entryLines(record) and keeps every other line, comments included
+template <class EntryLines>
+void WriteEntries(const std::filesystem::path& path, std::span<const std::string_view> days, EntryLines entryLines) {
+    std::vector<std::string> out;
+    std::vector<std::string_view> written;
+    const auto appendDay = [&](std::string_view day) {
+        out.push_back(std::format("[{}]", day));
+        const auto record = records.find(day);
+        if (record != records.end()) {
+            std::ranges::move(entryLines(record->second), std::back_inserter(out));
+        }
+        written.push_back(day);
+    };
+    bool skipping{false};
+    for (const std::string& line : ReadLines(path)) {
+        if (const std::optional<std::string_view> header = DayHeader(line)) {
+            skipping = std::ranges::find(days, *header) != days.end();
+            if (skipping) {
+                appendDay(*header);
+                continue;
+            }
+        }
+        if (!skipping) {
+            out.push_back(line);
+        }
+    }
+    for (const std::string_view day : days) {
+        if (std::ranges::find(written, day) == written.end()) {
+            appendDay(day);
+        }
+    }
+    std::ofstream file{path, std::ios::binary};
+    for (const std::string& line : out) {
+        file << line << '\n';
+    }
+    if (!file) {
+        throw std::system_error{std::make_error_code(std::errc::io_error), path.string()};
+    }
+}
+
+/// Whether every solution line of the day matches, nullopt if the day has no expected answers
+std::optional<bool> CheckAnswers(std::string_view day, const DayRecord& record, const DayEntries& expected) {
+    const auto entry = expected.find(day);
+    if (entry == expected.end()) {
+        logger.perf("Regression: {} has no expected answers, record them with --bless", day);
+        return std::nullopt;
+    }
+    const std::vector<std::string>& answers = entry->second;
+    bool passed{answers.size() == record.solutions.size()};
+    if (!passed) {
+        logger.perf("Regression FAIL: {} logged {} solution lines, expected {}", day, record.solutions.size(),
+                    answers.size());
+    }
+    for (std::size_t s{0}; s < std::min(answers.size(), record.solutions.size()); ++s) {
+        if (answers[s] != record.solutions[s]) {
+            logger.perf("Regression FAIL: {} solution {} is \"{}\", expected \"{}\"", day, s + 1, record.solutions[s],
+                        answers[s]);
+            passed = false;
+        }
+    }
+    return passed;
+}
+
+bool CheckBudgets(std::string_view day, const DayRecord& record, const DayEntries& budgets) {
+    const auto entry = budgets.find(day);
+    if (entry == budgets.end()) {
+        return true;
+    }
+    bool passed{true};
+    for (const std::string& line : entry->second) {
+        const std::size_t equals       = line.rfind('=');
+        const std::string_view section = Trim(std::string_view{line}.substr(0, equals));
+        const std::optional<double> budgetMs =
+            equals == line.npos ? std::nullopt : ParseMilliseconds(std::string_view{line}.substr(equals + 1));
+        if (!budgetMs) {
+            throw std::invalid_argument{std::format("Budget of {} is not \"section = milliseconds\": {}", day, line)};
+        }
+        const auto timing = record.sections.find(section);
+        if (timing == record.sections.end()) {
+            logger.perf("Regression FAIL: {} has a budget for {} but never ran it", day, section);
+            passed = false;
+        } else if (timing->second > *budgetMs) {
+            logger.perf("Regression FAIL: {} {} took {:.3f}ms, over its {:.3f}ms budget", day, section,
+                        timing->second, *budgetMs);
+            passed = false;
+        }
+    }
+    return passed;
+}
+
+/// History lines are "unix time,isa,day,milliseconds,section", the section last as its name may hold commas
+struct HistoryEntry {
+    std::string isa;
+    std::string day;
+    double milliseconds;
+    std::string section;
+};
+
+std::vector<HistoryEntry> ReadHistory(const std::filesystem::path& path) {
+    std::vector<HistoryEntry> history;
+    for (const std::string& line : ReadLines(path)) {
+        std::array<std::size_t, 4> commas{};
+        std::size_t position{0};
+        bool complete{true};
+        for (std::size_t& comma : commas) {
+            comma    = line.find(',', position);
+            complete = complete && comma != line.npos;
+            position = complete ? comma + 1 : line.size();
+        }
+        const std::string_view text{line};
+        const std::optional<double> milliseconds =
+            complete ? ParseMilliseconds(text.substr(commas[2] + 1, commas[3] - commas[2] - 1)) : std::nullopt;
+        // The header and lines cut short by an interrupted run are skipped
+        if (milliseconds) {
+            history.push_back({std::string{text.substr(commas[0] + 1, commas[1] - commas[0] - 1)},
+                               std::string{text.substr(commas[1] + 1, commas[2] - commas[1] - 1)}, *milliseconds,
+                               std::string{text.substr(commas[3] + 1)}});
+        }
+    }
+    return history;
+}
+
+bool CheckHistory(std::string_view day, const DayRecord& record, std::span<const HistoryEntry> history,
+                  std::string_view isa, double threshold) {
+    bool passed{true};
+    for (const auto& [section, milliseconds] : record.sections) {
+        std::vector<double> recent;
+        for (const HistoryEntry& entry : history | std::views::reverse) {
+            if (entry.isa == isa && entry.day == day && entry.section == section) {
+                recent.push_back(entry.milliseconds);
+                if (recent.size() == HISTORY_WINDOW) {
+                    break;
+                }
+            }
+        }
+        if (recent.empty()) {
+            continue;
+        }
+        const auto middle = recent.begin() + static_cast<std::ptrdiff_t>(recent.size() / 2);
+        std::ranges::nth_element(recent, middle);
+        const double median = *middle;
+        if (milliseconds > median * (1.0 + threshold) && milliseconds - median > NOISE_FLOOR_MS) {
+            logger.perf("Regression FAIL: {} {} took {:.3f}ms, {:.0f}% slower than the {:.3f}ms median of its last {} "
+                        "runs",
+                        day, section, milliseconds, (milliseconds / median - 1.0) * 100.0, median, recent.size());
+            passed = false;
+        }
+    }
+    return passed;
+}
+
+void AppendHistory(const std::filesystem::path& path, std::string_view day, const DayRecord& record,
+                   std::string_view isa) {
+    const bool fresh = !std::filesystem::exists(path);
+    const int64_t now =
+        std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    std::string out{fresh ? "unix_time,isa,day,milliseconds,section\n" : ""};
+    for (const auto& [section, milliseconds] : record.sections) {
+        std::format_to(std::back_inserter(out), "{},{},{},{:.4f},{}\n", now, isa, day, milliseconds, section);
+    }
+    // One write per day, so concurrent runs appending to the same file don't interleave within a line
+    std::ofstream file{path, std::ios::binary | std::ios::app};
+    file.write(out.data(), static_cast<std::streamsize>(out.size()));
+    if (!file) {
+        throw std::system_error{std::make_error_code(std::errc::io_error), path.string()};
+    }
+}
+
+} // namespace
+
+void Regression::RecordSolution(std::string_view context, std::string_view message) {
+    const std::lock_guard recordsLock{recordsMutex};
+    records[std::string{context}].solutions.emplace_back(message);
+}
+
+void Regression::RecordSection(std::string_view context, std::string_view name, double milliseconds) {
+    if (Logger::muted) {
+        return;
+    }
+    const std::lock_guard recordsLock{recordsMutex};
+    auto& sections                = records[std::string{context}].sections;
+    const auto [timing, inserted] = sections.try_emplace(std::string{name}, milliseconds);
+    if (!inserted) {
+        timing->second = std::min(timing->second, milliseconds);
+    }
+}
+
+int Regression::Check(std::span<const std::string_view> days) {
+    const std::lock_guard recordsLock{recordsMutex};
+    // A standalone day logs without a context
+    if (days.size() == 1) {
+        if (auto unnamed = records.extract(std::string{}); !unnamed.empty()) {
+            unnamed.key() = days.front();
+            records.insert(std::move(unnamed));
+        }
+    }
+    if (options.bless) {
+        if (options.answers) {
+            WriteEntries(*options.answers, days, AnswerLines);
+            logger.perf("Regression: answers of {} days written to {}", days.size(), options.answers->string());
+        }
+        if (options.budgets) {
+            WriteEntries(*options.budgets, days, BudgetLines);
+            logger.perf("Regression: budgets of {} days written to {}", days.size(), options.budgets->string());
+        }
+        return 0;
+    }
+
+    const DayEntries expected = options.answers ? ReadDayEntries(*options.answers) : DayEntries{};
+    const DayEntries budgets  = options.budgets ? ReadDayEntries(*options.budgets) : DayEntries{};
+    const std::vector<HistoryEntry> history =
+        options.history ? ReadHistory(*options.history) : std::vector<HistoryEntry>{};
+    const std::string_view isa = CpuFeatures::Name(CpuFeatures::Active());
+    std::size_t failed{0};
+    std::size_t answered{0};
+    for (const std::string_view day : days) {
+        static const DayRecord EMPTY;
+        const auto found        = records.find(day);
+        const DayRecord& record = found == records.end() ? EMPTY : found->second;
+        bool passed{true};
+        if (options.answers) {
+            const std::optional<bool> answersMatch = CheckAnswers(day, record, expected);
+            answered += answersMatch.has_value();
+            passed &= answersMatch.value_or(true);
+        }
+        passed &= CheckBudgets(day, record, budgets);
+        if (options.history) {
+            passed &= CheckHistory(day, record, history, isa, options.threshold);
+            AppendHistory(*options.history, day, record, isa);
+        }
+        failed += !passed;
+    }
+    logger.perf("Regression: {} of {} days failed", failed, days.size());
+    if (failed != 0) {
+        return 1;
+    }
+    return (options.answers && answered == 0) ? EXIT_SKIPPED : 0;
+}
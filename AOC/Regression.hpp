@@ -0,0 +1,47 @@
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/// Answer and timing checks of a run against checked-in expectations
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string_view>
+
+struct RegressionOptions {
+    /// Solution lines per day, see expected_answers.txt
+    std::optional<std::filesystem::path> answers;
+    /// Rewrites the days' entries in answers with this run's solution lines, and in budgets with its section timings
+    /// plus headroom, instead of checking them
+    bool bless{false};
+    /// Longest each section of a day may take, see time_budgets.txt
+    std::optional<std::filesystem::path> budgets;
+    /// CSV of earlier section timings, this run is compared to it and then appended
+    std::optional<std::filesystem::path> history;
+    /// Slowdown over the median of recent runs that fails a section, 0.25 is 25% slower
+    double threshold{0.25};
+};
+
+/// <summary>
+/// Collects the solution lines and StopWatch timings of a run, then checks them against expected answers, time
+/// budgets and the timing history once the run is over. Lines and sections are keyed by Logger::context, a
+/// standalone day logs without one and takes the name of the only day run.
+/// </summary>
+class Regression {
+public:
+    /// Exit code of a run with no expected answers for any of its days, CTest reports it as skipped
+    static constexpr int EXIT_SKIPPED = 77;
+
+    static inline RegressionOptions options;
+    /// Set once options asks for any check, before any section starts
+    static inline bool enabled{false};
+
+    /// Called by the logger with every solution line once formatted
+    static void RecordSolution(std::string_view context, std::string_view message);
+    /// Keeps the fastest of the section's runs, benchmark samples are left out
+    static void RecordSection(std::string_view context, std::string_view name, double milliseconds);
+
+    /// Checks the recorded run of days, logs every failure and returns the exit code of the process
+    static int Check(std::span<const std::string_view> days);
+};
@@ -0,0 +1,244 @@
+#include "ThreadPool.hpp"
+
+#include "Arena.hpp"
+#include "Logger.hpp"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+#ifdef WIN32
+#include <Windows.h>
+#endif
+
+namespace {
+
+ThreadPool::Options configuredOptions;
+
+thread_local const ThreadPool* currentPool{nullptr};
+thread_local unsigned currentWorker{ThreadPool::NOT_A_WORKER};
+/// Job of the chunk the thread is running, the parent of any loop the chunk starts
+thread_local const void* currentJob{nullptr};
+
+/// CPUs the process may run on, in ascending order
+std::vector<unsigned> AllowedCpus() {
+    std::vector<unsigned> cpus;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (unsigned cpu{0}; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+#elif defined(WIN32)
+    DWORD_PTR processMask{};
+    DWORD_PTR systemMask{};
+    if (GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask)) {
+        for (unsigned cpu{0}; cpu < sizeof(DWORD_PTR) * 8; ++cpu) {
+            if (processMask & (DWORD_PTR{1} << cpu)) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+#endif
+    return cpus;
+}
+
+void PinCurrentThread([[maybe_unused]] unsigned cpu) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#elif defined(WIN32)
+    SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR{1} << cpu);
+#endif
+}
+
+} // namespace
+
+void ThreadPool::Configure(const Options& options) {
+    configuredOptions = options;
+}
+
+ThreadPool& ThreadPool::Instance() {
+    static ThreadPool pool{configuredOptions};
+    return pool;
+}
+
+ThreadPool::ThreadPool(const Options& options) {
+    const unsigned threadCount =
+        options.threadCount != 0 ? options.threadCount : std::max(1u, std::thread::hardware_concurrency());
+    const std::vector<unsigned> cpus = options.pinThreads ? AllowedCpus() : std::vector<unsigned>{};
+
+    queues.reserve(threadCount);
+    for (unsigned w{0}; w < threadCount; ++w) {
+        queues.push_back(std::make_unique<TaskQueue>());
+    }
+    // Workers only start once every queue exists, they steal from each other right away
+    workers.reserve(threadCount);
+    for (unsigned w{0}; w < threadCount; ++w) {
+        const std::optional<unsigned> cpu =
+            cpus.empty() ? std::nullopt : std::optional<unsigned>{cpus[w % cpus.size()]};
+        workers.emplace_back([this, w, cpu] { workerLoop(w, cpu); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    stopping.store(true, std::memory_order_release);
+    epoch.fetch_add(1, std::memory_order_release);
+    epoch.notify_all();
+    workers.clear();
+}
+
+unsigned ThreadPool::WorkerIndex() noexcept {
+    return currentWorker;
+}
+
+int64_t ThreadPool::defaultGrain(int64_t count) const noexcept {
+    // A few chunks per worker leaves room to even out uneven iterations
+    return std::max<int64_t>(1, count / (int64_t{8} * workerCount()));
+}
+
+void ThreadPool::push(const Task& task) {
+    TaskQueue& queue = (currentPool == this) ? *queues[currentWorker] : injected;
+    {
+        const std::lock_guard queueLock{queue.mutex};
+        queue.tasks.push_back(task);
+    }
+    epoch.fetch_add(1, std::memory_order_release);
+    epoch.notify_all();
+}
+
+std::optional<ThreadPool::Task> ThreadPool::findTask(unsigned worker, const Job* within) {
+    const auto eligible = [within](const Task& task) {
+        for (const Job* job{task.job}; within != nullptr; job = job->parent) {
+            if (job == within) {
+                return true;
+            }
+            if (job == nullptr) {
+                return false;
+            }
+        }
+        return true;
+    };
+    // Tasks of other jobs are passed over while waiting, they stay queued for workers at the top level
+    const auto take = [&eligible](TaskQueue& queue, bool newest) -> std::optional<Task> {
+        const std::lock_guard queueLock{queue.mutex};
+        if (newest) {
+            const auto found = std::ranges::find_if(queue.tasks.rbegin(), queue.tasks.rend(), eligible);
+            if (found == queue.tasks.rend()) {
+                return std::nullopt;
+            }
+            const Task task = *found;
+            queue.tasks.erase(std::next(found).base());
+            return task;
+        }
+        const auto found = std::ranges::find_if(queue.tasks, eligible);
+        if (found == queue.tasks.end()) {
+            return std::nullopt;
+        }
+        const Task task = *found;
+        queue.tasks.erase(found);
+        return task;
+    };
+    // Newest own task first, it is the smallest and its data is still in cache
+    if (std::optional<Task> task = take(*queues[worker], true)) {
+        return task;
+    }
+    // Only threads outside the pool inject, so nothing there is nested in a job a worker waits for
+    if (within == nullptr) {
+        if (std::optional<Task> task = take(injected, false)) {
+            return task;
+        }
+    }
+    for (std::size_t offset{1}; offset < queues.size(); ++offset) {
+        if (std::optional<Task> task = take(*queues[(worker + offset) % queues.size()], false)) {
+            return task;
+        }
+    }
+    return std::nullopt;
+}
+
+void ThreadPool::execute(Task task) {
+    Job& job = *task.job;
+    while (task.end - task.begin > job.grain) {
+        const int64_t middle = task.begin + (task.end - task.begin) / 2;
+        push({&job, middle, task.end});
+        task.end = middle;
+    }
+    if (!job.failed.load(std::memory_order_relaxed)) {
+        // Lines logged and memory allocated by the chunk are attributed to the day that started the loop
+        const std::string_view previousContext = std::exchange(Logger::context, job.logContext);
+        const bool previousMuted               = std::exchange(Logger::muted, job.logMuted);
+        const void* previousJob                = std::exchange(currentJob, &job);
+        const Arena::Scope arenaScope{*job.arena};
+        try {
+            job.runChunk(job.context, task.begin, task.end);
+        } catch (...) {
+            if (!job.failed.exchange(true)) {
+                job.exception = std::current_exception();
+            }
+        }
+        Logger::context = previousContext;
+        Logger::muted   = previousMuted;
+        currentJob      = previousJob;
+    }
+    if (job.remaining.fetch_sub(task.end - task.begin, std::memory_order_acq_rel) == task.end - task.begin) {
+        // The waiter may destroy the job as soon as it sees done, so nothing touches it after the unlock
+        const std::lock_guard doneLock{job.doneMutex};
+        job.done = true;
+        job.doneCondition.notify_all();
+    }
+}
+
+void ThreadPool::run(Job& job, int64_t begin, int64_t end) {
+    if (begin >= end) {
+        return;
+    }
+    job.logContext = Logger::context;
+    job.logMuted   = Logger::muted;
+    job.arena      = &Arena::Current();
+    job.parent     = static_cast<const Job*>(currentJob);
+    job.remaining.store(end - begin, std::memory_order_relaxed);
+    if (currentPool == this) {
+        execute({&job, begin, end});
+        while (job.remaining.load(std::memory_order_acquire) != 0) {
+            if (std::optional<Task> task = findTask(currentWorker, &job)) {
+                execute(*task);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    } else {
+        push({&job, begin, end});
+    }
+    std::unique_lock doneLock{job.doneMutex};
+    job.doneCondition.wait(doneLock, [&job] { return job.done; });
+    if (job.exception) {
+        std::rethrow_exception(job.exception);
+    }
+}
+
+void ThreadPool::workerLoop(unsigned worker, std::optional<unsigned> cpu) {
+    currentPool   = this;
+    currentWorker = worker;
+    if (cpu) {
+        PinCurrentThread(*cpu);
+    }
+    while (true) {
+        const uint32_t seenEpoch = epoch.load(std::memory_order_acquire);
+        if (std::optional<Task> task = findTask(worker)) {
+            execute(*task);
+            continue;
+        }
+        if (stopping.load(std::memory_order_acquire)) {
+            return;
+        }
+        // Any push after seenEpoch was read wakes the wait immediately
+        epoch.wait(seenEpoch, std::memory_order_acquire);
+    }
+}
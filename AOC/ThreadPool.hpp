@@ -0,0 +1,193 @@
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/// Work-stealing thread pool
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+class Arena;
+
+/// <summary>
+/// Fixed set of workers, each with its own deque of index ranges. A worker splits the range it runs in half until
+/// it is down to the grain size, keeping the first half and pushing the second, so idle workers steal large ranges
+/// from the front of other deques. Waiting workers run queued tasks instead of blocking, which makes nested
+/// parallel loops safe. A worker waiting for a loop only helps with that loop and the loops nested in its chunks,
+/// so the wait never runs unrelated work, such as another day under --parallel, inside the waiting loop's timed
+/// sections or on top of its stack. Threads outside the pool only queue work and wait.
+/// </summary>
+class ThreadPool {
+public:
+    struct Options {
+        /// 0 uses every hardware thread
+        unsigned threadCount{0};
+        /// Pins worker i to the i-th CPU in the process affinity mask
+        bool pinThreads{false};
+    };
+
+    static constexpr unsigned NOT_A_WORKER = ~0u;
+
+    /// Takes effect if called before the first Instance()
+    static void Configure(const Options& options);
+    static ThreadPool& Instance();
+
+    explicit ThreadPool(const Options& options);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&)            = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned workerCount() const noexcept { return static_cast<unsigned>(workers.size()); }
+    /// Index of the calling worker, NOT_A_WORKER outside the pool
+    static unsigned WorkerIndex() noexcept;
+
+    /// Calls body(chunkBegin, chunkEnd) over disjoint chunks of at most grain indices covering [begin, end)
+    template <class Body>
+    void forChunks(int64_t begin, int64_t end, Body&& body, int64_t grain = 0) {
+        using Function      = std::remove_reference_t<Body>;
+        const auto runChunk = [](void* context, int64_t chunkBegin, int64_t chunkEnd) {
+            (*static_cast<Function*>(context))(chunkBegin, chunkEnd);
+        };
+        Job job{
+            .runChunk = runChunk,
+            .context  = const_cast<void*>(static_cast<const void*>(std::addressof(body))),
+            .grain    = grain > 0 ? grain : defaultGrain(end - begin),
+        };
+        run(job, begin, end);
+    }
+
+private:
+    struct Job {
+        void (*runChunk)(void* context, int64_t begin, int64_t end);
+        void* context;
+        int64_t grain;
+        /// Job whose chunk started this one, nullptr for a loop started outside any chunk
+        const Job* parent{nullptr};
+        std::string_view logContext{};
+        bool logMuted{false};
+        Arena* arena{nullptr};
+        std::atomic<int64_t> remaining{0};
+        std::atomic<bool> failed{false};
+        std::exception_ptr exception{};
+        std::mutex doneMutex{};
+        std::condition_variable doneCondition{};
+        bool done{false};
+    };
+
+    struct Task {
+        Job* job;
+        int64_t begin;
+        int64_t end;
+    };
+
+    struct alignas(64) TaskQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<TaskQueue>> queues;
+    TaskQueue injected;
+    std::atomic<uint32_t> epoch{0};
+    std::atomic<bool> stopping{false};
+    std::vector<std::jthread> workers;
+
+    int64_t defaultGrain(int64_t count) const noexcept;
+    void run(Job& job, int64_t begin, int64_t end);
+    void push(const Task& task);
+    /// With within set, only a task of that job or of a job nested in it
+    std::optional<Task> findTask(unsigned worker, const Job* within = nullptr);
+    void execute(Task task);
+    void workerLoop(unsigned worker, std::optional<unsigned> cpu);
+};
+
+/// Calls body(index) for every index in [begin, end)
+template <class Body>
+void ParallelFor(int64_t begin, int64_t end, Body&& body, int64_t grain = 0) {
+    ThreadPool::Instance().forChunks(
+        begin, end,
+        [&body](int64_t chunkBegin, int64_t chunkEnd) {
+            for (int64_t i{chunkBegin}; i < chunkEnd; ++i) {
+                body(i);
+            }
+        },
+        grain);
+}
+
+/// Folds map(index) over [begin, end). Chunks combine in any order, so combine must be associative and commutative.
+template <class T, class Map, class Combine>
+T ParallelReduce(int64_t begin, int64_t end, T identity, Map&& map, Combine&& combine, int64_t grain = 0) {
+    std::mutex resultMutex;
+    T result{identity};
+    ThreadPool::Instance().forChunks(
+        begin, end,
+        [&](int64_t chunkBegin, int64_t chunkEnd) {
+            T partial{identity};
+            for (int64_t i{chunkBegin}; i < chunkEnd; ++i) {
+                partial = combine(std::move(partial), map(i));
+            }
+            const std::lock_guard resultLock{resultMutex};
+            result = combine(std::move(result), std::move(partial));
+        },
+        grain);
+    return result;
+}
+
+/// Calls body(rowBegin, rowEnd) over blocks of rows of a 2D mdspan, mdarray or PaddedGrid
+template <class Grid, class Body>
+void ParallelForRows(const Grid& grid, Body&& body, int32_t rowsPerBlock = 0) {
+    ThreadPool::Instance().forChunks(
+        0, grid.extent(0),
+        [&body](int64_t rowBegin, int64_t rowEnd) {
+            body(static_cast<int32_t>(rowBegin), static_cast<int32_t>(rowEnd));
+        },
+        rowsPerBlock);
+}
+
+/// <summary>
+/// Calls body(scratch, index) for every index in [begin, end), where scratch is built by makeScratch the first time a
+/// worker joins the loop and reused for every index it runs. Returns the scratch states that were built, for a final
+/// merge.
+/// </summary>
+template <class MakeScratch, class Body>
+auto ParallelForWithScratch(int64_t begin, int64_t end, MakeScratch&& makeScratch, Body&& body, int64_t grain = 0) {
+    using Scratch = std::invoke_result_t<MakeScratch&>;
+    struct alignas(64) Slot {
+        std::optional<Scratch> scratch;
+    };
+
+    ThreadPool& pool = ThreadPool::Instance();
+    std::vector<Slot> slots(pool.workerCount());
+    pool.forChunks(
+        begin, end,
+        [&](int64_t chunkBegin, int64_t chunkEnd) {
+            std::optional<Scratch>& scratch = slots[ThreadPool::WorkerIndex()].scratch;
+            if (!scratch) {
+                scratch.emplace(makeScratch());
+            }
+            for (int64_t i{chunkBegin}; i < chunkEnd; ++i) {
+                body(*scratch, i);
+            }
+        },
+        grain);
+
+    std::vector<Scratch> built;
+    for (Slot& slot : slots) {
+        if (slot.scratch) {
+            built.push_back(std::move(*slot.scratch));
+        }
+    }
+    return built;
+}
@@ -0,0 +1,106 @@
+#include "Trace.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <format>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "Logger.hpp"
+#include "ThreadPool.hpp"
+
+namespace {
+
+struct Span {
+    std::string name;
+    std::string_view context;
+    double beginUs;
+    double durationUs;
+    uint32_t depth;
+};
+
+struct ThreadBuffer {
+    uint32_t threadId;
+    unsigned worker;
+    std::deque<Span> spans;
+};
+
+std::mutex buffersMutex;
+std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+
+thread_local uint32_t currentDepth{0};
+
+/// Registered on the thread's first section, only the owning thread appends to it afterwards
+ThreadBuffer& CurrentBuffer() {
+    thread_local ThreadBuffer* buffer = [] {
+        const std::lock_guard buffersLock{buffersMutex};
+        const auto threadId = static_cast<uint32_t>(buffers.size() + 1);
+        return buffers.emplace_back(std::make_unique<ThreadBuffer>(threadId, ThreadPool::WorkerIndex())).get();
+    }();
+    return *buffer;
+}
+
+} // namespace
+
+uint32_t Trace::Enter() noexcept {
+    return currentDepth++;
+}
+
+void Trace::Exit(std::string_view name, std::string_view context, double beginUs, double endUs, uint32_t depth) {
+    currentDepth = depth;
+    // Benchmark samples repeat the section thousands of times with the logger muted, only the logged run is kept
+    if (Logger::muted) {
+        return;
+    }
+    CurrentBuffer().spans.push_back({std::string{name}, context, beginUs, endUs - beginUs, depth});
+}
+
+std::size_t Trace::Write(const std::filesystem::path& path) {
+    const std::lock_guard buffersLock{buffersMutex};
+    double originUs{std::numeric_limits<double>::infinity()};
+    std::size_t spanCount{0};
+    for (const std::unique_ptr<ThreadBuffer>& buffer : buffers) {
+        for (const Span& span : buffer->spans) {
+            originUs = std::min(originUs, span.beginUs);
+        }
+        spanCount += buffer->spans.size();
+    }
+
+    std::string out{R"({"displayTimeUnit":"ms","traceEvents":[)"};
+    bool first{true};
+    const auto separate = [&] { out += std::exchange(first, false) ? "\n" : ",\n"; };
+    for (const std::unique_ptr<ThreadBuffer>& buffer : buffers) {
+        const std::string threadName = buffer->worker == ThreadPool::NOT_A_WORKER
+                                           ? std::format("thread {}", buffer->threadId)
+                                           : std::format("worker {}", buffer->worker);
+        separate();
+        std::format_to(std::back_inserter(out), R"({{"ph":"M","name":"thread_name","pid":1,"tid":{},"args":{{"name":)",
+                       buffer->threadId);
+        AppendJsonString(out, threadName);
+        out += "}}";
+        for (const Span& span : buffer->spans) {
+            separate();
+            out += R"({"ph":"X","name":)";
+            AppendJsonString(out, span.name);
+            out += R"(,"cat":)";
+            AppendJsonString(out, span.context.empty() ? std::string_view{"aoc"} : span.context);
+            std::format_to(std::back_inserter(out), R"(,"pid":1,"tid":{},"ts":{:.3f},"dur":{:.3f})", buffer->threadId,
+                           span.beginUs - originUs, span.durationUs);
+            std::format_to(std::back_inserter(out), R"(,"args":{{"depth":{}}}}})", span.depth);
+        }
+    }
+    out += "\n]}\n";
+
+    std::ofstream file{path, std::ios::binary};
+    file.write(out.data(), static_cast<std::streamsize>(out.size()));
+    if (!file) {
+        throw std::system_error{std::make_error_code(std::errc::io_error), path.string()};
+    }
+    return spanCount;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/// Chrome trace export of StopWatch sections
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+
+/// <summary>
+/// Records every StopWatch section as a complete event with its thread and nesting depth, then writes them as
+/// Chrome trace-event JSON that chrome://tracing and Perfetto open. Each thread appends to a buffer only it writes
+/// to, the buffers are read by Write once the run is over and the pool is idle.
+/// </summary>
+class Trace {
+public:
+    /// Set by --trace or AOC_TRACE, before any section starts
+    static inline bool enabled{false};
+
+    /// Depth of the section being entered on the calling thread, 0 for the outermost
+    static uint32_t Enter() noexcept;
+    /// Leaves the innermost section and records it, times are microseconds from any fixed origin
+    static void Exit(std::string_view name, std::string_view context, double beginUs, double endUs, uint32_t depth);
+
+    /// Writes every recorded section and returns how many there were
+    static std::size_t Write(const std::filesystem::path& path);
+};
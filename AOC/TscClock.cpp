@@ -1,5 +1,23 @@
 #include "TscClock.hpp"
 
+#include <array>
+#include <utility>
+
+namespace {
+
+std::array<uint32_t, 4> CpuId(uint32_t leaf) {
+    int info[4]{};
+#ifdef _MSC_VER
+    __cpuidex(info, static_cast<int>(leaf), 0);
+#else
+    __cpuid_count(leaf, 0, info[0], info[1], info[2], info[3]);
+#endif
+    return {static_cast<uint32_t>(info[0]), static_cast<uint32_t>(info[1]), static_cast<uint32_t>(info[2]),
+            static_cast<uint32_t>(info[3])};
+}
+
+} // namespace
+
 TscClock::TickRate::TickRate(uint32_t crystalFrequency, uint32_t tscCrystalRatioNumerator,
                              uint32_t tscCrystalRatioDenominator)
     : crystalFrequency{crystalFrequency}, tscCrystalRatioNumerator{tscCrystalRatioNumerator},
@@ -7,18 +25,56 @@ TscClock::TickRate::TickRate(uint32_t crystalFrequency, uint32_t tscCrystalRatio
       perSecond{crystalFrequency * (static_cast<double>(tscCrystalRatioNumerator) / tscCrystalRatioDenominator)},
       invPerSecond{static_cast<double>(tscCrystalRatioDenominator) / tscCrystalRatioNumerator / crystalFrequency} {}
 
+TscClock::TickRate::TickRate(double perSecond)
+    : crystalFrequency{0}, tscCrystalRatioNumerator{0}, tscCrystalRatioDenominator{0}, perSecond{perSecond},
+      invPerSecond{1.0 / perSecond} {}
+
 TscClock::TickRate TscClock::GetTickRateRaw() {
-    int info[4]{};
-#ifdef _MSC_VER
-    __cpuid(info, 0x15);
-#else
-    __cpuid(0x15, info[0], info[1], info[2], info[3]);
-#endif
-    const uint32_t tsc_crystal_ratio_denominator = info[0];
-    const uint32_t tsc_crystal_ratio_numerator   = info[1];
-    const uint32_t crystal_frequency             = info[2];
-    if (!(crystal_frequency && tsc_crystal_ratio_numerator && tsc_crystal_ratio_denominator)) {
-        // throw std::runtime_error{"TSC tick rate could not be determined"};
+    if (CpuId(0)[0] >= 0x15) {
+        [[maybe_unused]] const auto [tsc_crystal_ratio_denominator, tsc_crystal_ratio_numerator, crystal_frequency, unused] =
+            CpuId(0x15);
+        if (crystal_frequency && tsc_crystal_ratio_numerator && tsc_crystal_ratio_denominator) {
+            return TickRate{crystal_frequency, tsc_crystal_ratio_numerator, tsc_crystal_ratio_denominator};
+        }
+    }
+    // Leaf 0x15 is missing on AMD and most hypervisors, and often reports no crystal frequency even when present
+    return Calibrate();
+}
+
+TscClock::TickRate TscClock::Calibrate() {
+    using SteadyClock = std::chrono::steady_clock;
+
+    // Bracket rdtsc with steady_clock reads and keep the tightest bracket to filter out preemption
+    const auto sample = [] {
+        SteadyClock::duration bestBracket{SteadyClock::duration::max()};
+        std::pair<SteadyClock::time_point, uint64_t> best{};
+        for (int attempt{0}; attempt < 8; ++attempt) {
+            const SteadyClock::time_point before = SteadyClock::now();
+            const uint64_t tsc                   = rdtsc();
+            const SteadyClock::time_point after  = SteadyClock::now();
+            if (after - before < bestBracket) {
+                bestBracket = after - before;
+                best        = {before + (after - before) / 2, tsc};
+            }
+        }
+        return best;
+    };
+
+    const auto [startTime, startTsc] = sample();
+    while (SteadyClock::now() - startTime < std::chrono::milliseconds{20}) {
+        _mm_pause();
+    }
+    const auto [endTime, endTsc] = sample();
+
+    const double seconds = std::chrono::duration<double>(endTime - startTime).count();
+    return TickRate{static_cast<double>(endTsc - startTsc) / seconds};
+}
+
+bool TscClock::HasInvariantTsc() {
+    constexpr uint32_t ADVANCED_POWER_MANAGEMENT_LEAF = 0x80000007;
+    constexpr uint32_t INVARIANT_TSC_BIT              = 1u << 8;
+    if (CpuId(0x80000000)[0] < ADVANCED_POWER_MANAGEMENT_LEAF) {
+        return false;
     }
-    return TickRate{crystal_frequency, tsc_crystal_ratio_numerator, tsc_crystal_ratio_denominator};
+    return (CpuId(ADVANCED_POWER_MANAGEMENT_LEAF)[3] & INVARIANT_TSC_BIT) != 0;
 }
@@ -28,10 +28,17 @@ struct TscClock {
 
         explicit TickRate(uint32_t crystalFrequency, uint32_t tscCrystalRatioNumerator,
                           uint32_t tscCrystalRatioDenominator);
+
+        /// Measured rather than enumerated, the crystal fields are left zero
+        explicit TickRate(double perSecond);
+
+        bool calibrated() const noexcept { return crystalFrequency == 0; }
     };
 
 private:
     static TickRate GetTickRateRaw();
+    static TickRate Calibrate();
+    static bool HasInvariantTsc();
 
 public:
     using rep    = double;
@@ -44,8 +51,22 @@ public:
     /// <summary>
     /// Tick rate of the hardware clock
     /// Usually the processor's advertised base clock
+    /// Read on first use rather than before main, calibrating it spins for 20 ms where CPUID doesn't report it, and
+    /// binaries timing with steady_clock never need it
     /// </summary>
-    static const inline TickRate TICK_RATE = GetTickRateRaw();
+    static const TickRate& Rate() {
+        static const TickRate rate = GetTickRateRaw();
+        return rate;
+    }
+
+    /// <summary>
+    /// Whether the TSC ticks at a constant rate through P-states and C-states.
+    /// Without it TscClock does not measure wall time.
+    /// </summary>
+    static bool Invariant() {
+        static const bool invariant = HasInvariantTsc();
+        return invariant;
+    }
 
     static uint64_t rdtsc() noexcept {
         _mm_lfence();         // ensure instruction ordering
@@ -58,6 +79,6 @@ public:
     /// Get the current TSC value
     /// </summary>
     static time_point now() noexcept {
-        return time_point{duration{rdtsc() * TICK_RATE.invPerSecond}};
+        return time_point{duration{rdtsc() * Rate().invPerSecond}};
     }
 };
@@ -44,7 +44,8 @@ bool Solveable(const Equation& equation) {
 }
 
 std::vector<Equation> Parse(std::string_view input) {
-    return input | Split('\n') | views::transform(Constructor<Equation>{}) | ranges::to_vector;
+    const LineIndex lines{input};
+    return lines | views::transform(Constructor<Equation>{}) | ranges::to_vector;
 }
 
 int64_t Part1(std::span<const Equation> equations) {
@@ -56,10 +57,12 @@ int64_t Part2(std::span<const Equation> equations) {
                              std::int64_t{}, std::plus{});
 }
 
-} // namespace
-
 void AocMain(std::string_view input) {
     auto equations = StopWatch<std::micro>::Run("Parse", Parse, input);
     logger.solution("Part 1: {}", StopWatch<std::micro>::Run("Part 1", Part1, equations));
     logger.solution("Part 2: {}", StopWatch<std::milli>::Run("Part 2", Part2, equations));
-}
\ No newline at end of file
+}
+
+} // namespace
+
+AOC_REGISTER_SOLVER(bridge_repair, AocMain);
\ No newline at end of file
@@ -57,12 +57,12 @@ size_t Part2(const InputGrid<const char> grid) {
     return count;
 }
 
-} // namespace
-
 void AocMain(std::string_view input) {
     const mdspan grid = ToGrid(input);
-    for (int i = 0; i < 5; ++i) {
-        logger.solution("{}", StopWatch<std::micro>::Run("Part 1", Part1, grid));
-        logger.solution("{}", StopWatch<std::micro>::Run("Part 2", Part2, grid));
-    }
-}
\ No newline at end of file
+    logger.solution("{}", StopWatch<std::micro>::Run("Part 1", Part1, grid));
+    logger.solution("{}", StopWatch<std::micro>::Run("Part 2", Part2, grid));
+}
+
+} // namespace
+
+AOC_REGISTER_SOLVER(ceres_search, AocMain);
\ No newline at end of file
@@ -1,21 +1,34 @@
+#ifdef AOC_EMBEDDED_INPUT
+#include "embedded_input.hpp"
+#endif
+
 namespace {
 
 struct Computer {
-    uint64_t aInit;
-    std::vector<uint8_t> program;
-
-    Computer(std::string_view input) {
-        auto lines  = input | Split('\n');
-        auto lineIt = lines.begin();
-        aInit       = ParseNumber<uint64_t>((*lineIt++).substr(12));
-        // b           = ParseNumber<uint8_t>((*lineIt++).substr(12));
-        // c           = ParseNumber<uint8_t>((*lineIt++).substr(12));
-        ++lineIt;
-        ++lineIt;
-        ++lineIt;
-        program = (*lineIt++).substr(9) | Split(',') | views::transform(ParseNumber<uint8_t>) | ranges::to_vector;
+    /// Fixed storage keeps Computer a literal type, so an embedded input is parsed while compiling
+    static constexpr std::size_t MAX_PROGRAM_SIZE = 32;
+
+    uint64_t aInit{0};
+    std::array<uint8_t, MAX_PROGRAM_SIZE> instructions{};
+    std::size_t programSize{0};
+
+    constexpr Computer(std::string_view input) {
+        // Registers B and C start at 0 in every input, only A and the program are read
+        aInit = ParseNumber<uint64_t>(input.substr(12, input.find('\n') - 12));
+        std::string_view programText = input.substr(input.find("Program: "sv) + "Program: "sv.size());
+        programText                  = programText.substr(0, programText.find('\n'));
+        while (!programText.empty()) {
+            const std::size_t comma = programText.find(',');
+            if (programSize == instructions.size()) {
+                ThrowError(std::errc::value_too_large);
+            }
+            instructions[programSize++] = ParseNumber<uint8_t>(programText.substr(0, comma));
+            programText.remove_prefix(comma == programText.npos ? programText.size() : comma + 1);
+        }
     }
 
+    [[nodiscard]] constexpr std::span<const uint8_t> program() const { return {instructions.data(), programSize}; }
+
     std::string run(const uint64_t init) const {
         struct {
             uint64_t a;
@@ -39,9 +52,10 @@ struct Computer {
             std::unreachable();
         };
 
-        while (pc != program.size()) {
-            const uint8_t opcode{program[pc++]};
-            const uint8_t literalOperand{program[pc++]};
+        const std::span<const uint8_t> code = program();
+        while (pc != code.size()) {
+            const uint8_t opcode{code[pc++]};
+            const uint8_t literalOperand{code[pc++]};
             switch (opcode) {
                 case 0: registers.a >>= comboOperand(literalOperand); break;
                 case 1: registers.b ^= literalOperand; break;
@@ -82,7 +96,7 @@ struct Computer {
 
     uint64_t reverse() const {
         uint64_t a{0};
-        for (const uint8_t outputByte : program | views::reverse) {
+        for (const uint8_t outputByte : program() | views::reverse) {
             const uint8_t b4 = outputByte;
             const uint8_t b3 = b4 ^ 7;
             uint8_t b1{0};
@@ -101,14 +115,27 @@ struct Computer {
     }
 };
 
-} // namespace
+constexpr Computer EXAMPLE{"Register A: 729\nRegister B: 0\nRegister C: 0\n\nProgram: 0,1,5,4,3,0\n"sv};
+static_assert(EXAMPLE.aInit == 729 && EXAMPLE.program().size() == 6 && EXAMPLE.program()[2] == 5);
+
+#ifdef AOC_EMBEDDED_INPUT
+constexpr Computer EMBEDDED_COMPUTER{EMBEDDED_INPUT};
+#endif
 
 void AocMain(std::string_view input) {
-    // input = test;
-    Computer computer(input);
+#ifdef AOC_EMBEDDED_INPUT
+    // The runner hands over the embedded input itself unless --input replaced it
+    const Computer computer = input.data() == EMBEDDED_INPUT.data() ? EMBEDDED_COMPUTER : Computer{input};
+#else
+    const Computer computer{input};
+#endif
     logger.solution("{}", computer.run(computer.aInit));
     logger.info("{}", computer.run2(computer.aInit));
     uint64_t a = computer.reverse();
     logger.solution("{}", a);
     logger.info("{}", computer.run(a));
-}
\ No newline at end of file
+}
+
+} // namespace
+
+AOC_REGISTER_SOLVER(chronospatial_computer, AocMain);
\ No newline at end of file
@@ -63,12 +63,102 @@ struct Machine {
     int64_t part2() const { return minimumPrizeCost({10000000000000, 10000000000000}); }
 };
 
-} // namespace
+/// Machines as columns of doubles, the layout the vector kernels load from
+struct MachineColumns {
+    std::vector<double> a0, a1, b0, b1, p0, p1;
+};
+
+/// Prize cost summed over the leading machines a kernel handles whole vectors of
+struct PartialCost {
+    int64_t cost;
+    size_t machines;
+};
+
+[[attr_target("avx2,fma")]] PartialCost PrizeCostAvx2(const MachineColumns& columns, double offset) {
+    const __m256d voffset{_mm256_set1_pd(offset)};
+    __m256d vacc = _mm256_set1_pd(0.0);
+    size_t i{0};
+    for (; i + 4 <= columns.p0.size(); i += 4) {
+        __m256d vp0 = _mm256_add_pd(voffset, _mm256_loadu_pd(&columns.p0[i]));
+        __m256d vp1 = _mm256_add_pd(voffset, _mm256_loadu_pd(&columns.p1[i]));
+        __m256d va0 = _mm256_loadu_pd(&columns.a0[i]);
+        __m256d va1 = _mm256_loadu_pd(&columns.a1[i]);
+        __m256d vb0 = _mm256_loadu_pd(&columns.b0[i]);
+        __m256d vb1 = _mm256_loadu_pd(&columns.b1[i]);
+
+        __m256d yNum = _mm256_fmsub_pd(va0, vp1, _mm256_mul_pd(va1, vp0));
+        __m256d yDen = _mm256_fmsub_pd(va0, vb1, _mm256_mul_pd(va1, vb0));
+        __m256d y    = _mm256_div_pd(yNum, yDen);
+        __m256d x    = _mm256_div_pd(_mm256_fnmadd_pd(vb0, y, vp0), va0);
+
+        __m256d yMask = _mm256_cmp_pd(y, _mm256_floor_pd(y), _CMP_EQ_OQ);
+        __m256d xMask = _mm256_cmp_pd(x, _mm256_floor_pd(x), _CMP_EQ_OQ);
+
+        __m256d vcost = _mm256_fmadd_pd(x, _mm256_set1_pd(3.0), y);
+        vacc          = _mm256_add_pd(vacc, _mm256_and_pd(vcost, _mm256_and_pd(xMask, yMask)));
+    }
+
+    vacc = _mm256_hadd_pd(vacc, _mm256_setzero_pd());
+    return {static_cast<int64_t>(_mm256_cvtsd_f64(vacc) + _mm_cvtsd_f64(_mm256_extractf128_pd(vacc, 1))), i};
+}
+
+/// Rounds every lane down. The masked form has a defined pass-through source, GCC 12 warns about the plain one
+[[attr_target("avx512f")]] inline __m512d Floor512(__m512d v) {
+    return _mm512_mask_roundscale_pd(v, 0xFF, v, _MM_FROUND_TO_NEG_INF);
+}
+
+[[attr_target("avx512f,avx512dq")]] PartialCost PrizeCostAvx512(const MachineColumns& columns, double offset) {
+    const __m512d voffset{_mm512_set1_pd(offset)};
+    __m512d vacc = _mm512_setzero_pd();
+    size_t i{0};
+    for (; i + 8 <= columns.p0.size(); i += 8) {
+        __m512d vp0 = _mm512_add_pd(voffset, _mm512_loadu_pd(&columns.p0[i]));
+        __m512d vp1 = _mm512_add_pd(voffset, _mm512_loadu_pd(&columns.p1[i]));
+        __m512d va0 = _mm512_loadu_pd(&columns.a0[i]);
+        __m512d va1 = _mm512_loadu_pd(&columns.a1[i]);
+        __m512d vb0 = _mm512_loadu_pd(&columns.b0[i]);
+        __m512d vb1 = _mm512_loadu_pd(&columns.b1[i]);
+
+        __m512d yNum = _mm512_fmsub_pd(va0, vp1, _mm512_mul_pd(va1, vp0));
+        __m512d yDen = _mm512_fmsub_pd(va0, vb1, _mm512_mul_pd(va1, vb0));
+        __m512d y    = _mm512_div_pd(yNum, yDen);
+        __m512d x    = _mm512_div_pd(_mm512_fnmadd_pd(vb0, y, vp0), va0);
+
+        // The compares yield mask registers that gate the add directly, only whole solutions count
+        const __mmask8 whole = _mm512_cmp_pd_mask(y, Floor512(y), _CMP_EQ_OQ) &
+                               _mm512_cmp_pd_mask(x, Floor512(x), _CMP_EQ_OQ);
+        vacc = _mm512_mask_add_pd(vacc, whole, vacc, _mm512_fmadd_pd(x, _mm512_set1_pd(3.0), y));
+    }
+
+    alignas(64) std::array<double, 8> lanes;
+    _mm512_store_pd(lanes.data(), vacc);
+    return {static_cast<int64_t>(ranges::accumulate(lanes, 0.0)), i};
+}
+
+/// Runs the widest kernel the active instruction set allows, the machines left over are solved one at a time
+int64_t PrizeCostSimd(const std::vector<Machine>& machines, const MachineColumns& columns, int64_t offset) {
+    PartialCost partial{0, 0};
+    switch (CpuFeatures::Active()) {
+    case IsaLevel::AVX512:
+        partial = PrizeCostAvx512(columns, static_cast<double>(offset));
+        break;
+    case IsaLevel::AVX2:
+        partial = PrizeCostAvx2(columns, static_cast<double>(offset));
+        break;
+    case IsaLevel::SCALAR:
+        break;
+    }
+    for (size_t i{partial.machines}; i < machines.size(); ++i) {
+        partial.cost += machines[i].minimumPrizeCost({offset, offset});
+    }
+    return partial.cost;
+}
 
 void AocMain(std::string_view input) {
     // input                         = test;
     std::vector<Machine> machines = StopWatch<std::micro>::Run("Parsing", [&] {
-        return input | Split("\n\n"sv) | views::transform(Constructor<Machine>{}) | ranges::to_vector;
+        const LineIndex machineStrings{input, "\n\n"sv};
+        return machineStrings | views::transform(Constructor<Machine>{}) | ranges::to_vector;
     });
 
     logger.solution("Part 1: {}", StopWatch<std::micro>::Run("Part 1", [&] {
@@ -78,53 +168,25 @@ void AocMain(std::string_view input) {
                         return ranges::accumulate(machines, int64_t{}, std::plus{}, &Machine::part2);
                     }));
 
-    std::vector<double> a0, a1, b0, b1, p0, p1;
+    MachineColumns columns;
     const auto deinterleave = [&machines](std::vector<double>& column, auto&& proj) {
         column.resize(machines.size());
         ranges::transform(machines, column.begin(), proj);
     };
-    deinterleave(a0, [](const Machine& m) { return m.a[0]; });
-    deinterleave(a1, [](const Machine& m) { return m.a[1]; });
-    deinterleave(b0, [](const Machine& m) { return m.b[0]; });
-    deinterleave(b1, [](const Machine& m) { return m.b[1]; });
-    deinterleave(p0, [](const Machine& m) { return m.prize[0]; });
-    deinterleave(p1, [](const Machine& m) { return m.prize[1]; });
+    deinterleave(columns.a0, [](const Machine& m) { return m.a[0]; });
+    deinterleave(columns.a1, [](const Machine& m) { return m.a[1]; });
+    deinterleave(columns.b0, [](const Machine& m) { return m.b[0]; });
+    deinterleave(columns.b1, [](const Machine& m) { return m.b[1]; });
+    deinterleave(columns.p0, [](const Machine& m) { return m.prize[0]; });
+    deinterleave(columns.p1, [](const Machine& m) { return m.prize[1]; });
 
     int64_t offset = 0;
-    __m256d voffset{_mm256_set1_pd(0.0)};
-    auto doSimd = [&] {
-        __m256d vacc = _mm256_set1_pd(0.0);
-        size_t i{0};
-        for (; i + 4 <= machines.size(); i += 4) {
-            __m256d vp0 = _mm256_add_pd(voffset, _mm256_loadu_pd(&p0[i]));
-            __m256d vp1 = _mm256_add_pd(voffset, _mm256_loadu_pd(&p1[i]));
-            __m256d va0 = _mm256_loadu_pd(&a0[i]);
-            __m256d va1 = _mm256_loadu_pd(&a1[i]);
-            __m256d vb0 = _mm256_loadu_pd(&b0[i]);
-            __m256d vb1 = _mm256_loadu_pd(&b1[i]);
-
-            __m256d yNum = _mm256_fmsub_pd(va0, vp1, _mm256_mul_pd(va1, vp0));
-            __m256d yDen = _mm256_fmsub_pd(va0, vb1, _mm256_mul_pd(va1, vb0));
-            __m256d y    = _mm256_div_pd(yNum, yDen);
-            __m256d x    = _mm256_div_pd(_mm256_fnmadd_pd(vb0, y, vp0), va0);
-
-            __m256d yMask = _mm256_cmp_pd(y, _mm256_floor_pd(y), _CMP_EQ_OQ);
-            __m256d xMask = _mm256_cmp_pd(x, _mm256_floor_pd(x), _CMP_EQ_OQ);
-
-                        __m256d vcost = _mm256_fmadd_pd(x, _mm256_set1_pd(3.0), y);
-            vacc          = _mm256_add_pd(vacc, _mm256_and_pd(vcost, _mm256_and_pd(xMask, yMask)));
-        }
-
-        vacc        = _mm256_hadd_pd(vacc, _mm256_setzero_pd());
-        int64_t acc = static_cast<int64_t>(_mm256_cvtsd_f64(vacc) + _mm_cvtsd_f64(_mm256_extractf128_pd(vacc, 1)));
-
-        for (; i < machines.size(); ++i) {
-            acc += machines[i].minimumPrizeCost({offset, offset});
-        }
-        return acc;
-    };
+    auto doSimd    = [&] { return PrizeCostSimd(machines, columns, offset); };
     logger.solution("Part 1 SIMD: {}", StopWatch<std::micro>::Run("Part 1 SIMD", doSimd));
-    offset  = 10000000000000;
-    voffset = _mm256_set1_pd(10000000000000);
+    offset = 10000000000000;
     logger.solution("Part 2 SIMD: {}", StopWatch<std::micro>::Run("Part 2 SIMD", doSimd));
-}
\ No newline at end of file
+}
+
+} // namespace
+
+AOC_REGISTER_SOLVER(claw_contraption, AocMain);
\ No newline at end of file
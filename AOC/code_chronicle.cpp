@@ -19,15 +19,13 @@ bool Fits(std::array<std::int8_t, 5> key, std::array<std::int8_t, 5> lock) {
     return fits;
 }
 
-} // namespace
-
 void AocMain(std::string_view input) {
     std::vector<std::array<std::int8_t, 5>> locks;
     locks.reserve(input.size() / (8 * 6));
     std::vector<std::array<std::int8_t, 5>> keys;
     locks.reserve(keys.size() / (8 * 6));
 
-    for (std::string_view lockOrKey : input | Split("\n\n"sv)) {
+    for (std::string_view lockOrKey : LineIndex{input, "\n\n"sv}) {
         if (lockOrKey.front() == '#') {
             locks.emplace_back(ParseLockOrKey<false>(lockOrKey));
         } else if (lockOrKey.front() == '.') {
@@ -42,4 +40,8 @@ void AocMain(std::string_view input) {
                         auto&& [key, lock] = combo;
                         return Fits(key, lock);
                     }));
-}
\ No newline at end of file
+}
+
+} // namespace
+
+AOC_REGISTER_SOLVER(code_chronicle, AocMain);
\ No newline at end of file
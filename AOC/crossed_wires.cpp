@@ -97,7 +97,7 @@ struct State {
     State(std::string_view input) {
         const size_t split = input.find("\n\n"sv);
 
-        for (std::string_view line : input.substr(0, split + 1) | Split('\n')) {
+        for (std::string_view line : LineIndex{input.substr(0, split + 1)}) {
             WireId id{line[0], line[1], line[2]};
             wires.emplace(id, Wire{
                                   .id   = id,
@@ -106,7 +106,7 @@ struct State {
                               });
         }
 
-        for (std::string_view line : input.substr(split + 2) | Split('\n')) {
+        for (std::string_view line : LineIndex{input.substr(split + 2)}) {
             auto tokens            = line | Split(' ');
             auto tokenIt           = tokens.begin();
             std::string_view token = *tokenIt++;
@@ -214,8 +214,6 @@ struct State {
     }
 };
 
-} // namespace
-
 void AocMain(std::string_view input) {
     // input = largeExample;
     State state{input};
@@ -224,4 +222,8 @@ void AocMain(std::string_view input) {
     logger.solution("{}", state.part1());
 
     state.part2();
-}
\ No newline at end of file
+}
+
+} // namespace
+
+AOC_REGISTER_SOLVER(crossed_wires, AocMain);
\ No newline at end of file
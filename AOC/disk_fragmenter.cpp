@@ -82,10 +82,12 @@ size_t MoveFiles(FileMap fileMap) {
     return Checksum(fileMap);
 }
 
-} // namespace
-
 void AocMain(std::string_view input) {
     FileMap fileMap = StopWatch<std::micro>::Run("Parse", Parse, input);
     logger.solution("FragmentFiles: {}", StopWatch<std::micro>::Run("FragmentFiles", FragmentFiles, fileMap));
     logger.solution("MoveFiles:     {}", StopWatch<std::milli>::Run("MoveFiles", MoveFiles, fileMap));
-}
\ No newline at end of file
+}
+
+} // namespace
+
+AOC_REGISTER_SOLVER(disk_fragmenter, AocMain);
\ No newline at end of file
@@ -8,9 +8,18 @@ template <class T>
 using PoolAlloc =
     boost::fast_pool_allocator<T, boost::default_user_allocator_new_delete, boost::details::pool::null_mutex>;
 
+constexpr int32_t HALO = 1;
+constexpr char OUTSIDE = '.';
+
+template <class Layout>
+using Garden = PaddedGrid<char, std::vector<char>, Layout>;
+template <class Layout>
+using CrawledGrid = PaddedGrid<uint8_t, std::vector<uint8_t>, Layout>;
+
+template <class Layout>
 class PlantCrawler {
-    const InputGrid<const char> garden;
-    const mdspan<uint8_t, dextents<int32_t, 2>> isCrawled;
+    const Garden<Layout>& garden;
+    CrawledGrid<Layout>& isCrawled;
     const char target;
 
     size_t area{0};
@@ -20,7 +29,7 @@ class PlantCrawler {
     std::array<std::vector<SideSet>, 4> sides;
 
 public:
-    PlantCrawler(InputGrid<const char> garden, mdspan<uint8_t, dextents<int32_t, 2>> isCrawled, char target)
+    PlantCrawler(const Garden<Layout>& garden, CrawledGrid<Layout>& isCrawled, char target)
         : garden(garden), isCrawled(isCrawled), target(target), sides{
                                                                     std::vector<SideSet>(garden.extent(0) + 2),
                                                                     std::vector<SideSet>(garden.extent(1) + 2),
@@ -38,9 +47,10 @@ public:
     size_t price1() const { return area * perimeter; }
     size_t price2() const { return area * countSides(); }
 
-    void crawl(const Index2D pos, const uint8_t direction) {
-        if (!InBounds(garden, pos) || garden(pos) != target) {
+    void crawl(const int32_t index, const uint8_t direction) {
+        if (garden[index] != target) {
             ++perimeter;
+            const Pos2D pos = garden.pos(index);
             if (direction & 1) {
                 sides[direction][pos.y() + 1] += pos.x();
             } else {
@@ -48,22 +58,21 @@ public:
             }
             return;
         }
-        if (std::exchange(isCrawled(pos), true)) {
+        if (std::exchange(isCrawled[index], true)) {
             return;
         }
         ++area;
-        crawl(pos + Index2D{-1, 0}, 0);
-        crawl(pos + Index2D{0, -1}, 1);
-        crawl(pos + Index2D{1, 0}, 2);
-        crawl(pos + Index2D{0, 1}, 3);
+        crawl(garden.step(index, STEP_UP), 0);
+        crawl(garden.step(index, STEP_LEFT), 1);
+        crawl(garden.step(index, STEP_DOWN), 2);
+        crawl(garden.step(index, STEP_RIGHT), 3);
     }
 };
 
-} // namespace
-
-void AocMain(std::string_view input) {
-    mdspan garden = ToGrid(input);
-    mdarray<uint8_t, dextents<int32_t, 2>> isCrawled(garden.extents());
+template <class Layout>
+std::pair<size_t, size_t> TotalPrices(std::string_view input) {
+    const auto garden = Garden<Layout>::FromInput(ToGrid(input), HALO, OUTSIDE);
+    CrawledGrid<Layout> isCrawled(garden.extents(), HALO, 0);
 
     size_t totalPrice1{0};
     size_t totalPrice2{0};
@@ -72,13 +81,23 @@ void AocMain(std::string_view input) {
             if (isCrawled(y, x)) {
                 continue;
             }
-            PlantCrawler crawler{garden, isCrawled, garden(y, x)};
-            crawler.crawl({y, x}, false);
+            PlantCrawler<Layout> crawler{garden, isCrawled, garden(y, x)};
+            crawler.crawl(garden.index(y, x), 0);
             totalPrice1 += crawler.price1();
             totalPrice2 += crawler.price2();
         }
     }
+    return {totalPrice1, totalPrice2};
+}
+
+void AocMain(std::string_view input) {
+    const auto [totalPrice1, totalPrice2] = WithGridLayout(
+        [input]<class Layout> { return StopWatch<std::micro>::Run("TotalPrices", TotalPrices<Layout>, input); });
 
     logger.solution("1: {}", totalPrice1);
     logger.solution("2: {}", totalPrice2);
 }
+
+} // namespace
+
+AOC_REGISTER_SOLVER(garden_groups, AocMain);
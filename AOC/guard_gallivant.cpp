@@ -1,98 +1,160 @@
 namespace {
 
-constexpr uint8_t RIGHT = 0b01000000;
-constexpr uint8_t DOWN  = 0b00010000;
-constexpr uint8_t LEFT  = 0b00000100;
-constexpr uint8_t UP    = 0b00000001;
-
-constexpr uint8_t VISITED = 0b01010101;
-constexpr uint8_t WALL    = 0b10101010;
-
-mdarray<uint8_t, dextents<int32_t, 2>> MakePatrolGrid(const InputGrid<const char> inputGrid) {
-    mdarray<uint8_t, dextents<int32_t, 2>> patrolGrid(inputGrid.extents());
-    for (int32_t y{0}; y < patrolGrid.extent(0); ++y) {
-        for (int32_t x{0}; x < patrolGrid.extent(1); ++x) {
-            patrolGrid(y, x) = inputGrid(y, x) == '#' ? WALL : 0;
-        }
+enum Heading : uint8_t { UP, RIGHT, DOWN, LEFT };
+
+constexpr std::array<Vec2D, 4> STEPS{{{-1, 0}, {0, 1}, {1, 0}, {0, -1}}};
+
+/// No extra obstruction, matches neither row nor column of any cell
+constexpr Pos2D NO_OBSTRUCTION{-1, -1};
+
+/// The walls twice, by row for east/west searches and transposed for north/south ones
+struct Walls {
+    BitGrid rows;
+    BitGrid columns;
+};
+
+Walls MakeWalls(const InputGrid<const char> inputGrid) {
+    BitGrid rows = BitGrid::FromInput(inputGrid, [](char cell) { return cell == '#'; });
+    return {rows, rows.transposed()};
+}
+
+/// <summary>
+/// Coordinate along the heading's axis of the first wall ahead of pos, counting the obstruction as a wall.
+/// -1 or the extent of that axis when the guard walks off the map instead.
+/// </summary>
+int32_t NextWall(const Walls& walls, const Pos2D& pos, Heading heading, const Pos2D& obstruction) {
+    switch (heading) {
+    case UP: {
+        const int32_t wall = walls.columns.prevInRow(pos.x(), pos.y() - 1);
+        return (obstruction.x() == pos.x() && obstruction.y() < pos.y()) ? std::max(wall, obstruction.y()) : wall;
+    }
+    case DOWN: {
+        const int32_t wall = walls.columns.nextInRow(pos.x(), pos.y() + 1);
+        return (obstruction.x() == pos.x() && obstruction.y() > pos.y()) ? std::min(wall, obstruction.y()) : wall;
+    }
+    case RIGHT: {
+        const int32_t wall = walls.rows.nextInRow(pos.y(), pos.x() + 1);
+        return (obstruction.y() == pos.y() && obstruction.x() > pos.x()) ? std::min(wall, obstruction.x()) : wall;
     }
-    return patrolGrid;
+    case LEFT: {
+        const int32_t wall = walls.rows.prevInRow(pos.y(), pos.x() - 1);
+        return (obstruction.y() == pos.y() && obstruction.x() < pos.x()) ? std::max(wall, obstruction.x()) : wall;
+    }
+    }
+    std::unreachable();
+}
+
+/// <summary>
+/// One straight run of the patrol: the last cell before the next wall, and whether the wall was the map edge.
+/// The cell in front of a wall at -1 or at the extent is the edge cell itself, so both cases share one formula.
+/// </summary>
+struct Leg {
+    Pos2D end;
+    bool leavesMap;
+};
+
+Leg WalkLeg(const Walls& walls, const Pos2D& pos, Heading heading, const Pos2D& obstruction) {
+    const int32_t wall   = NextWall(walls, pos, heading, obstruction);
+    const bool vertical  = heading == UP || heading == DOWN;
+    const int32_t extent = walls.rows.extent(vertical ? 0 : 1);
+    Pos2D end            = pos;
+    if (vertical) {
+        end.y() = wall - STEPS[heading].y();
+    } else {
+        end.x() = wall - STEPS[heading].x();
+    }
+    return {end, wall < 0 || wall >= extent};
 }
 
-const std::array<Index2D, 128> DIRECTION_VECTOR = [] {
-    std::array<Index2D, 128> init{};
-    init[UP]    = {-1, 0};
-    init[LEFT]  = {0, -1};
-    init[DOWN]  = {1, 0};
-    init[RIGHT] = {0, 1};
-    return init;
-}();
-
-size_t PatrolCoverage(const mdspan<uint8_t, dextents<int32_t, 2>> grid, Index2D pos) {
-    size_t coverage{0};
-    uint8_t direction{1};
-    while (pos[0] >= 0 && pos[0] < grid.extent(0) && pos[1] >= 0 && pos[1] < grid.extent(1)) {
-        uint8_t& cell{grid(pos)};
-        if (cell & WALL) {
-            pos -= DIRECTION_VECTOR[direction];
-            direction = std::rotr(direction, 2);
+/// Every cell the guard covers, whole horizontal legs are marked a word at a time
+BitGrid PatrolCoverage(const Walls& walls, Pos2D guard) {
+    BitGrid visited{walls.rows.extents()};
+    Heading heading{UP};
+    for (;;) {
+        const Leg leg = WalkLeg(walls, guard, heading, NO_OBSTRUCTION);
+        if (heading == UP || heading == DOWN) {
+            for (int32_t y{std::min(guard.y(), leg.end.y())}; y <= std::max(guard.y(), leg.end.y()); ++y) {
+                visited.set(y, guard.x());
+            }
         } else {
-            coverage += !(cell & VISITED);
-            cell |= VISITED;
-            pos += DIRECTION_VECTOR[direction];
+            visited.setRow(guard.y(), std::min(guard.x(), leg.end.x()), std::max(guard.x(), leg.end.x()) + 1);
+        }
+        if (leg.leavesMap) {
+            return visited;
         }
+        guard   = leg.end;
+        heading = static_cast<Heading>((heading + 1) % 4);
     }
-    return coverage;
 }
 
-bool PatrolLoops(const mdspan<uint8_t, dextents<int32_t, 2>> grid, Index2D pos) {
-    uint8_t direction{1};
-    while (pos[0] >= 0 && pos[0] < grid.extent(0) && pos[1] >= 0 && pos[1] < grid.extent(1)) {
-        uint8_t& cell{grid(pos)};
-        const uint8_t oldCell{cell};
-        cell = oldCell | direction;
-        if (oldCell & direction) [[unlikely]] {
-            return true;
+/// Cells where the guard turned, per heading, with a list of what to clear before the next patrol
+struct TurnMarks {
+    std::array<BitGrid, 4> turned;
+    std::vector<std::pair<Pos2D, Heading>> marked;
+
+    explicit TurnMarks(const dextents<int32_t, 2>& extents)
+        : turned{BitGrid{extents}, BitGrid{extents}, BitGrid{extents}, BitGrid{extents}} {}
+
+    void clear() {
+        for (const auto& [pos, heading] : marked) {
+            turned[heading].reset(pos);
         }
-        if (cell & WALL) {
-            pos -= DIRECTION_VECTOR[direction];
-            direction = std::rotr(direction, 2);
-        } else {
-            pos += DIRECTION_VECTOR[direction];
+        marked.clear();
+    }
+};
+
+/// Jumps from wall to wall, the patrol loops once the guard turns at the same cell with the same heading twice
+bool PatrolLoops(const Walls& walls, TurnMarks& marks, Pos2D guard, const Pos2D& obstruction) {
+    marks.clear();
+    Heading heading{UP};
+    for (;;) {
+        const Leg leg = WalkLeg(walls, guard, heading, obstruction);
+        if (leg.leavesMap) {
+            return false;
+        }
+        guard = leg.end;
+        if (marks.turned[heading].testAndSet(guard)) [[unlikely]] {
+            return true;
         }
+        marks.marked.emplace_back(guard, heading);
+        heading = static_cast<Heading>((heading + 1) % 4);
     }
-    return false;
 }
 
-size_t PossibleLoops(const mdarray<uint8_t, dextents<int32_t, 2>>& masterGrid,
-                     const mdspan<uint8_t, dextents<int32_t, 2>>& coverageGrid,
-                     const Index2D initialPos) {
-    size_t possibleLoops{0};
-    for (int32_t y{0}; y < masterGrid.extent(0); ++y) {
-        for (int32_t x{0}; x < masterGrid.extent(1); ++x) {
-            if (!coverageGrid(y, x)) {
-                continue;
+size_t PossibleLoops(const Walls& walls, const BitGrid& visited, const Pos2D& start) {
+    std::atomic<size_t> possibleLoops{0};
+    // Only cells on the original patrol can change it, each worker keeps its own turn marks
+    ParallelForWithScratch(
+        0, visited.extent(0), [&visited] { return TurnMarks{visited.extents()}; },
+        [&](TurnMarks& marks, int64_t row) {
+            const auto y = static_cast<int32_t>(row);
+            size_t rowLoops{0};
+            for (int32_t x{visited.nextInRow(y, 0)}; x < visited.extent(1); x = visited.nextInRow(y, x + 1)) {
+                const Pos2D obstruction{y, x};
+                if (obstruction != start) {
+                    rowLoops += PatrolLoops(walls, marks, start, obstruction);
+                }
             }
-            mdarray gridCopy = masterGrid;
-            gridCopy(y, x) |= WALL;
-            possibleLoops += PatrolLoops(gridCopy, initialPos);
-        }
-    }
+            possibleLoops.fetch_add(rowLoops, std::memory_order_relaxed);
+        });
     return possibleLoops;
 }
 
-} // namespace
-
 void AocMain(std::string_view input) {
     std::optional<StopWatch<std::micro>> setupStopwatch{"Setup"};
-    mdspan inputGrid = ToGrid(input);
-    size_t caretPos  = input.find('^');
-    const Index2D initialPos{caretPos / inputGrid.stride(0), caretPos % inputGrid.stride(0)};
-    const mdarray masterGrid = MakePatrolGrid(inputGrid);
-    mdarray coverageGrid     = masterGrid;
+    mdspan inputGrid  = ToGrid(input);
+    size_t caretPos   = input.find('^');
+    const Walls walls = MakeWalls(inputGrid);
+    const Pos2D start{static_cast<int32_t>(caretPos / inputGrid.stride(0)),
+                      static_cast<int32_t>(caretPos % inputGrid.stride(0))};
     setupStopwatch.reset();
 
-    logger.solution("PatrolCoverage: {}",
-                    StopWatch<std::micro>::Run("PatrolCoverage", PatrolCoverage, coverageGrid, initialPos));
+    const BitGrid visited = StopWatch<std::micro>::Run("PatrolCoverage", PatrolCoverage, walls, start);
+    logger.solution("PatrolCoverage: {}", visited.count());
     logger.solution("PossibleLoops:  {}",
-                    StopWatch<std::milli>::Run("PossibleLoops", PossibleLoops, masterGrid, coverageGrid, initialPos));
-}
\ No newline at end of file
+                    StopWatch<std::milli>::Run("PossibleLoops", PossibleLoops, walls, visited, start));
+}
+
+} // namespace
+
+AOC_REGISTER_SOLVER(guard_gallivant, AocMain);
@@ -1,12 +1,9 @@
-void AocMain(std::string_view input) {
-    std::vector<int32_t> leftList;
-    std::vector<int32_t> rightList;
+namespace {
 
-    for (auto line : input | Split('\n')) {
-        std::size_t space = line.find(' ');
-        leftList.emplace_back(ParseNumber<int32_t>(line.substr(0, space)));
-        rightList.emplace_back(ParseNumber<int32_t>(line.substr(space + 3)));
-    }
+/// Two numbers per line, alternating between the lists
+void Solve(std::span<const int32_t> numbers) {
+    std::vector<int32_t> leftList  = numbers | views::stride(2) | ranges::to_vector;
+    std::vector<int32_t> rightList = numbers | views::drop(1) | views::stride(2) | ranges::to_vector;
 
     ranges::sort(leftList);
     ranges::sort(rightList);
@@ -32,4 +29,21 @@ void AocMain(std::string_view input) {
         part2 += right * (greaterIt - rightIt);
     }
     logger.solution("{}", part2);
-}
\ No newline at end of file
+}
+
+void AocMain(std::string_view input) {
+    Solve(input | BulkParseNumbers<int32_t>);
+}
+
+/// Only the numbers are held, the text is read a chunk of whole lines at a time
+void AocStreamMain(InputStream& input) {
+    std::vector<int32_t> numbers;
+    for (std::string_view chunk = input.nextLines(); !chunk.empty(); chunk = input.nextLines()) {
+        BulkParseNumbers<int32_t>(chunk, numbers);
+    }
+    Solve(numbers);
+}
+
+} // namespace
+
+AOC_REGISTER_STREAM_SOLVER(historian_hysteria, AocMain, AocStreamMain);
\ No newline at end of file
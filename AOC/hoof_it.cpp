@@ -1,92 +1,93 @@
 namespace {
 
-int16_t ScoreTraverse(InputGrid<const char> map, mdspan<uint8_t, dextents<int32_t, 2>> traversedMap, Index2D pos,
-                      char target) {
-    if (!InBounds(map, pos)) {
-        return 0;
-    }
-    const char cell{map(pos)};
+constexpr int32_t HALO = 1;
+constexpr char OUTSIDE = '.';
+
+template <class Layout>
+using MapGrid = PaddedGrid<char, std::vector<char>, Layout>;
+template <class Layout>
+using ScoreGrid = PaddedGrid<uint8_t, std::pmr::vector<uint8_t>, Layout>;
+template <class Layout>
+using RatingGrid = PaddedGrid<int16_t, std::pmr::vector<int16_t>, Layout>;
+
+template <class Layout>
+int16_t ScoreTraverse(const MapGrid<Layout>& map, ScoreGrid<Layout>& traversedMap, int32_t index, char target) {
+    const char cell{map[index]};
     if (cell != target) {
         return 0;
     }
-    if (std::exchange(traversedMap(pos), true)) {
+    if (std::exchange(traversedMap[index], true)) {
         return 0;
     }
     if (cell == '9') {
         return 1;
     }
     int16_t score{};
-    score += ScoreTraverse(map, traversedMap, pos + Index2D{-1, 0}, target + 1);
-    score += ScoreTraverse(map, traversedMap, pos + Index2D{0, -1}, target + 1);
-    score += ScoreTraverse(map, traversedMap, pos + Index2D{0, 1}, target + 1);
-    score += ScoreTraverse(map, traversedMap, pos + Index2D{1, 0}, target + 1);
+    for (const GridStep step : GRID_STEPS) {
+        score += ScoreTraverse(map, traversedMap, map.step(index, step), target + 1);
+    }
     return score;
 }
 
-int16_t RateTraverse(InputGrid<const char> map, mdspan<int16_t, dextents<int32_t, 2>> traversedMap, Index2D pos,
-                     char target) {
-    if (!InBounds(map, pos)) {
-        return 0;
-    }
-    if (map(pos) != target) {
+template <class Layout>
+int16_t RateTraverse(const MapGrid<Layout>& map, RatingGrid<Layout>& traversedMap, int32_t index, char target) {
+    if (map[index] != target) {
         return 0;
     }
-    if (traversedMap(pos)) {
-        return (traversedMap(pos) < 0) ? 0 : traversedMap(pos);
+    if (traversedMap[index]) {
+        return (traversedMap[index] < 0) ? 0 : traversedMap[index];
     }
     int16_t rating{0};
-    rating += RateTraverse(map, traversedMap, pos + Index2D{-1, 0}, target + 1);
-    rating += RateTraverse(map, traversedMap, pos + Index2D{0, -1}, target + 1);
-    rating += RateTraverse(map, traversedMap, pos + Index2D{0, 1}, target + 1);
-    rating += RateTraverse(map, traversedMap, pos + Index2D{1, 0}, target + 1);
-    traversedMap(pos) = (rating == 0) ? -1 : rating;
+    for (const GridStep step : GRID_STEPS) {
+        rating += RateTraverse(map, traversedMap, map.step(index, step), target + 1);
+    }
+    traversedMap[index] = (rating == 0) ? -1 : rating;
     return rating;
 }
 
+template <class Layout>
 int64_t TotalScore(std::string_view input) {
-    const mdspan map = ToGrid(input);
+    const auto map = MapGrid<Layout>::FromInput(ToGrid(input), HALO, OUTSIDE);
+    ScoreGrid<Layout> traversedMap(map.extents(), HALO, 0, &Arena::Current());
     int64_t totalScore{0};
-    for (size_t trailheadIndex = input.find('0'); trailheadIndex < input.size();
-         trailheadIndex        = input.find('0', trailheadIndex + 1)) {
-        mdarray<uint8_t, dextents<int32_t, 2>> traversedMap(map.extents());
-        Index2D pos{
-            static_cast<int32_t>(trailheadIndex / map.stride(0)),
-            static_cast<int32_t>(trailheadIndex % map.stride(0)),
-        };
-        int16_t score{ScoreTraverse(map, traversedMap, pos, '0')};
-        totalScore += score;
+    for (int32_t trailheadIndex{0}; trailheadIndex < std::ssize(map.cells()); ++trailheadIndex) {
+        if (map[trailheadIndex] != '0') {
+            continue;
+        }
+        ranges::fill(traversedMap.cells(), uint8_t{0});
+        totalScore += ScoreTraverse(map, traversedMap, trailheadIndex, '0');
     }
     return totalScore;
 }
 
+template <class Layout>
 int64_t TotalRating(std::string_view input) {
-    const mdspan map = ToGrid(input);
-    mdarray<int16_t, dextents<int32_t, 2>> masterTraverseMap(map.extents());
-    for (size_t peakIndex = input.find('9'); peakIndex < input.size(); peakIndex = input.find('9', peakIndex + 1)) {
-        Index2D pos{
-            static_cast<int32_t>(peakIndex / map.stride(0)),
-            static_cast<int32_t>(peakIndex % map.stride(0)),
-        };
-        masterTraverseMap.to_mdspan()(pos) = 1;
+    const auto map = MapGrid<Layout>::FromInput(ToGrid(input), HALO, OUTSIDE);
+    RatingGrid<Layout> masterTraverseMap(map.extents(), HALO, 0, &Arena::Current());
+    for (int32_t peakIndex{0}; peakIndex < std::ssize(map.cells()); ++peakIndex) {
+        masterTraverseMap[peakIndex] = (map[peakIndex] == '9') ? 1 : 0;
     }
 
     int64_t totalRating{0};
-    for (size_t trailheadIndex = input.find('0'); trailheadIndex < input.size();
-         trailheadIndex        = input.find('0', trailheadIndex + 1)) {
-        mdarray traversedMap = masterTraverseMap;
-        Index2D pos{
-            static_cast<int32_t>(trailheadIndex / map.stride(0)),
-            static_cast<int32_t>(trailheadIndex % map.stride(0)),
-        };
-        int16_t rating{RateTraverse(map, traversedMap, pos, '0')};
-        totalRating += rating;
+    // One scratch map refilled per trailhead rather than a fresh copy each time
+    RatingGrid<Layout> traversedMap(map.extents(), HALO, 0, &Arena::Current());
+    for (int32_t trailheadIndex{0}; trailheadIndex < std::ssize(map.cells()); ++trailheadIndex) {
+        if (map[trailheadIndex] != '0') {
+            continue;
+        }
+        ranges::copy(masterTraverseMap.cells(), traversedMap.cells().begin());
+        totalRating += RateTraverse(map, traversedMap, trailheadIndex, '0');
     }
     return totalRating;
 }
 
+void AocMain(std::string_view input) {
+    WithGridLayout([input]<class Layout> {
+        logger.solution("TotalScore:  {}", StopWatch<std::micro>::Run("TotalScore", TotalScore<Layout>, input));
+        logger.solution("TotalRating: {}", StopWatch<std::micro>::Run("TotalRating", TotalRating<Layout>, input));
+    });
+}
+
 } // namespace
 
-void AocMain(std::string_view input) {
-    logger.solution("TotalScore:  {}", StopWatch<std::micro>::Run("TotalScore", TotalScore, input));
-    logger.solution("TotalRating: {}", StopWatch<std::micro>::Run("TotalRating", TotalRating, input));
-}
\ No newline at end of file
+AOC_REGISTER_SOLVER(hoof_it, AocMain);
\ No newline at end of file
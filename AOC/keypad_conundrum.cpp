@@ -132,12 +132,14 @@ struct Solver {
     }
 };
 
-} // namespace
-
 void AocMain(std::string_view input) {
     auto codes = input | Split('\n');
     logger.solution("Part 1: {}",
                     StopWatch<std::micro>::Run("2 layers", [&codes] { return Solver{2}.complexitySum(codes); }));
     logger.solution("Part 2: {}",
                     StopWatch<std::micro>::Run("25 layers", [&codes] { return Solver{25}.complexitySum(codes); }));
-}
\ No newline at end of file
+}
+
+} // namespace
+
+AOC_REGISTER_SOLVER(keypad_conundrum, AocMain);
\ No newline at end of file
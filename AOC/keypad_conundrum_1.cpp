@@ -161,8 +161,6 @@ size_t Complexity(std::string_view input) {
     return minMoves.size() * num;
 }
 
-} // namespace
-
 void AocMain(std::string_view input) {
     //input = test;
 
@@ -174,4 +172,8 @@ void AocMain(std::string_view input) {
     // v<<A>>^AvA^Av<<A>>^AAv<A<A>>^AAvAA<^A>Av<A>^AA<A>Av<A<A>>^AAAvA<^A>A
 
     logger.solution("{}", ranges::accumulate(input | Split('\n'), size_t{}, std::plus{}, Complexity));
-}
\ No newline at end of file
+}
+
+} // namespace
+
+AOC_REGISTER_SOLVER(keypad_conundrum_1, AocMain);
\ No newline at end of file
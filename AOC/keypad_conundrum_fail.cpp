@@ -219,8 +219,6 @@ size_t Complexity(std::string_view input) {
     return num * minLen;
 }
 
-} // namespace
-
 void AocMain(std::string_view input) {
     input = test;
 
@@ -232,4 +230,8 @@ void AocMain(std::string_view input) {
     // v<<A>>^AvA^Av<<A>>^AAv<A<A>>^AAvAA<^A>Av<A>^AA<A>Av<A<A>>^AAAvA<^A>A
 
     logger.solution("{}", ranges::accumulate(input | Split('\n'), size_t{}, std::plus{}, Complexity<25>));
-}
\ No newline at end of file
+}
+
+} // namespace
+
+AOC_REGISTER_SOLVER(keypad_conundrum_fail, AocMain);
\ No newline at end of file
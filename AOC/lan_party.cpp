@@ -1,7 +1,5 @@
 namespace {
 
-std::pmr::unsynchronized_pool_resource pool;
-
 using NodeId = std::array<char, 2>;
 struct CompareNodeId {
     constexpr bool operator()(NodeId lhs, NodeId rhs) const noexcept {
@@ -10,7 +8,7 @@ struct CompareNodeId {
 };
 
 using IdSet         = boost::container::flat_set<NodeId, CompareNodeId, boost::container::static_vector<NodeId, 13>>;
-using ConnectionMap = boost::unordered_flat_map<NodeId, IdSet>;
+using ConnectionMap = boost::unordered_flat_map<NodeId, IdSet, CrcHash>;
 
 ConnectionMap Parse(std::string_view input) {
     ConnectionMap connectionMap;
@@ -50,8 +48,9 @@ std::string Password(const ConnectionMap& connectionMap) {
         }
         using IntersectionMap = boost::container::flat_map<IdSet, IdSet, std::less<IdSet>,
                                                            std::pmr::polymorphic_allocator<std::pair<IdSet, IdSet>>>;
-        IntersectionMap prevIntersectionMap{{{aId}, aConn}};
-        IntersectionMap nextIntersectionMap{};
+        IntersectionMap prevIntersectionMap{&Arena::Current()};
+        prevIntersectionMap.emplace(IdSet{aId}, aConn);
+        IntersectionMap nextIntersectionMap{&Arena::Current()};
         while (!prevIntersectionMap.empty()) {
             for (const auto& [keySet, valSet] : prevIntersectionMap) {
                 if (keySet.size() > maxGroup.size()) {
@@ -80,13 +79,12 @@ std::string Password(const ConnectionMap& connectionMap) {
     return maxGroup | views::transform(Constructor<std::string_view>{}) | views::join(',') | ranges::to<std::string>;
 };
 
-} // namespace
-
 void AocMain(std::string_view input) {
-    std::pmr::set_default_resource(&pool);
     const ConnectionMap connectionMap = StopWatch<std::micro>::Run("Parse", Parse, input);
     logger.solution("Group of 3 Count: {}", StopWatch<std::micro>::Run("TriGroupCount", TriGroupCount, connectionMap));
-    for (int i{0}; i < 1000; ++i) {
-        logger.solution("Password: {}", StopWatch<std::milli>::Run("Password", Password, connectionMap));
-    }
-}
\ No newline at end of file
+    logger.solution("Password: {}", StopWatch<std::milli>::Run("Password", Password, connectionMap));
+}
+
+} // namespace
+
+AOC_REGISTER_SOLVER(lan_party, AocMain);
\ No newline at end of file
@@ -2,7 +2,7 @@ namespace {
 
 struct State {
     std::array<std::vector<std::string_view>, 128> rawPatterns;
-    mutable boost::unordered_flat_map<std::string_view, size_t> patternCache;
+    mutable boost::unordered_flat_map<std::string_view, size_t, WyHash> patternCache;
     std::vector<std::string_view> designs;
 
     State(std::string_view input) {
@@ -57,7 +57,6 @@ struct State {
     size_t part1() const {
         return ranges::count_if(designs, [this](std::string_view design) {
             logger.info("{}", design);
-            logger.flush();
             return designIsPossible(design);
         });
     }
@@ -68,10 +67,12 @@ struct State {
     }
 };
 
-} // namespace
-
 void AocMain(std::string_view input) {
     State state{input};
     logger.solution("Part 2: {}", StopWatch<std::micro>::Run("Part 2", &State::part2, state));
     logger.solution("Part 1: {}", StopWatch<std::micro>::Run("Part 1", &State::part1, state));
-}
\ No newline at end of file
+}
+
+} // namespace
+
+AOC_REGISTER_SOLVER(linen_layout, AocMain);
\ No newline at end of file
@@ -52,10 +52,12 @@ struct State {
     }
 };
 
-} // namespace
-
 void AocMain(std::string_view input) {
     //input = test;
     State state{input};
     logger.solution("Part 1: {}", StopWatch<std::micro>::Run("Part 1", &State::part1, state));
-}
\ No newline at end of file
+}
+
+} // namespace
+
+AOC_REGISTER_SOLVER(linen_layout_part1, AocMain);
\ No newline at end of file
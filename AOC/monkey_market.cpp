@@ -17,8 +17,8 @@ uint64_t Part1(std::span<const uint32_t> buyers) {
     });
 }
 
-boost::unordered_flat_map<std::array<int8_t, 4>, int8_t> EncodeBuyer(uint32_t secret) {
-    boost::unordered_flat_map<std::array<int8_t, 4>, int8_t> priceMap;
+boost::unordered_flat_map<std::array<int8_t, 4>, int8_t, CrcHash> EncodeBuyer(uint32_t secret) {
+    boost::unordered_flat_map<std::array<int8_t, 4>, int8_t, CrcHash> priceMap;
     std::array<int8_t, 4> changeSequence{};
     int8_t previousPrice{0};
     const auto Push = [&](auto updateMap) {
@@ -46,20 +46,45 @@ boost::unordered_flat_map<std::array<int8_t, 4>, int8_t> EncodeBuyer(uint32_t se
 }
 
 int64_t Part2(std::span<const uint32_t> buyers) {
-    boost::unordered_flat_map<std::array<int8_t, 4>, int64_t> totalPriceMap;
-    for (const uint32_t buyer : buyers) {
-        auto priceMap = EncodeBuyer(buyer);
-        for (const auto [changeSequence, price] : priceMap) {
+    using TotalPriceMap = boost::unordered_flat_map<std::array<int8_t, 4>, int64_t, CrcHash>;
+    // Buyers are summed into one map per worker, the maps are merged once at the end
+    std::vector<TotalPriceMap> workerPriceMaps = ParallelForWithScratch(
+        0, std::ssize(buyers), [] { return TotalPriceMap{}; },
+        [&buyers](TotalPriceMap& workerPriceMap, int64_t b) {
+            for (const auto [changeSequence, price] : EncodeBuyer(buyers[b])) {
+                workerPriceMap[changeSequence] += price;
+            }
+        });
+    if (workerPriceMaps.empty()) {
+        return 0;
+    }
+    TotalPriceMap& totalPriceMap = workerPriceMaps.front();
+    for (const TotalPriceMap& workerPriceMap : workerPriceMaps | views::drop(1)) {
+        for (const auto [changeSequence, price] : workerPriceMap) {
             totalPriceMap[changeSequence] += price;
         }
     }
     return ranges::max_element(totalPriceMap, std::less{}, [](const auto& e) { return e.second; })->second;
 }
 
-} // namespace
-
-void AocMain(std::string_view input) {
-    std::vector<uint32_t> buyers = input | ParseNumbers<uint32_t> | ranges::to_vector;
+void Solve(std::span<const uint32_t> buyers) {
     logger.solution("Part 1: {}", StopWatch<std::milli>::Run("Part 1", Part1, buyers));
     logger.solution("Part 2: {}", StopWatch<std::milli>::Run("Part 2", Part2, buyers));
-}
\ No newline at end of file
+}
+
+void AocMain(std::string_view input) {
+    Solve(input | BulkParseNumbers<uint32_t>);
+}
+
+/// Only the secrets are held, the text is read a chunk of whole lines at a time
+void AocStreamMain(InputStream& input) {
+    std::vector<uint32_t> buyers;
+    for (std::string_view chunk = input.nextLines(); !chunk.empty(); chunk = input.nextLines()) {
+        BulkParseNumbers<uint32_t>(chunk, buyers);
+    }
+    Solve(buyers);
+}
+
+} // namespace
+
+AOC_REGISTER_STREAM_SOLVER(monkey_market, AocMain, AocStreamMain);
\ No newline at end of file
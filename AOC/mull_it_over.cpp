@@ -52,9 +52,71 @@ int64_t Run2(std::string_view input) {
     return sum;
 }
 
-} // namespace
+/// <summary>
+/// Both parts in one pass over the input, for text that arrives a chunk at a time. Scan stops short of a token that
+/// may continue into the next chunk and returns how many bytes it left for it.
+/// </summary>
+struct StreamScanner {
+    /// "mul(123,456)", the longest token
+    static constexpr std::size_t MAX_TOKEN_SIZE = 12;
+
+    int64_t sum1{0};
+    int64_t sum2{0};
+    bool enabled{true};
+
+    /// Value of 1 to 3 digits at the front of text followed by terminator, the length consumed is added to length
+    static std::optional<int64_t> Operand(std::string_view text, char terminator, std::size_t& length) {
+        const std::size_t numberLen = ranges::find_if_not(text, IsDigit) - text.begin();
+        if (numberLen == 0 || numberLen > 3 || numberLen == text.size() || text[numberLen] != terminator) {
+            return std::nullopt;
+        }
+        length += numberLen + 1;
+        return ParseNumber<int64_t>(text.substr(0, numberLen));
+    }
+
+    std::size_t scan(std::string_view chunk, bool last) {
+        std::size_t pos{0};
+        while ((pos = chunk.find_first_of("md"sv, pos)) != chunk.npos) {
+            if (!last && chunk.size() - pos < MAX_TOKEN_SIZE) {
+                return chunk.size() - pos;
+            }
+            const std::string_view text = chunk.substr(pos);
+            if (text.starts_with("mul("sv)) {
+                std::size_t length{"mul("sv.size()};
+                const std::optional<int64_t> lhs = Operand(text.substr(length), ',', length);
+                const std::optional<int64_t> rhs = lhs ? Operand(text.substr(length), ')', length) : std::nullopt;
+                if (rhs) {
+                    sum1 += *lhs * *rhs;
+                    sum2 += enabled ? *lhs * *rhs : 0;
+                    pos += length;
+                    continue;
+                }
+            } else if (text.starts_with("do()"sv)) {
+                enabled = true;
+            } else if (text.starts_with("don't()"sv)) {
+                enabled = false;
+            }
+            ++pos;
+        }
+        return 0;
+    }
+};
 
 void AocMain(std::string_view input) {
     logger.solution("{}", StopWatch<std::micro>::Run("Part 1", Run1, input));
     logger.solution("{}", StopWatch<std::micro>::Run("Part 2", Run2, input));
 }
+
+void AocStreamMain(InputStream& input) {
+    StreamScanner scanner;
+    std::size_t unconsumed{0};
+    for (std::string_view chunk = input.next(); !chunk.empty(); chunk = input.next(unconsumed)) {
+        unconsumed = scanner.scan(chunk, input.atEnd());
+    }
+    logger.solution("{}", scanner.sum1);
+    logger.solution("{}", scanner.sum2);
+}
+
+} // namespace
+
+AOC_REGISTER_STREAM_SOLVER(mull_it_over, AocMain, AocStreamMain);
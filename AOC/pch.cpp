@@ -1,49 +1,473 @@
-#include <fstream>
+#include "Input.hpp"
 
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
 #ifdef WIN32
 #include <Windows.h>
 #endif
 
-Logger logger;
+BenchmarkOptions Benchmark::options;
+thread_local bool Benchmark::sampling;
+thread_local std::vector<void (*)()> Benchmark::sampleResets;
 
 namespace {
 
-std::string LoadInput() {
-    std::ifstream inputFile{"input.txt", std::ios::binary};
-    return std::string{std::istreambuf_iterator{inputFile}, {}};
+constexpr std::string_view USAGE = R"(Usage: [options] [day...]
+Runs the given days, or every linked day.
+
+  --input <path|->          Input file of a single day, '-' reads stdin. With several days, the directory
+                            holding <day>/input.txt
+  --repeat N                Runs each day N times on the same input
+  --stream[=BYTES]          Reads the input in chunks of BYTES (1 MiB by default) for days that can stream it
+  --parallel                Runs the days concurrently on the thread pool
+  --threads N               Thread pool size, every hardware thread by default
+  --pin-threads             Pins each pool worker to its own allowed CPU
+  --pin-cpu K               Pins the process to CPU K, pool workers inherit it and default to 1 thread
+  --fifo[=PRIORITY]         SCHED_FIFO at PRIORITY (1 by default), needs CAP_SYS_NICE
+  --format text|json        Log line format
+  --quiet-solutions         Drops solution lines
+  --perf-counters           Hardware counters on every StopWatch line
+  --benchmark[=SPEC]        Repeats sections, SPEC is warmup=N,iterations=N,budget=SECONDS
+  --trace <path>            Writes every StopWatch section as Chrome trace JSON, opens in Perfetto
+  --isa scalar|avx2|avx512  Caps the dispatched kernels at an instruction set, the widest supported by default
+  --no-huge-pages           Maps large grids with the default page size, to compare against huge pages
+  --huge-pages-stats        Reports how much of the large grids huge pages backed, holding freed grids until then
+  --layout row|tiled|morton Memory layout of the grids of days that can switch, row-major by default
+  --expect <path>           Compares each day's solution lines with its entry in an expected answers file
+  --bless                   Writes this run's solution lines into the --expect file, and its section timings
+                            with headroom into the --budgets file, instead of checking them
+  --budgets <path>          Fails a day whose sections run over their budgets in the file
+  --history <path>          Compares section timings with earlier runs in a CSV file, then appends them
+  --regression-threshold F  Slowdown over the --history median that fails a section, 0.25 by default
+  --help                    Prints this text
+)";
+
+struct SuiteOptions {
+    std::vector<const SolverRegistration*> solvers;
+    std::optional<std::filesystem::path> input;
+    unsigned repeat{1};
+    std::optional<std::size_t> streamChunkSize;
+    std::optional<unsigned> pinCpu;
+    std::optional<int> fifoPriority;
+    std::optional<std::filesystem::path> tracePath;
+    bool parallel{false};
+    bool help{false};
+};
+
+std::filesystem::path InputPath(const SolverRegistration& solver, const SuiteOptions& options) {
+    if (options.input && options.solvers.size() == 1) {
+        return *options.input;
+    }
+    if (options.input) {
+        return *options.input / solver.name / "input.txt";
+    }
+    // A standalone day runs next to its own input.txt, aoc_all runs from the build root
+    if (SolverRegistry::All().size() == 1) {
+        return "input.txt";
+    }
+    return std::filesystem::path{solver.name} / "input.txt";
+}
+
+InputBuffer LoadInput(const std::filesystem::path& path) {
+    if (path == "-") {
+        InputBuffer input = InputBuffer::LoadStdin();
+        logger.perf("LoadInput stdin {} bytes", input.view().size());
+        return input;
+    }
+    InputBuffer input = InputBuffer::Load(path);
+    logger.perf("LoadInput {} {} bytes", input.isMapped() ? "mapped" : "read", input.view().size());
+    return input;
+}
+
+/// Reopens the input for every run, the day's memory stays at the chunk buffer however large the input is
+void StreamSolver(const SolverRegistration& solver, const SuiteOptions& options) {
+    const std::filesystem::path path = InputPath(solver, options);
+    for (unsigned run{0}; run < options.repeat; ++run) {
+        Arena runArena;
+        const Arena::Scope arenaScope{runArena};
+        StopWatch<std::milli> aocMainStopWatch{
+            options.repeat == 1 ? "AocMain"s : std::format("AocMain {}/{}", run + 1, options.repeat)};
+        InputStream input = InputStream::Open(path, *options.streamChunkSize);
+        solver.streamSolver(input);
+        logger.perf("Streamed {} bytes through a {} byte buffer", input.bytesRead(), input.bufferSize());
+    }
+}
+
+void RunSolver(const SolverRegistration& solver, const SuiteOptions& options) {
+    // Restored on return, a worker waiting inside one day may run another day's task
+    const std::string_view previousContext = Logger::context;
+    if (SolverRegistry::All().size() > 1) {
+        Logger::context = solver.name;
+    }
+    if (options.streamChunkSize && solver.streamSolver != nullptr) {
+        StreamSolver(solver, options);
+        Logger::context = previousContext;
+        return;
+    }
+    // An input compiled into the binary needs no I/O at all, unless --input asks for another one
+    const std::optional<std::string_view> embeddedInput =
+        options.input ? std::nullopt : SolverRegistry::EmbeddedInput(solver.name);
+    // Plain scopes rather than Run, benchmark mode repeats the sections inside the day instead.
+    // The input is loaded once, stdin can only be read once.
+    const InputBuffer inputBuffer = [&] {
+        StopWatch<std::micro> loadStopWatch{"LoadInput"};
+        if (embeddedInput) {
+            logger.perf("LoadInput embedded {} bytes", embeddedInput->size());
+            return InputBuffer{};
+        }
+        return LoadInput(InputPath(solver, options));
+    }();
+    const std::string_view input = embeddedInput.value_or(inputBuffer.view());
+    for (unsigned run{0}; run < options.repeat; ++run) {
+        // Everything the day allocates through Arena::Current() is freed in one go when the run ends
+        Arena runArena;
+        const Arena::Scope arenaScope{runArena};
+        StopWatch<std::milli> aocMainStopWatch{
+            options.repeat == 1 ? "AocMain"s : std::format("AocMain {}/{}", run + 1, options.repeat)};
+        solver.solver(input);
+    }
+    Logger::context = previousContext;
+}
+
+void RunSuite(const SuiteOptions& options) {
+    const std::span<const SolverRegistration* const> solvers{options.solvers};
+    if (!options.parallel || solvers.size() == 1) {
+        for (const SolverRegistration* solver : solvers) {
+            RunSolver(*solver, options);
+        }
+        return;
+    }
+    // One task per day, days that run parallel loops of their own share the same workers
+    ParallelFor(0, std::ssize(solvers), [&](int64_t s) { RunSolver(*solvers[s], options); }, 1);
 }
 
-inline void AocMainInternal() {
+SuiteOptions ParseOptions(std::span<const char* const> args) {
+    SuiteOptions options;
+    if (const char* benchmarkSpec = std::getenv("AOC_BENCHMARK")) {
+        Benchmark::options = BenchmarkOptions::Parse(benchmarkSpec);
+    }
+    PerfCounters::enabled = std::getenv("AOC_PERF_COUNTERS") != nullptr;
+    if (const char* tracePath = std::getenv("AOC_TRACE")) {
+        options.tracePath = tracePath;
+    }
+    const auto selectIsa = [](std::string_view name) {
+        const std::optional<IsaLevel> level = CpuFeatures::Parse(name);
+        if (!level) {
+            throw std::invalid_argument{std::format("Unknown instruction set: {}", name)};
+        }
+        CpuFeatures::Select(*level);
+    };
+    if (const char* isa = std::getenv("AOC_ISA")) {
+        selectIsa(isa);
+    }
+    ThreadPool::Options poolOptions;
+    Logger::Options logOptions;
+    for (std::size_t a{0}; a < args.size(); ++a) {
+        const std::string_view arg{args[a]};
+        // Options taking a value accept both "--name value" and "--name=value"
+        const auto value = [&](std::string_view name) -> std::optional<std::string_view> {
+            if (arg.starts_with(name) && arg.size() > name.size() && arg[name.size()] == '=') {
+                return arg.substr(name.size() + 1);
+            }
+            if (arg != name) {
+                return std::nullopt;
+            }
+            if (++a == args.size()) {
+                throw std::invalid_argument{std::format("{} needs a value", name)};
+            }
+            return args[a];
+        };
+
+        if (arg == "--help"sv || arg == "-h"sv) {
+            options.help = true;
+        } else if (arg == "--parallel"sv) {
+            options.parallel = true;
+        } else if (const std::optional<std::string_view> input = value("--input"sv)) {
+            options.input = *input;
+        } else if (const std::optional<std::string_view> repeat = value("--repeat"sv)) {
+            options.repeat = std::max(1u, ParseNumber<unsigned>(*repeat));
+        } else if (arg == "--stream"sv) {
+            options.streamChunkSize = InputStream::DEFAULT_CHUNK_SIZE;
+        } else if (arg.starts_with("--stream="sv)) {
+            options.streamChunkSize =
+                std::max(std::size_t{1}, ParseNumber<std::size_t>(arg.substr("--stream="sv.size())));
+        } else if (const std::optional<std::string_view> threads = value("--threads"sv)) {
+            poolOptions.threadCount = ParseNumber<unsigned>(*threads);
+        } else if (arg == "--pin-threads"sv) {
+            poolOptions.pinThreads = true;
+        } else if (const std::optional<std::string_view> cpu = value("--pin-cpu"sv)) {
+            options.pinCpu = ParseNumber<unsigned>(*cpu);
+        } else if (arg == "--fifo"sv) {
+            options.fifoPriority = 1;
+        } else if (arg.starts_with("--fifo="sv)) {
+            options.fifoPriority = ParseNumber<int>(arg.substr("--fifo="sv.size()));
+        } else if (const std::optional<std::string_view> format = value("--format"sv)) {
+            if (*format == "text"sv) {
+                logOptions.format = LogFormat::TEXT;
+            } else if (*format == "json"sv) {
+                logOptions.format = LogFormat::JSON;
+            } else {
+                throw std::invalid_argument{std::format("Unknown format: {}", *format)};
+            }
+        } else if (arg == "--quiet-solutions"sv) {
+            logOptions.quietSolutions = true;
+        } else if (arg == "--perf-counters"sv) {
+            PerfCounters::enabled = true;
+        } else if (arg == "--benchmark"sv) {
+            Benchmark::options = BenchmarkOptions::Parse({});
+        } else if (arg.starts_with("--benchmark="sv)) {
+            Benchmark::options = BenchmarkOptions::Parse(arg.substr("--benchmark="sv.size()));
+        } else if (const std::optional<std::string_view> tracePath = value("--trace"sv)) {
+            options.tracePath = *tracePath;
+        } else if (const std::optional<std::string_view> isa = value("--isa"sv)) {
+            selectIsa(*isa);
+        } else if (arg == "--no-huge-pages"sv) {
+            HugePages::enabled = false;
+        } else if (arg == "--huge-pages-stats"sv) {
+            HugePages::sampleBacking = true;
+        } else if (const std::optional<std::string_view> layoutName = value("--layout"sv)) {
+            const std::optional<GridLayout> layout = GridLayouts::Parse(*layoutName);
+            if (!layout) {
+                throw std::invalid_argument{std::format("Unknown grid layout: {}", *layoutName)};
+            }
+            GridLayouts::selected = *layout;
+        } else if (const std::optional<std::string_view> answers = value("--expect"sv)) {
+            Regression::options.answers = *answers;
+        } else if (arg == "--bless"sv) {
+            Regression::options.bless = true;
+        } else if (const std::optional<std::string_view> budgets = value("--budgets"sv)) {
+            Regression::options.budgets = *budgets;
+        } else if (const std::optional<std::string_view> history = value("--history"sv)) {
+            Regression::options.history = *history;
+        } else if (const std::optional<std::string_view> threshold = value("--regression-threshold"sv)) {
+            Regression::options.threshold = ParseNumber<double>(*threshold);
+        } else if (const SolverRegistration* solver = SolverRegistry::Find(arg)) {
+            options.solvers.push_back(solver);
+        } else {
+            throw std::invalid_argument{std::format("Unknown day or option: {}", arg)};
+        }
+    }
+    const RegressionOptions& regression = Regression::options;
+    if (regression.bless && !regression.answers && !regression.budgets) {
+        throw std::invalid_argument{"--bless needs --expect or --budgets"};
+    }
+    // Every worker would share the one CPU, the extra ones only add context switches to the timings
+    if (options.pinCpu && poolOptions.threadCount == 0) {
+        poolOptions.threadCount = 1;
+    }
+    Regression::enabled = regression.answers || regression.budgets || regression.history;
+    if (regression.answers) {
+        logOptions.solutionSink = &Regression::RecordSolution;
+    }
+    ThreadPool::Configure(poolOptions);
+    logger.configure(logOptions);
+    Trace::enabled = options.tracePath.has_value();
+    if (options.solvers.empty()) {
+        options.solvers = SolverRegistry::All() | views::transform([](const SolverRegistration& solver) {
+                              return &solver;
+                          }) |
+                          ranges::to_vector;
+    }
+    if (options.input == "-" && options.solvers.size() > 1) {
+        throw std::invalid_argument{"--input - needs a single day"};
+    }
+    if (options.input == "-" && options.streamChunkSize && options.repeat > 1) {
+        throw std::invalid_argument{"--stream reads stdin once, it can't --repeat"};
+    }
+    return options;
+}
+
+/// Pins and raises the priority of the main thread before the pool starts, so its workers inherit both
+void ApplyScheduling(const SuiteOptions& options) {
+#ifdef __linux__
+    if (options.pinCpu) {
+        if (*options.pinCpu >= CPU_SETSIZE) {
+            throw std::invalid_argument{std::format("CPU {} is out of range", *options.pinCpu)};
+        }
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(*options.pinCpu, &set);
+        if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+            throw std::system_error{errno, std::generic_category(), std::format("Pinning to CPU {}", *options.pinCpu)};
+        }
+    }
+    if (options.fifoPriority) {
+        const sched_param param{.sched_priority = *options.fifoPriority};
+        // Unprivileged runs are common on shared hosts, keep going with the default policy
+        if (sched_setscheduler(0, SCHED_FIFO, &param) != 0) {
+            logger.perf("Warning: SCHED_FIFO priority {} refused ({}), using the default policy", *options.fifoPriority,
+                        std::strerror(errno));
+        }
+    }
+#elif defined(WIN32)
+    SetPriorityClass(GetCurrentProcess(), options.fifoPriority ? REALTIME_PRIORITY_CLASS : HIGH_PRIORITY_CLASS);
+    if (options.pinCpu) {
+        if (*options.pinCpu >= sizeof(DWORD_PTR) * 8 ||
+            SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR{1} << *options.pinCpu) == 0) {
+            throw std::invalid_argument{std::format("Can't pin to CPU {}", *options.pinCpu)};
+        }
+    }
+#else
+    if (options.pinCpu || options.fifoPriority) {
+        logger.perf("Warning: --pin-cpu and --fifo are not supported on this platform");
+    }
+#endif
+}
+
+inline int AocMainInternal(const SuiteOptions& options) {
+    if (options.help) {
+        std::cout << USAGE;
+        return 0;
+    }
+    ApplyScheduling(options);
+    logger.perf("Instruction set: {} (supported: {})", CpuFeatures::Name(CpuFeatures::Active()),
+                CpuFeatures::Name(CpuFeatures::Supported()));
     {
         StopWatch wholeProgramStopWatch{"Whole Program"};
 #ifdef WIN32
-        SetPriorityClass(GetCurrentProcess(), HIGH_PRIORITY_CLASS);
         SetConsoleCP(CP_UTF8);
         SetConsoleOutputCP(CP_UTF8);
 #endif
-        const auto input = StopWatch<std::micro>::Run("LoadInput", LoadInput);
-        StopWatch<std::milli>::Run("AocMain", AocMain, std::string_view{input});
+        const auto suiteStart = std::chrono::steady_clock::now();
+        RunSuite(options);
+        const std::chrono::duration<double> suiteTime = std::chrono::steady_clock::now() - suiteStart;
+        if (options.solvers.size() > 1) {
+            logger.perf("Suite of {} days took {} ({:.2f} days/s)", options.solvers.size(),
+                        std::chrono::duration<double, std::milli>(suiteTime),
+                        options.solvers.size() / suiteTime.count());
+        }
     }
+    Benchmark::Report();
+    HugePages::Report();
+    if (options.tracePath) {
+        const std::size_t spanCount = Trace::Write(*options.tracePath);
+        logger.perf("Trace of {} sections written to {}", spanCount, options.tracePath->string());
+    }
+    logger.flush();
+    if (!Regression::enabled) {
+        return 0;
+    }
+    // Solution lines only reach the regression check once flushed
+    const std::vector<std::string_view> days =
+        options.solvers | views::transform(&SolverRegistration::name) | ranges::to_vector;
+    const int exitCode = Regression::Check(days);
     logger.flush();
+    return exitCode;
 }
 } // namespace
 
-Logger::Logger() {
-    logLines.reserve(128);
+std::vector<SolverRegistration>& SolverRegistry::Registrations() {
+    static std::vector<SolverRegistration> registrations;
+    return registrations;
 }
 
-void Logger::flush() {
-    std::vector<TypeErasedLogLine> flushedLines;
-    {
-        const std::lock_guard logLinesLock{logLinesMutex};
-        logLines.swap(flushedLines);
+bool SolverRegistry::Add(SolverRegistration registration) {
+    Registrations().push_back(registration);
+    return true;
+}
+
+std::span<const SolverRegistration> SolverRegistry::All() {
+    return Registrations();
+}
+
+const SolverRegistration* SolverRegistry::Find(std::string_view name) {
+    const auto it = ranges::find(Registrations(), name, &SolverRegistration::name);
+    return it == Registrations().end() ? nullptr : &*it;
+}
+
+namespace {
+
+std::vector<std::pair<std::string_view, std::string_view>>& EmbeddedInputs() {
+    static std::vector<std::pair<std::string_view, std::string_view>> inputs;
+    return inputs;
+}
+
+} // namespace
+
+bool SolverRegistry::Embed(std::string_view name, std::string_view input) {
+    EmbeddedInputs().emplace_back(name, input);
+    return true;
+}
+
+std::optional<std::string_view> SolverRegistry::EmbeddedInput(std::string_view name) {
+    const auto it = ranges::find(EmbeddedInputs(), name, &std::pair<std::string_view, std::string_view>::first);
+    return it == EmbeddedInputs().end() ? std::nullopt : std::optional{it->second};
+}
+
+void EscapePointer([[maybe_unused]] const volatile void* pointer) {}
+
+BenchmarkOptions BenchmarkOptions::Parse(std::string_view spec) {
+    BenchmarkOptions options{.enabled = true};
+    for (const std::string_view setting : spec | Split(',')) {
+        const std::size_t equals = setting.find('=');
+        const std::string_view key{setting.substr(0, equals)};
+        const std::string_view value{equals == setting.npos ? ""sv : setting.substr(equals + 1)};
+        if (key == "warmup"sv) {
+            options.warmup = ParseNumber<unsigned>(value);
+        } else if (key == "iterations"sv) {
+            options.iterations = std::max(1u, ParseNumber<unsigned>(value));
+        } else if (key == "budget"sv) {
+            options.budget = std::chrono::duration<double>{ParseNumber<double>(value)};
+        } else if (key != "1"sv) {
+            throw std::invalid_argument{std::format("Unknown benchmark setting: {}", setting)};
+        }
     }
-    for (const auto& logLine : flushedLines) {
-        logLine();
+    return options;
+}
+
+namespace {
+
+std::mutex benchmarkSamplesMutex;
+std::map<std::string, std::vector<double>, std::less<>> benchmarkSamples;
+
+} // namespace
+
+void Benchmark::Record(std::string_view sectionName, std::span<const double> samplesNs) {
+    std::string key{Logger::context.empty() ? std::string{sectionName}
+                                            : std::format("{}: {}", Logger::context, sectionName)};
+    const std::lock_guard samplesLock{benchmarkSamplesMutex};
+    auto& samples = benchmarkSamples[std::move(key)];
+    samples.insert(samples.end(), samplesNs.begin(), samplesNs.end());
+}
+
+void Benchmark::Report() {
+    const std::lock_guard samplesLock{benchmarkSamplesMutex};
+    const auto toMicros = [](double ns) { return ns / 1000.0; };
+    for (auto& [sectionName, samples] : benchmarkSamples) {
+        ranges::sort(samples);
+        const double mean = ranges::accumulate(samples, 0.0) / samples.size();
+        const double variance =
+            ranges::accumulate(samples, 0.0, std::plus{}, [mean](double x) { return (x - mean) * (x - mean); }) /
+            samples.size();
+        const std::size_t middle = samples.size() / 2;
+        const double median =
+            (samples.size() % 2) ? samples[middle] : (samples[middle - 1] + samples[middle]) / 2;
+        const std::size_t p99Rank = DivCeil(samples.size() * 99, std::size_t{100}) - 1;
+        logger.perf("{}: n={} min={:.3f}µs median={:.3f}µs mean={:.3f}µs p99={:.3f}µs stddev={:.3f}µs",
+                    sectionName, samples.size(), toMicros(samples.front()), toMicros(median), toMicros(mean),
+                    toMicros(samples[p99Rank]), toMicros(std::sqrt(variance)));
     }
+    benchmarkSamples.clear();
 }
 
-int main([[maybe_unused]] const int argc, [[maybe_unused]] const char* argv[]) {
-    AocMainInternal();
-    return 0;
+int main(const int argc, const char* argv[]) {
+    if constexpr (std::same_as<StopWatchClock, TscClock>) {
+        if (!TscClock::Invariant()) {
+            logger.perf("Warning: TSC is not invariant, StopWatch timings may not reflect wall time");
+        }
+        // Calibrated here rather than inside the first StopWatch section
+        static_cast<void>(TscClock::Rate());
+    }
+    try {
+        return AocMainInternal(ParseOptions(std::span{argv + 1, static_cast<std::size_t>(argc - 1)}));
+    } catch (const std::exception& e) {
+        logger.flush();
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
 }
\ No newline at end of file
@@ -26,6 +26,7 @@
 #include <string_view>
 #include <system_error>
 #include <thread>
+#include <tuple>
 #include <unordered_set>
 #include <utility>
 
@@ -39,9 +40,23 @@
 #include <boost/unordered/unordered_flat_map.hpp>
 #include <boost/unordered/unordered_flat_set.hpp>
 
+#include "Arena.hpp"
 #include "Attr.hpp"
+#include "BitGrid.hpp"
+#include "BitTricks.hpp"
+#include "BulkParse.hpp"
+#include "CpuFeatures.hpp"
 #include "Fnv.hpp"
+#include "GridSearch.hpp"
+#include "HugePages.hpp"
+#include "Input.hpp"
+#include "LineIndex.hpp"
+#include "Logger.hpp"
 #include "Mdspan.hpp"
+#include "PerfCounters.hpp"
+#include "Regression.hpp"
+#include "ThreadPool.hpp"
+#include "Trace.hpp"
 #include "TscClock.hpp"
 
 #undef IN
@@ -144,84 +159,6 @@ constexpr I ChineseRemainderTheorem(std::span<const I> modulos, std::span<const
     return result % product;
 }
 
-template <std::unsigned_integral U>
-constexpr U BitreversePortable(U x) noexcept {
-    x = std::byteswap(x);
-
-    const auto Extract = [x](int i) -> U {
-        const U mask{static_cast<U>(0x0101010101010101ULL) << i};
-        return x & mask;
-    };
-
-    // Eliminating dependencies allows clang to vectorize this for std::uint32_t and u16
-    U x0{Extract(0) << 7};
-    U x1{Extract(1) << 5};
-    U x2{Extract(2) << 3};
-    U x3{Extract(3) << 1};
-
-    U x4{Extract(4) >> 1};
-    U x5{Extract(5) >> 3};
-    U x6{Extract(6) >> 5};
-    U x7{Extract(7) >> 7};
-
-    x0 |= x4;
-    x1 |= x5;
-    x2 |= x6;
-    x3 |= x7;
-
-    x0 |= x2;
-    x1 |= x3;
-
-    x = x0 | x1;
-
-    return x;
-}
-
-template <std::unsigned_integral U>
-[[attr_flatten]] constexpr U Bitreverse(U x) noexcept {
-    return BitreversePortable<U>(x);
-}
-
-template <>
-[[attr_flatten]] constexpr std::uint32_t Bitreverse<std::uint32_t>(std::uint32_t x) noexcept {
-    if (std::is_constant_evaluated()) {
-        return BitreversePortable<std::uint32_t>(x);
-    } else {
-        x              = std::byteswap(x);
-        __m128i x_32x4 = _mm_set1_epi32(x);
-        const __m128i slMask_32x4 =
-            _mm_set_epi32(0x01010101ULL << 0, 0x01010101ULL << 1, 0x01010101ULL << 2, 0x01010101ULL << 3);
-        const __m128i srMask_32x4 =
-            _mm_set_epi32(0x01010101ULL << 7, 0x01010101ULL << 6, 0x01010101ULL << 4, 0x01010101ULL << 4);
-        const __m128i shift_32x4   = _mm_set_epi32(7, 5, 3, 1);
-        const __m128i xl_32x4      = _mm_sllv_epi32(_mm_and_si128(x_32x4, slMask_32x4), shift_32x4);
-        const __m128i xr_32x4      = _mm_srlv_epi32(_mm_and_si128(x_32x4, srMask_32x4), shift_32x4);
-        x_32x4                     = _mm_or_si128(xl_32x4, xr_32x4);
-        const std::uint64_t x_32x2 = _mm_extract_epi64(x_32x4, 0) | _mm_extract_epi64(x_32x4, 0);
-        return static_cast<std::uint32_t>(x_32x2) | static_cast<std::uint32_t>(x_32x2 >> 32);
-    }
-}
-
-template <>
-[[attr_flatten]] constexpr std::uint64_t Bitreverse<std::uint64_t>(std::uint64_t x) noexcept {
-    if (std::is_constant_evaluated()) {
-        return BitreversePortable<std::uint64_t>(x);
-    } else {
-        x                         = std::byteswap(x);
-        __m256i x_64x4            = _mm256_set1_epi64x(x);
-        const __m256i slMask_64x4 = _mm256_set_epi64x(0x0101010101010101ULL << 0, 0x0101010101010101ULL << 1,
-                                                      0x0101010101010101ULL << 2, 0x0101010101010101ULL << 3);
-        const __m256i srMask_64x4 = _mm256_set_epi64x(0x0101010101010101ULL << 7, 0x0101010101010101ULL << 6,
-                                                      0x0101010101010101ULL << 4, 0x0101010101010101ULL << 4);
-        const __m256i shift_64x4  = _mm256_set_epi64x(7, 5, 3, 1);
-        const __m256i xl_64x4     = _mm256_sllv_epi64(_mm256_and_si256(x_64x4, slMask_64x4), shift_64x4);
-        const __m256i xr_64x4     = _mm256_srlv_epi64(_mm256_and_si256(x_64x4, srMask_64x4), shift_64x4);
-        x_64x4                    = _mm256_or_si256(xl_64x4, xr_64x4);
-        __m128i x_64x2 = _mm_or_si128(_mm256_extracti128_si256(x_64x4, 0), _mm256_extracti128_si256(x_64x4, 1));
-        return _mm_extract_epi64(x_64x2, 0) | _mm_extract_epi64(x_64x2, 1);
-    }
-}
-
 [[gnu::always_inline]] inline std::uint32_t popcount(uint128_t i) {
     return std::popcount(static_cast<std::uint64_t>(i & 0xFFFFFFFFFFFFFFFFULL)) +
            std::popcount(static_cast<std::uint64_t>(i >> 64));
@@ -242,10 +179,11 @@ template <>
     return (hi == 0) ? std::countl_zero(lo) + 64 : std::countl_zero(hi);
 }
 
+template <IsaLevel Isa = IsaLevel::SCALAR>
 [[gnu::always_inline]] inline uint128_t pdep(uint128_t src, uint128_t mask) {
     std::uint64_t low =
-        _pdep_u64(static_cast<std::uint64_t>(src), static_cast<std::uint64_t>(mask & 0xFFFFFFFFFFFFFFFFULL));
-    std::uint64_t high = _pdep_u64(
+        pdep<Isa>(static_cast<std::uint64_t>(src), static_cast<std::uint64_t>(mask & 0xFFFFFFFFFFFFFFFFULL));
+    std::uint64_t high = pdep<Isa>(
         static_cast<std::uint64_t>(src >> std::popcount(static_cast<std::uint64_t>(mask & 0xFFFFFFFFFFFFFFFFULL))),
         static_cast<std::uint64_t>(mask >> 64));
     return uint128_t{high} << 64 | low;
@@ -381,18 +319,19 @@ inline void ThrowError(const std::errc errc) {
     throw std::system_error{std::make_error_code(errc)};
 }
 
-[[attr_forceinline]] inline void ThrowOnError(const std::errc errc) {
+[[attr_forceinline]] constexpr void ThrowOnError(const std::errc errc) {
     if (errc != std::errc{}) [[unlikely]] {
         ThrowError(errc);
     }
 }
 
-[[attr_forceinline]] inline void ThrowOnError(const std::from_chars_result& result) {
+[[attr_forceinline]] constexpr void ThrowOnError(const std::from_chars_result& result) {
     ThrowOnError(result.ec);
 }
 
+/// constexpr for integers, so inputs known while compiling can be parsed then
 template <typename T, int base = 10>
-inline T ParseNumber(std::string_view str) {
+constexpr T ParseNumber(std::string_view str) {
     T val{};
     if (str.front() == '+') str.remove_prefix(1);
     ThrowOnError(std::from_chars(str.data(), str.data() + str.size(), val, base));
@@ -407,102 +346,182 @@ concept TupleLike = requires {
     { std::tuple_size_v<T> } -> std::convertible_to<size_t>;
 };
 
-class Logger {
-    using TypeErasedLogLine = std::move_only_function<void() const>;
+void EscapePointer(const volatile void* pointer);
 
-    template <typename T>
-    static auto CopyRange(T&& obj) {
-        using Value = std::remove_cvref_t<T>;
-        if constexpr (std::convertible_to<T, std::string>) {
-            return std::string(std::forward<T>(obj));
-        } else if constexpr (ranges::range<T>) {
-            using Element = ranges::value_type_t<T>;
-            if constexpr (std::same_as<char, Element>) {
-                return std::string(ranges::begin(obj), ranges::end(obj));
-            } /*else if constexpr (TupleLike<Value>) {
-                return boost::container::static_vector<Element, std::tuple_size_v<Value>>(ranges::begin(obj),
-                                                                                          ranges::end(obj));
-            }*/
-            else {
-                return boost::container::small_vector<Element, 256 / sizeof(Element)>(ranges::begin(obj),
-                                                                                      ranges::end(obj));
-            }
-        } else {
-            return std::forward<T>(obj);
-        }
-    }
+/// Forces value to be materialized so the work producing it can't be optimized away
+template <typename T>
+[[attr_forceinline]] inline void DoNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "m"(value) : "memory");
+#else
+    EscapePointer(&value);
+    _ReadWriteBarrier();
+#endif
+}
 
-    template <typename... Args>
-    struct LogLine {
-        std::string storedStyle;
-        std::string_view storedFmt;
-        std::tuple<decltype(CopyRange(std::declval<Args>()))...> storedArgs;
-
-        explicit LogLine(std::string style, std::format_string<Args...> fmt, Args&&... args)
-            : storedStyle{std::move(style)}, storedFmt{fmt.get()},
-              storedArgs{std::make_tuple(CopyRange(std::forward<Args>(args))...)} {}
-
-        void operator()() const {
-            std::fwrite(storedStyle.data(), sizeof(char), storedStyle.size(), stdout);
-            auto printArgs = [this](const auto&... unpackedArgs) {
-                std::vformat_to(std::ostreambuf_iterator{std::cout}, storedFmt, std::make_format_args(unpackedArgs...));
-            };
-            std::apply(printArgs, storedArgs);
-            constexpr std::string_view resetAndNewline{"\x1b[0m\n"};
-            std::fwrite(resetAndNewline.data(), sizeof(char), resetAndNewline.size(), stdout);
-        }
-    };
-    std::mutex logLinesMutex;
-    std::vector<TypeErasedLogLine> logLines;
+struct BenchmarkOptions {
+    bool enabled{false};
+    unsigned warmup{3};
+    unsigned iterations{100};
+    std::chrono::duration<double> budget{1.0};
 
-    template <typename... Args>
-    void addLogline(std::string style, std::format_string<Args...> fmt, Args&&... args) {
-        const std::lock_guard logLinesLock{logLinesMutex};
-        logLines.emplace_back(std::in_place_type<LogLine<Args...>>, std::move(style), fmt, std::forward<Args>(args)...);
-    }
+    /// Parses "warmup=3,iterations=100,budget=1.5", any key may be omitted
+    static BenchmarkOptions Parse(std::string_view spec);
+};
 
-public:
-    explicit Logger();
+/// <summary>
+/// Repeats StopWatch::Run sections and reports min/median/mean/p99/stddev per section name.
+/// The logged call runs first and supplies the returned value. Copyable arguments are copied before it and every
+/// sample runs on a fresh copy, untimed, so a section that mutates or memoises into its arguments is measured from the
+/// same start each time. Arguments that can't be copied are shared with the logged call, as is state the function
+/// reaches some other way, which needs a SampleReset. Nested sections run once per outer iteration.
+/// </summary>
+class Benchmark {
+    static thread_local bool sampling;
+    static thread_local std::vector<void (*)()> sampleResets;
+
+    struct SamplingScope {
+        SamplingScope() noexcept { sampling = Logger::muted = true; }
+        ~SamplingScope() { sampling = Logger::muted = false; }
+    };
 
-    void flush();
+    static void Record(std::string_view sectionName, std::span<const double> samplesNs);
 
-    template <typename... Args>
-    void info(std::format_string<Args...> fmt, Args&&... args) {
-        addLogline("", fmt, std::forward<Args>(args)...);
-    }
+public:
+    static BenchmarkOptions options;
+
+    /// <summary>
+    /// Calls reset before every sample of the sections run on this thread while it lives, untimed. For memo tables a
+    /// day keeps outside the section's arguments, in globals or captured state, which the logged call fills and the
+    /// samples would otherwise only look up.
+    /// </summary>
+    class SampleReset {
+    public:
+        explicit SampleReset(void (*reset)()) : reset{reset} { sampleResets.push_back(reset); }
+        ~SampleReset() { std::erase(sampleResets, reset); }
+        SampleReset(const SampleReset&)            = delete;
+        SampleReset& operator=(const SampleReset&) = delete;
+
+    private:
+        void (*reset)();
+    };
 
-    template <typename... Args>
-    void perf(std::format_string<Args...> fmt, Args&&... args) {
-        addLogline("\x1b[36m", fmt, std::forward<Args>(args)...);
+    static bool ShouldRepeat() noexcept { return options.enabled && !sampling; }
+
+    template <class Watch, typename Function, typename... Args>
+    static auto Run(std::string sectionName, Function& function, Args&... args) {
+        using Result = std::invoke_result_t<Function&, Args&...>;
+        constexpr bool COPYABLE = (std::is_copy_constructible_v<std::remove_cv_t<Args>> && ...);
+        using Arguments = std::conditional_t<COPYABLE, std::tuple<std::remove_cv_t<Args>...>, std::tuple<Args&...>>;
+        // Taken before the logged call changes them
+        const Arguments pristine{args...};
+        const auto sample = [&] {
+            const SamplingScope samplingScope;
+            std::vector<double> samplesNs;
+            samplesNs.reserve(options.iterations);
+            // Every sample starts from an empty pool, so allocation cost is measured rather than amortised away
+            Arena samplingArena;
+            const auto timedCall = [&] {
+                for (void (*reset)() : sampleResets) {
+                    reset();
+                }
+                Arguments fresh{pristine};
+                double elapsedNs;
+                {
+                    const Arena::Scope arenaScope{samplingArena};
+                    const auto start = Watch::Clock::now();
+                    if constexpr (std::is_void_v<Result>) {
+                        std::apply(function, fresh);
+                    } else {
+                        DoNotOptimize(std::apply(function, fresh));
+                    }
+                    elapsedNs = std::chrono::duration<double, std::nano>(Watch::Clock::now() - start).count();
+                }
+                samplingArena.reset();
+                return elapsedNs;
+            };
+            for (unsigned i{0}; i < options.warmup; ++i) {
+                timedCall();
+            }
+            const auto deadline = Watch::Clock::now() + options.budget;
+            do {
+                samplesNs.push_back(timedCall());
+            } while (samplesNs.size() < options.iterations && Watch::Clock::now() < deadline);
+            Record(sectionName, samplesNs);
+        };
+
+        if constexpr (std::is_void_v<Result>) {
+            {
+                Watch runStopWatch{sectionName};
+                std::invoke(function, args...);
+            }
+            sample();
+        } else {
+            Result result = [&]() -> Result {
+                Watch runStopWatch{sectionName};
+                return std::invoke(function, args...);
+            }();
+            sample();
+            return result;
+        }
     }
 
-    template <typename... Args>
-    void solution(std::format_string<Args...> fmt, Args&&... args) {
-        addLogline("\x1b[92m", fmt, std::forward<Args>(args)...);
-    }
+    static void Report();
 };
 
-extern Logger logger;
-
-template <typename Ratio = std::milli>
-struct StopWatch {
-#ifdef WIN32
-    using Clock = std::chrono::steady_clock;
+#ifdef AOC_TSC_STOPWATCH
+// A fenced rdtsc costs a few nanoseconds, far less than a steady_clock call
+using StopWatchClock = TscClock;
 #else
-    using Clock = std::chrono::steady_clock;
+using StopWatchClock = std::chrono::steady_clock;
 #endif
+
+template <typename Ratio = std::milli, typename ClockType = StopWatchClock>
+struct StopWatch {
+    using Clock = ClockType;
     const std::string sectionName;
+    Arena& arena;
+    const Arena::Snapshot startMemory;
+    const std::optional<PerfCounters::Snapshot> startCounters;
+    const uint32_t traceDepth;
     const Clock::time_point start;
 
-    explicit StopWatch(std::string sectionName) : sectionName{std::move(sectionName)}, start{Clock::now()} {}
+    explicit StopWatch(std::string sectionName)
+        : sectionName{std::move(sectionName)}, arena{Arena::Current()}, startMemory{arena.beginSection()},
+          startCounters{PerfCounters::Read()}, traceDepth{Trace::enabled ? Trace::Enter() : 0}, start{Clock::now()} {}
 
     ~StopWatch() {
         const Clock::time_point stop = Clock::now();
-        logger.perf("{} took {}", sectionName, std::chrono::duration<double, Ratio>(stop - start));
+        if (Trace::enabled) {
+            const auto micros = [](Clock::time_point time) {
+                return std::chrono::duration<double, std::micro>(time.time_since_epoch()).count();
+            };
+            Trace::Exit(sectionName, Logger::context, micros(start), micros(stop), traceDepth);
+        }
+        if (Regression::enabled) {
+            Regression::RecordSection(Logger::context, sectionName,
+                                      std::chrono::duration<double, std::milli>(stop - start).count());
+        }
+        std::string details = Arena::Describe(startMemory, arena.endSection(startMemory));
+        if (startCounters) {
+            if (const std::optional<PerfCounters::Snapshot> stopCounters = PerfCounters::Read()) {
+                details += PerfCounters::Describe(*startCounters, *stopCounters);
+            }
+        }
+        if (details.empty()) {
+            logger.perf("{} took {}", sectionName, std::chrono::duration<double, Ratio>(stop - start));
+        } else {
+            logger.perf("{} took {} |{}", sectionName, std::chrono::duration<double, Ratio>(stop - start), details);
+        }
     }
 
     template <typename... Args, std::invocable<Args...> Function>
     static auto Run(std::string sectionName, Function&& function, Args&&... args) {
+        if constexpr (std::invocable<Function&, Args&...>) {
+            if (Benchmark::ShouldRepeat()) {
+                return Benchmark::Run<StopWatch>(std::move(sectionName), function, args...);
+            }
+        }
         StopWatch runStopWatch{std::move(sectionName)};
         return std::invoke(std::forward<Function>(function), std::forward<Args>(args)...);
     }
@@ -578,4 +597,39 @@ inline constexpr auto bsearch_includes = bsearch_includes_fn{};
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
-void AocMain(std::string_view input);
+using AocSolver = void (*)(std::string_view input);
+/// Entry point reading the input a chunk at a time, for days whose memory shouldn't grow with the input
+using AocStreamSolver = void (*)(InputStream& input);
+
+struct SolverRegistration {
+    std::string_view name;
+    AocSolver solver;
+    /// Used instead of solver by --stream, must log the same solution lines
+    AocStreamSolver streamSolver{nullptr};
+};
+
+/// <summary>
+/// Every day registers its entry point here instead of defining a global AocMain,
+/// so any number of days can be linked into the same binary.
+/// </summary>
+class SolverRegistry {
+    static std::vector<SolverRegistration>& Registrations();
+
+public:
+    static bool Add(SolverRegistration registration);
+    static std::span<const SolverRegistration> All();
+    static const SolverRegistration* Find(std::string_view name);
+
+    /// Input compiled into the binary with AOC_EMBED_INPUT, see EmbedInput.cmake
+    static bool Embed(std::string_view name, std::string_view input);
+    static std::optional<std::string_view> EmbeddedInput(std::string_view name);
+};
+
+#define AOC_REGISTER_SOLVER(name, solver)                                                                              \
+    [[maybe_unused]] static const bool aocSolverRegistered_##name = SolverRegistry::Add({#name, solver})
+
+#define AOC_REGISTER_STREAM_SOLVER(name, solver, streamSolver)                                                         \
+    [[maybe_unused]] static const bool aocSolverRegistered_##name = SolverRegistry::Add({#name, solver, streamSolver})
+
+#define AOC_REGISTER_EMBEDDED_INPUT(name, input)                                                                       \
+    [[maybe_unused]] static const bool aocInputEmbedded_##name = SolverRegistry::Embed(#name, input)
@@ -3,7 +3,7 @@
 namespace {
 
 template <size_t depth>
-boost::unordered::unordered_flat_map<uint64_t, uint64_t> cache;
+boost::unordered::unordered_flat_map<uint64_t, uint64_t, CrcHash> cache;
 
 template <size_t depth>
 size_t CountExpanded(uint64_t pebble) {
@@ -30,6 +30,13 @@ size_t CountExpanded(uint64_t pebble) {
     }
 }
 
+/// Benchmark samples start from empty caches, or they would only time the lookups of the logged run
+void ClearCaches() {
+    []<size_t... depth>(std::index_sequence<depth...>) {
+        (cache<depth + 1>.clear(), ...);
+    }(std::make_index_sequence<75>{});
+}
+
 template <size_t depth>
 size_t DoPart(std::string_view input) {
     return ranges::fold_left(input | ParseNumbers<size_t> | views::transform(CountExpanded<depth>), size_t{},
@@ -37,8 +44,8 @@ size_t DoPart(std::string_view input) {
 }
 
 size_t CountExpanded2(const uint64_t initialPebble) {
-    boost::unordered_flat_map<uint64_t, size_t> pebbles{{initialPebble, 1}};
-    boost::unordered_flat_map<uint64_t, size_t> newPebbles;
+    boost::unordered_flat_map<uint64_t, size_t, CrcHash> pebbles{{initialPebble, 1}};
+    boost::unordered_flat_map<uint64_t, size_t, CrcHash> newPebbles;
     for (int i = 0; i < 75; ++i) {
         for (auto [pebble, count] : pebbles) {
             if (pebble == 0) {
@@ -65,10 +72,13 @@ size_t DoPart2(std::string_view input) {
                              std::plus{});
 }
 
-} // namespace
-
 void AocMain(std::string_view input) {
+    const Benchmark::SampleReset clearCaches{ClearCaches};
     logger.solution("25 Blinks: {}", StopWatch<std::micro>::Run("25", DoPart<25>, input));
     logger.solution("75 Blinks: {}", StopWatch<std::milli>::Run("75", DoPart<75>, input));
     logger.solution("75 Blinks no recursion: {}", StopWatch<std::milli>::Run("75 no recursion", DoPart2, input));
-}
\ No newline at end of file
+}
+
+} // namespace
+
+AOC_REGISTER_SOLVER(plutonian_pebbles, AocMain);
\ No newline at end of file
@@ -1,3 +1,5 @@
+namespace {
+
 void AocMain(std::string_view input) {
     auto split         = input.find("\n\n"sv);
     auto rulesString   = input.substr(0, split + 1);
@@ -8,7 +10,8 @@ void AocMain(std::string_view input) {
         return std::make_pair(ParseNumber<uint32_t>(line.substr(0, bar)), ParseNumber<uint32_t>(line.substr(bar + 1)));
     };
     std::array<std::array<bool, 100>, 100> lessThan_{};
-    for (auto [low, high] : rulesString | Split('\n') | views::transform(parseRule)) {
+    const LineIndex rules{rulesString};
+    for (auto [low, high] : rules | views::transform(parseRule)) {
         lessThan_[high][low] = true;
     }
     auto orderedBefore = [&lessThan_](uint32_t lhs, uint32_t rhs) {
@@ -24,9 +27,13 @@ void AocMain(std::string_view input) {
             return static_cast<uint64_t>(pages[pages.size() / 2]) << 32;
         }
     };
-    auto parts =
-        ranges::fold_left(updatesString | Split('\n') | views::transform(getMiddlePage), uint64_t{}, std::plus{});
+    const LineIndex updates{updatesString};
+    auto parts = ranges::fold_left(updates | views::transform(getMiddlePage), uint64_t{}, std::plus{});
 
     logger.solution("Part 1: {}", parts & ~uint32_t{});
     logger.solution("Part 2: {}", parts >> 32);
-}
\ No newline at end of file
+}
+
+} // namespace
+
+AOC_REGISTER_SOLVER(print_queue, AocMain);
\ No newline at end of file
@@ -1,7 +1,8 @@
 namespace {
 
 struct Course {
-    mdarray<int32_t, dextents<int32_t, 2>> courseStorage;
+    // Every cheat reads a whole diamond of rows around its start, large courses want huge pages
+    HugePageMdarray<int32_t, dextents<int32_t, 2>> courseStorage;
     Pos2D startPos{};
     Pos2D endPos{};
 
@@ -27,22 +28,30 @@ struct Course {
 
     void pathFind() {
         const mdspan<int32_t, dextents<int32_t, 2>> course{courseStorage};
-        int32_t distance{0};
-        Pos2D pos{startPos};
-        while (pos != endPos) {
-            course(pos) = distance;
-            Pos2D nextPos{pos};
-            for (Vec2D offset : {Vec2D{-1, 0}, Vec2D{0, -1}, Vec2D{0, 1}, Vec2D{1, 0}}) {
-                Pos2D offsetPos         = pos + offset;
-                const int32_t maybeNext = course(offsetPos);
-                if (maybeNext > distance) {
-                    nextPos = offsetPos;
+        // The track is walled in all round, so neighbours need no bounds check
+        const std::array<int32_t, 4> neighborOffsets{-course.extent(1), -1, 1, course.extent(1)};
+        const int32_t start = course.mapping()(startPos.y(), startPos.x());
+        const int32_t end   = course.mapping()(endPos.y(), endPos.x());
+
+        GridSearch<int32_t, 0, HugePageAllocator<int32_t>> search{static_cast<int32_t>(course.size())};
+        search.bfs(
+            std::span{&start, 1},
+            [&course, &neighborOffsets](int32_t index, auto&& edge) {
+                for (const int32_t offset : neighborOffsets) {
+                    if (course.data_handle()[index + offset] >= 0) {
+                        edge(index + offset);
+                    }
+                }
+            },
+            [end](int32_t index) { return index == end; });
+
+        for (int32_t y{0}; y < course.extent(0); ++y) {
+            for (int32_t x{0}; x < course.extent(1); ++x) {
+                if (course(y, x) >= 0) {
+                    course(y, x) = search.distance(course.mapping()(y, x));
                 }
             }
-            pos = nextPos;
-            ++distance;
         }
-        course(pos) = distance;
     }
 
     size_t cheatCount(int32_t minSkip, const int32_t radius) const {
@@ -72,11 +81,13 @@ struct Course {
     }
 };
 
-} // namespace
-
 void AocMain(std::string_view input) {
     Course course = StopWatch<std::micro>::Run("Parse", Constructor<Course>{}, input);
     StopWatch<std::micro>::Run("Pathfind", &Course::pathFind, course);
     logger.solution("Part 1: {}", StopWatch<std::micro>::Run("Part 1", &Course::cheatCount, course, 100, 2));
     logger.solution("Part 2: {}", StopWatch<std::micro>::Run("Part 2", &Course::cheatCount, course, 100, 20));
-}
\ No newline at end of file
+}
+
+} // namespace
+
+AOC_REGISTER_SOLVER(race_condition, AocMain);
\ No newline at end of file
@@ -26,8 +26,6 @@ namespace {
 2,0
 )";
 
-std::pmr::unsynchronized_pool_resource pool;
-
 std::vector<Pos2D> Parse(const std::string_view input) {
     return input | Split('\n') | views::transform([](std::string_view line) {
                const size_t comma = line.find(',');
@@ -36,56 +34,56 @@ std::vector<Pos2D> Parse(const std::string_view input) {
            ranges::to_vector;
 }
 
+template <class Layout>
 int32_t BFS(const std::span<const Pos2D> bytes, const int32_t gridDim) {
-    mdarray<int32_t, dextents<int32_t, 2>, layout_right, std::pmr::vector<int32_t>> memorySpace{
-        dextents<int32_t, 2>{gridDim, gridDim}, std::pmr::polymorphic_allocator{&pool}};
-    for (int32_t y{0}; y < memorySpace.extent(0); ++y) {
-        for (int32_t x{0}; x < memorySpace.extent(1); ++x) {
-            memorySpace(y, x) = std::numeric_limits<int32_t>::max();
+    Arena& arena = Arena::Current();
+    // Corrupted bytes and the halo are both walls, so neighbours need no bounds check
+    PaddedGrid<uint8_t, std::pmr::vector<uint8_t>, Layout> corrupted{dextents<int32_t, 2>{gridDim, gridDim}, 1, true,
+                                                                     &arena};
+    for (int32_t y{0}; y < corrupted.extent(0); ++y) {
+        for (int32_t x{0}; x < corrupted.extent(1); ++x) {
+            corrupted(y, x) = false;
         }
     }
     for (Pos2D byte : bytes) {
-        memorySpace(byte.y(), byte.x()) = -1;
+        corrupted(byte.y(), byte.x()) = true;
     }
-    const int32_t& result{memorySpace(gridDim - 1, gridDim - 1)};
+    const int32_t start = corrupted.index(0, 0);
+    const int32_t goal  = corrupted.index(gridDim - 1, gridDim - 1);
 
-    std::pmr::vector<Pos2D> edges{std::pmr::polymorphic_allocator{&pool}};
-    edges.push_back({0, 0});
-    std::pmr::vector<Pos2D> nextEdges{std::pmr::polymorphic_allocator{&pool}};
-    int32_t distance{1};
-    while (!edges.empty() && (result == std::numeric_limits<int32_t>::max())) {
-        for (Pos2D edge : edges) {
-            for (Vec2D offset : {Vec2D{0, 1}, Vec2D{1, 0}, Vec2D{-1, 0}, Vec2D{0, -1}}) {
-                Pos2D nextEdge{edge + offset};
-                if (InBounds(memorySpace.extents(), nextEdge) &&
-                    memorySpace(nextEdge.y(), nextEdge.x()) == std::numeric_limits<int32_t>::max()) {
-                    memorySpace(nextEdge.y(), nextEdge.x()) = distance;
-                    nextEdges.emplace_back(nextEdge);
+    const auto cellCount = static_cast<int32_t>(corrupted.cells().size());
+    GridSearch<int32_t, 0, std::pmr::polymorphic_allocator<int32_t>> search{cellCount, &arena};
+    search.bfs(
+        std::span{&start, 1},
+        [&corrupted](int32_t index, auto&& edge) {
+            for (const GridStep step : GRID_STEPS) {
+                const int32_t next = corrupted.step(index, step);
+                if (!corrupted[next]) {
+                    edge(next);
                 }
             }
-        }
-        ++distance;
-        edges.swap(nextEdges);
-        nextEdges.clear();
-    }
-
-    return result;
+        },
+        [goal](int32_t index) { return index == goal; });
+    // UNREACHED is the int32_t maximum Part2 searches for
+    return search.distance(goal);
 }
 
+template <class Layout>
 int32_t Part1(const std::span<const Pos2D> bytes, const int32_t gridDim, const size_t minFallenCount) {
-    return BFS(std::span{bytes}.first(minFallenCount), gridDim);
+    return BFS<Layout>(std::span{bytes}.first(minFallenCount), gridDim);
 }
 
+template <class Layout>
 std::pair<int32_t, int32_t> Part2(const std::span<const Pos2D> bytes, const int32_t gridDim,
                                   const size_t minFallenCount) {
     const size_t cutoff = *ranges::lower_bound(
         views::closed_iota(minFallenCount, bytes.size()), std::numeric_limits<int32_t>::max(), std::less{},
-        [&bytes, gridDim](const size_t fallenCount) { return BFS(std::span{bytes}.first(fallenCount), gridDim); });
+        [&bytes, gridDim](const size_t fallenCount) {
+            return BFS<Layout>(std::span{bytes}.first(fallenCount), gridDim);
+        });
     return {bytes[cutoff - 1].x(), bytes[cutoff - 1].y()};
 }
 
-} // namespace
-
 void AocMain(std::string_view input) {
 #if false
     constexpr int32_t gridDim       = 7;
@@ -98,6 +96,14 @@ void AocMain(std::string_view input) {
 
     std::vector<Pos2D> bytes = StopWatch<std::micro>::Run("Parse", Parse, input);
 
-    logger.solution("Part 1: {}", StopWatch<std::micro>::Run("Part 1", Part1, bytes, gridDim, minFallenCount));
-    logger.solution("Part 2: {}", StopWatch<std::micro>::Run("Part 2", Part2, bytes, gridDim, minFallenCount));
-}
\ No newline at end of file
+    WithGridLayout([&]<class Layout> {
+        logger.solution("Part 1: {}",
+                        StopWatch<std::micro>::Run("Part 1", Part1<Layout>, bytes, gridDim, minFallenCount));
+        logger.solution("Part 2: {}",
+                        StopWatch<std::micro>::Run("Part 2", Part2<Layout>, bytes, gridDim, minFallenCount));
+    });
+}
+
+} // namespace
+
+AOC_REGISTER_SOLVER(ram_run, AocMain);
\ No newline at end of file
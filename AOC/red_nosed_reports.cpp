@@ -2,7 +2,7 @@ namespace {
 
 auto Parse(std::string_view input) {
     return input | Split('\n') |
-           views::transform([](std::string_view line) { return line | ParseNumbers<int32_t> | ranges::to_vector; }) |
+           views::transform([](std::string_view line) { return line | BulkParseNumbers<int32_t>; }) |
            ranges::to_vector;
 }
 
@@ -37,10 +37,12 @@ size_t CountSafeWithMargin(auto&& reports) {
     });
 }
 
-} // namespace
-
 void AocMain(std::string_view input) {
     auto reports = StopWatch<std::micro>::Run("Parse", Parse, input);
     logger.solution("{}", StopWatch<std::micro>::Run("Part 1", [&reports] { return CountSafe(reports); }));
     logger.solution("{}", StopWatch<std::micro>::Run("Part 2", [&reports] { return CountSafeWithMargin(reports); }));
 }
+
+} // namespace
+
+AOC_REGISTER_SOLVER(red_nosed_reports, AocMain);
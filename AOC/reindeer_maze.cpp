@@ -5,84 +5,104 @@ constexpr uint8_t DOWN  = 1;
 constexpr uint8_t LEFT  = 2;
 constexpr uint8_t UP    = 3;
 
-const std::array<Vec2D, 4> DIRECTION_VECTOR = [] {
-    std::array<Vec2D, 4> init{};
-    init[UP]    = {-1, 0};
-    init[LEFT]  = {0, -1};
-    init[DOWN]  = {1, 0};
-    init[RIGHT] = {0, 1};
-    return init;
-}();
+constexpr int32_t STEP_SCORE = 1;
+constexpr int32_t TURN_SCORE = 1000;
 
 struct Maze {
     using Score = int32_t;
+    /// A state is a cell index times 4 plus the direction faced. It is reached by a step forward, or by a quarter turn
+    /// and a step, from the cell behind it, so it has at most 3 predecessors.
+    using Search = GridSearch<Score, 3, HugePageAllocator<Score>>;
 
-    struct MazeCell {
-        std::array<Score, 4> forward{};
-        Score back{std::numeric_limits<Score>::max()};
-    };
-
-    mdarray<MazeCell, dextents<int32_t, 2>> grid;
-    Pos2D startPos;
-    Pos2D endPos;
+    HugePageMdarray<uint8_t, dextents<int32_t, 2>> isOpen;
+    // 4 states a cell with a predecessor DAG, a large maze misses the dTLB on 4 KiB pages
+    Search search{0};
+    std::array<int32_t, 4> directionOffset{};
+    int32_t startCell{};
+    int32_t endCell{};
 
     Maze(std::string_view inputString) {
         const mdspan inputMaze = ToGrid(inputString);
         const size_t startIndex{inputString.find('S')};
         const size_t endIndex{inputString.find('E')};
 
-        startPos = {static_cast<int32_t>(startIndex / inputMaze.stride(0)), static_cast<int32_t>(startIndex % inputMaze.stride(0))};
-        endPos   = {static_cast<int32_t>(endIndex / inputMaze.stride(0)), static_cast<int32_t>(endIndex % inputMaze.stride(0))};
-        grid     = {inputMaze.extents()};
-
+        isOpen = {inputMaze.extents()};
         for (int32_t y{0}; y < inputMaze.extent(0); ++y) {
             for (int32_t x{0}; x < inputMaze.extent(1); ++x) {
-                MazeCell& cell{grid(y, x)};
-                cell.forward.fill((inputMaze(y, x) == '#') ? -1 : std::numeric_limits<Score>::max());
+                isOpen(y, x) = inputMaze(y, x) != '#';
             }
         }
-    }
+        // The outer wall keeps every step inside the grid
+        const int32_t width    = isOpen.extent(1);
+        directionOffset[RIGHT] = 1;
+        directionOffset[DOWN]  = width;
+        directionOffset[LEFT]  = -1;
+        directionOffset[UP]    = -width;
 
-    Score explore(const Pos2D pos, const Score currentScore, const uint8_t direction) {
-        MazeCell& cell{grid.to_mdspan()(pos)};
-        if (cell.forward[direction] < currentScore) {
-            return std::numeric_limits<Score>::max();
-        }
-        cell.forward[direction] = currentScore;
-        if (pos == endPos) {
-            cell.back = std::min(currentScore, cell.back);
-            return currentScore;
-        }
-        Score ret = explore(pos + DIRECTION_VECTOR[direction], currentScore + 1, direction);
-        ret       = std::min(
-            ret, explore(pos + DIRECTION_VECTOR[(direction + 1) & 0b11], currentScore + 1001, (direction + 1) & 0b11));
-        ret = std::min(
-            ret, explore(pos + DIRECTION_VECTOR[(direction - 1) & 0b11], currentScore + 1001, (direction - 1) & 0b11));
-        cell.back = std::min(ret, cell.back);
-        return ret;
+        const auto cellOf = [&](size_t index) {
+            return isOpen.mapping()(static_cast<int32_t>(index / inputMaze.stride(0)),
+                                    static_cast<int32_t>(index % inputMaze.stride(0)));
+        };
+        startCell = cellOf(startIndex);
+        endCell   = cellOf(endIndex);
+        search    = Search{static_cast<int32_t>(isOpen.size()) * 4};
     }
 
-    void explore() { explore(startPos, 0, RIGHT); }
+    void explore() {
+        const int32_t start = startCell * 4 + RIGHT;
+        search.dial(
+            std::span{&start, 1}, STEP_SCORE + TURN_SCORE,
+            [this](int32_t state, auto&& edge) {
+                const int32_t cell = state >> 2;
+                const auto move    = [&](int32_t direction, Score score) {
+                    const int32_t next = cell + directionOffset[direction];
+                    if (isOpen.data()[next]) {
+                        edge(next * 4 + direction, score);
+                    }
+                };
+                const int32_t direction = state & 0b11;
+                move(direction, STEP_SCORE);
+                move((direction + 1) & 0b11, STEP_SCORE + TURN_SCORE);
+                move((direction - 1) & 0b11, STEP_SCORE + TURN_SCORE);
+            },
+            // The first end state settled has the lowest score, any other at that score is settled too
+            [this](int32_t state) { return state >> 2 == endCell; });
+    }
 
-    Score getEndScore() const noexcept { return grid.to_mdspan()(endPos).back; }
+    Score getEndScore() const noexcept {
+        Score score{Search::UNREACHED};
+        for (int32_t direction{0}; direction < 4; ++direction) {
+            score = std::min(score, search.distance(endCell * 4 + direction));
+        }
+        return score;
+    }
 
-    size_t countBestPathCells() const noexcept {
+    size_t countBestPathCells() {
         const Score lowestScore{getEndScore()};
-        size_t count{0};
-        for (int32_t y{0}; y < grid.extent(0); ++y) {
-            for (int32_t x{0}; x < grid.extent(1); ++x) {
-                count += grid(y, x).back == lowestScore;
+        std::array<int32_t, 4> bestEnds{};
+        size_t bestEndCount{0};
+        for (int32_t direction{0}; direction < 4; ++direction) {
+            if (search.distance(endCell * 4 + direction) == lowestScore) {
+                bestEnds[bestEndCount++] = endCell * 4 + direction;
             }
         }
+        std::vector<bool> onBestPath(isOpen.size());
+        size_t count{0};
+        search.forEachOnShortestPath(std::span{bestEnds}.first(bestEndCount), [&](int32_t state) {
+            count += !onBestPath[state >> 2];
+            onBestPath[state >> 2] = true;
+        });
         return count;
     }
 };
 
-} // namespace
-
 void AocMain(std::string_view input) {
     Maze maze(input);
     maze.explore();
     logger.solution("{}", maze.getEndScore());
     logger.solution("{}", maze.countBestPathCells());
-}
\ No newline at end of file
+}
+
+} // namespace
+
+AOC_REGISTER_SOLVER(reindeer_maze, AocMain);
\ No newline at end of file
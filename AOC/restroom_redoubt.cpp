@@ -15,8 +15,8 @@ p=9,5 v=-3,-3
 )";
 
 struct Robot {
-    Index2D position;
-    Index2D velocity;
+    Pos2D position;
+    Vec2D velocity;
 
     Robot(std::string_view line) {
         size_t numberStart = 2;
@@ -33,48 +33,71 @@ struct Robot {
     }
 };
 
-} // namespace
+/// <summary>
+/// Robots kept as two parallel arrays so a whole step is one Translate and one WrapInto over packed positions.
+/// </summary>
+struct Robots {
+    std::vector<Pos2D> positions;
+    std::vector<Vec2D> velocities;
+    Vec2D dims;
+
+    /// Moves every robot steps seconds ahead, the offsets are reduced below dims first so one wrap suffices
+    void advance(int64_t steps) {
+        std::vector<Vec2D> offsets(velocities.size());
+        for (size_t r{0}; r < velocities.size(); ++r) {
+            for (size_t d{0}; d < 2; ++d) {
+                const int64_t stepsMod = steps % dims[d];
+                offsets[r][d]          = static_cast<int32_t>((velocities[r][d] * stepsMod) % dims[d]);
+            }
+        }
+        Translate(positions, offsets);
+        WrapInto(positions, dims);
+    }
+};
 
 void AocMain(std::string_view input) {
-    Index2D dims{101, 103};
+    Vec2D dims{101, 103};
 #if false
     input = test;
-    dims  = Index2D{11, 7};
+    dims  = Vec2D{11, 7};
 #endif
 
-    const int64_t lftMax = dims.x() / 2;
-    const int64_t rgtMin = lftMax + dims.x() % 2;
-    const int64_t botMax = dims.y() / 2;
-    const int64_t topMin = botMax + dims.y() % 2;
+    // Components are in input order, [0] is x and [1] is y. Pos2D::x() reads the last component, so it isn't used here
+    const int64_t lftMax = dims[0] / 2;
+    const int64_t rgtMin = lftMax + dims[0] % 2;
+    const int64_t botMax = dims[1] / 2;
+    const int64_t topMin = botMax + dims[1] % 2;
 
-    auto robots = input | Split('\n') | views::transform(Constructor<Robot>{}) | ranges::to_vector;
-    std::array<size_t, 4> quadrantCounts{};
-    for (const Robot& robot : robots) {
-        Index2D endPosition = (robot.position + robot.velocity * 100);
-        endPosition.x() %= dims.x();
-        if (endPosition.x() < 0) endPosition.x() += dims.x();
-        endPosition.y() %= dims.y();
-        if (endPosition.y() < 0) endPosition.y() += dims.y();
+    Robots robots{.dims = dims};
+    for (const Robot& robot : input | Split('\n') | views::transform(Constructor<Robot>{})) {
+        robots.positions.push_back(robot.position);
+        robots.velocities.push_back(robot.velocity);
+    }
 
-        quadrantCounts[0] += (endPosition.x() >= rgtMin) && (endPosition.y() >= topMin);
-        quadrantCounts[1] += (endPosition.x() >= rgtMin) && (endPosition.y() < botMax);
-        quadrantCounts[2] += (endPosition.x() < lftMax) && (endPosition.y() >= topMin);
-        quadrantCounts[3] += (endPosition.x() < lftMax) && (endPosition.y() < botMax);
+    Robots afterHundred{robots};
+    afterHundred.advance(100);
+    std::array<size_t, 4> quadrantCounts{};
+    for (const Pos2D& endPosition : afterHundred.positions) {
+        quadrantCounts[0] += (endPosition[0] >= rgtMin) && (endPosition[1] >= topMin);
+        quadrantCounts[1] += (endPosition[0] >= rgtMin) && (endPosition[1] < botMax);
+        quadrantCounts[2] += (endPosition[0] < lftMax) && (endPosition[1] >= topMin);
+        quadrantCounts[3] += (endPosition[0] < lftMax) && (endPosition[1] < botMax);
     }
     logger.info("Quadrants: {}", quadrantCounts);
     logger.solution("Part 1: {}", ranges::accumulate(quadrantCounts, size_t{1}, std::multiplies{}));
 
     const auto printRobots = [&]() {
-        std::string treeLine(static_cast<size_t>(dims.x()), ' ');
+        // dims[1] lines of dims[0] cells and a newline, column-major so the grid is indexed (x, y)
+        std::string treeLine(static_cast<size_t>(dims[0]), ' ');
         treeLine.push_back('\n');
         std::string treeStorage;
-        for (int64_t y{0}; y < dims.y(); ++y) {
+        for (int64_t y{0}; y < dims[1]; ++y) {
             treeStorage += treeLine;
         }
         mdspan treeGrid(treeStorage.data(), layout_left_padded<dynamic_extent>::mapping<dextents<int32_t, 2>>(
-                                                dextents<int32_t, 2>(dims.x(), dims.y()), dims.x() + 1));
-        for (const Robot& robot : robots) {
-            char& cell{treeGrid(robot.position)};
+                                                dextents<int32_t, 2>(dims[0], dims[1]), dims[0] + 1));
+        for (const Pos2D& position : robots.positions) {
+            char& cell{treeGrid(position[0], position[1])};
             if (cell == ' ') {
                 cell = '1';
             } else {
@@ -85,24 +108,21 @@ void AocMain(std::string_view input) {
         logger.flush();
     };
     printRobots();
-    const auto advance = [&](int64_t steps) {
-        for (Robot& robot : robots) {
-            robot.position = (robot.position + robot.velocity * steps);
-            robot.position.x() %= dims.x();
-            if (robot.position.x() < 0) robot.position.x() += dims.x();
-            robot.position.y() %= dims.y();
-            if (robot.position.y() < 0) robot.position.y() += dims.y();
-        }
-    };
-
     std::array<int64_t, 2> mods{128 - 27, 178 - 75};
     std::array<int64_t, 2> remainders{27, 75};
     int64_t minStep = ChineseRemainderTheorem<int64_t>(mods, remainders) - 2;
-    advance(minStep);
+    robots.advance(minStep);
     for (int64_t i{minStep};; ++i) {
         logger.info("i = {}", i);
         printRobots();
-        std::cin.ignore();
-        advance(1);
+        // Steps on every Enter until stdin ends, so unattended runs finish
+        if (std::cin.ignore().eof()) {
+            break;
+        }
+        robots.advance(1);
     }
-}
\ No newline at end of file
+}
+
+} // namespace
+
+AOC_REGISTER_SOLVER(restroom_redoubt, AocMain);
\ No newline at end of file
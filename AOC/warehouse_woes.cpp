@@ -11,17 +11,22 @@ size_t GPSSum(const InputGrid<const char> warehouse) {
     return sum;
 }
 
-Index2D MoveRobotSimple(const InputGrid<char> warehouse, const Index2D direction, const Index2D robot) {
-    Index2D probe(robot + direction);
-    while (warehouse(probe) != '.') {
-        if (warehouse(probe) == '#') {
+template <class T>
+[[attr_forceinline]] T& At(const InputGrid<T> warehouse, const Pos2D& pos) {
+    return warehouse(pos.y(), pos.x());
+}
+
+Pos2D MoveRobotSimple(const InputGrid<char> warehouse, const Vec2D& direction, const Pos2D& robot) {
+    Pos2D probe{robot + direction};
+    while (At(warehouse, probe) != '.') {
+        if (At(warehouse, probe) == '#') {
             return robot;
         }
         probe += direction;
     }
-    while (!(probe == robot).all()) {
-        Index2D nextProbe{probe - direction};
-        std::swap(warehouse(probe), warehouse(nextProbe));
+    while (probe != robot) {
+        const Pos2D nextProbe{probe - direction};
+        std::swap(At(warehouse, probe), At(warehouse, nextProbe));
         probe = nextProbe;
     }
     return robot + direction;
@@ -29,8 +34,8 @@ Index2D MoveRobotSimple(const InputGrid<char> warehouse, const Index2D direction
 
 template <bool execute>
 bool MoveRobotWideImpl(const InputGrid<std::conditional_t<execute, char, const char>> warehouse,
-                           const Index2D direction, const Index2D position) {
-    const char cell{warehouse(position)};
+                       const Vec2D& direction, const Pos2D& position) {
+    const char cell{At(warehouse, position)};
     if (cell == '#') {
         if constexpr (execute) {
             std::unreachable();
@@ -39,13 +44,13 @@ bool MoveRobotWideImpl(const InputGrid<std::conditional_t<execute, char, const c
         }
     }
     if (cell == '.') return true;
-    Index2D left;
-    Index2D right;
+    Pos2D left;
+    Pos2D right;
     if (cell == '[') {
         left  = position;
-        right = position + Index2D{0, 1};
+        right = position + Vec2D{0, 1};
     } else if (cell == ']') {
-        left  = position + Index2D{0, -1};
+        left  = position + Vec2D{0, -1};
         right = position;
     } else {
         std::unreachable();
@@ -54,19 +59,19 @@ bool MoveRobotWideImpl(const InputGrid<std::conditional_t<execute, char, const c
                          MoveRobotWideImpl<execute>(warehouse, direction, right + direction);
     if constexpr (execute) {
         if (!canMove) std::unreachable();
-        std::swap(warehouse(left), warehouse(Index2D{left + direction}));
-        std::swap(warehouse(right), warehouse(Index2D{right + direction}));
+        std::swap(At(warehouse, left), At(warehouse, left + direction));
+        std::swap(At(warehouse, right), At(warehouse, right + direction));
     }
     return canMove;
 }
 
-Index2D MoveRobotWide(const InputGrid<char> warehouse, const Index2D direction, const Index2D robot) {
-    const Index2D nextRobotPos{robot + direction};
+Pos2D MoveRobotWide(const InputGrid<char> warehouse, const Vec2D& direction, const Pos2D& robot) {
+    const Pos2D nextRobotPos{robot + direction};
     if (!MoveRobotWideImpl<false>(warehouse, direction, nextRobotPos)) {
         return robot;
     }
     MoveRobotWideImpl<true>(warehouse, direction, nextRobotPos);
-    std::swap(warehouse(robot), warehouse(nextRobotPos));
+    std::swap(At(warehouse, robot), At(warehouse, nextRobotPos));
     return nextRobotPos;
 }
 
@@ -96,7 +101,8 @@ size_t Simulate(const std::string_view input) {
     const mdspan warehouse{ToGrid(state)};
 
     const size_t initialRobotIndex = state.find('@');
-    Index2D robot{initialRobotIndex / warehouse.stride(0), initialRobotIndex % warehouse.stride(0)};
+    Pos2D robot{static_cast<int32_t>(initialRobotIndex / warehouse.stride(0)),
+                static_cast<int32_t>(initialRobotIndex % warehouse.stride(0))};
 
     for (const char move : moves) {
         switch (move) {
@@ -119,9 +125,11 @@ size_t Simulate(const std::string_view input) {
     return GPSSum<(wide ? '[' : 'O')>(warehouse);
 }
 
-} // namespace
-
 void AocMain(std::string_view input) {
     logger.solution("Narrow: {}", StopWatch<std::micro>::Run("Simulate Narrow", Simulate<false>, input));
     logger.solution("Wide:   {}", StopWatch<std::micro>::Run("Simulate Wide  ", Simulate<true>, input));
-}
\ No newline at end of file
+}
+
+} // namespace
+
+AOC_REGISTER_SOLVER(warehouse_woes, AocMain);
\ No newline at end of file